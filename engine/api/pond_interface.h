@@ -8,6 +8,10 @@
 #include <algorithm>
 #include <unordered_map>
 #include <GLFW/glfw3.h>
+#include "mesh_handle.h"
+#include "scheduler.h"
+#include "task_queue.h"
+#include "script.h"
 
 namespace froggi {
 
@@ -19,6 +23,23 @@ class Renderer;
 class CollisionSystem;
 class Collider;
 class Rigidbody;
+struct InputContext;
+
+///////////////////////////////////////////////////////////////////////////////
+// Update LOD - Opt-in reduced update rate for distant / off-screen components
+//
+// Rates are measured in frames between onUpdate calls; the time of skipped
+// frames is added to the deltaTime of the next call. Components are spread
+// over the frames of an interval so a crowd doesn't update all at once.
+
+struct UpdateLod {
+    bool enabled = false;
+    float nearDistance = 20.0f;         // full rate up to this distance from the main camera
+    float farDistance = 80.0f;          // farInterval from here on (linear in between)
+    uint32_t farInterval = 4;           // frames per update at farDistance
+    uint32_t offscreenInterval = 0;     // frames per update off screen (0 = wait until visible)
+    float boundsRadius = 1.0f;          // around the owner's position, for the visibility test
+};
 
 ///////////////////////////////////////////////////////////////////////////////
 // Component Base Class
@@ -32,8 +53,53 @@ public:
     virtual void onFixedUpdate(float fixedDeltaTime) { (void)fixedDeltaTime; }
     virtual void onDestroy() {}
     
+    /**
+     * Leave the scene's update and fixed update until wake() is called
+     * (by a timer, an event handler or another component)
+     */
+    void sleep();
+    void sleepFor(float seconds);
+    void wake();
+    bool isSleeping() const { return sleeping; }
+    
+    /**
+     * Timers on the engine scheduler, cancelled when the scene unloads
+     */
+    TimerId scheduleAfter(float delay, Scheduler::Callback callback);
+    TimerId scheduleEvery(float interval, Scheduler::Callback callback);
+    void cancelTimer(TimerId id);
+    
+#ifdef FROGGI_COROUTINES
+    /**
+     * Run a coroutine script until its first co_await; it lives as long as
+     * the component (see script.h)
+     */
+    void startScript(Script script);
+    void stopScripts();
+    
+    // Awaitables for scripts
+    ScriptWait wait(float seconds) const { return { seconds, scene }; }
+    ScriptNextFrame nextFrame() const { return {}; }
+    ScriptNextFixedStep nextFixedStep() const { return {}; }
+    ScriptLoad loadAsync(const std::string& name, const std::string& path) const { return { name, path }; }
+#endif
+    
     GameObject* owner = nullptr;
+    Scene* scene = nullptr;
     bool enabled = true;
+    UpdateLod updateLod;
+    
+private:
+    friend class Scene;
+    friend class Engine;
+    float lodElapsed = 0.0f;            // time since the last onUpdate under LOD
+    uint32_t lodPhase = 0;
+    bool sleeping = false;
+    bool inUpdateList = false;
+    TimerId wakeTimer = Scheduler::kInvalidTimer;
+#ifdef FROGGI_COROUTINES
+    std::vector<Script> scripts;
+#endif
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -96,12 +162,30 @@ public:
 
 class MeshComponent : public Component {
 public:
-    std::string meshName;
     glm::vec4 color = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
     
+    /**
+     * Draw the mesh registered under name; the draw list resolves it to a
+     * MeshHandle the next time it sees this component and reuses that
+     */
     void setMesh(const std::string& name) {
+        if (name == meshName) return;
         meshName = name;
+        meshHandle = MeshHandle();
     }
+    
+    const std::string& getMeshName() const { return meshName; }
+    
+    /**
+     * Handle cached by the draw list; invalid until resolved, and stale
+     * (re-resolved from the name) once the mesh is unloaded
+     */
+    MeshHandle getMeshHandle() const { return meshHandle; }
+    void setMeshHandle(MeshHandle handle) { meshHandle = handle; }
+    
+private:
+    std::string meshName;
+    MeshHandle meshHandle;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -200,81 +284,127 @@ public:
         static_assert(std::is_base_of<Component, T>::value, "T must derive from Component");
         T* component = new T();
         component->owner = obj;
+        component->scene = this;
+        component->lodPhase = static_cast<uint32_t>(components.size());
         obj->components.push_back(component);
         components.push_back(component);
+        updateList.push_back(component);
+        component->inUpdateList = true;
         component->onInit();
         return component;
     }
     
+    /**
+     * Awake components in update order; components put to sleep since the
+     * last call are dropped here, so idle ones cost nothing per frame
+     */
+    const std::vector<Component*>& getUpdateList() {
+        if (updateListDirty) {
+            updateList.erase(std::remove_if(updateList.begin(), updateList.end(), [](Component* c) {
+                if (!c->sleeping) return false;
+                c->inUpdateList = false;
+                return true;
+            }), updateList.end());
+            updateListDirty = false;
+        }
+        return updateList;
+    }
+    
     std::vector<GameObject*> gameObjects;
     std::vector<Component*> components;
     std::string name = "Untitled Scene";
     CollisionSystem* collisionSystem = nullptr;
+    
+private:
+    friend class Component;
+    std::vector<Component*> updateList;
+    bool updateListDirty = false;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
 // Input System
+//
+// GLFW key/mouse callbacks (chained in front of ImGui's) and gamepad polling
+// push timestamped events into a fixed ring buffer. Input::update() drains it
+// once per frame into the frame state; each fixed step applies the events
+// that happened before the end of that step to a separate fixed state.
+// Queries made from onFixedUpdate read the fixed state automatically, so
+// isKeyPressed fires exactly once per step that saw the press, and presses
+// shorter than a frame are still reported.
+//
+// State lives in an InputContext. The window's context is the default; a
+// headless engine binds its own context on the thread it runs on, and AI
+// agents or replays drive it through the inject* calls.
 
 class Input {
 public:
-    static void init(GLFWwindow* window) {
-        s_window = window;
-    }
-    
-    static void update() {
-        s_prevKeyState = s_currentKeyState;
-    }
-    
-    static void shutdown() {
-        s_window = nullptr;
-    }
+    static constexpr int kMaxKeys = GLFW_KEY_LAST + 1;
+    static constexpr int kMaxMouseButtons = GLFW_MOUSE_BUTTON_LAST + 1;
+    static constexpr int kMaxGamepads = 4;
+    static constexpr int kGamepadButtons = GLFW_GAMEPAD_BUTTON_LAST + 1;
+    static constexpr int kGamepadAxes = GLFW_GAMEPAD_AXIS_LAST + 1;
+    
+    // Engine hooks
+    static void init(GLFWwindow* window);
+    /**
+     * Drain queued events into the frame state
+     * @param time Current time on the same clock as the event timestamps
+     *             (glfwGetTime() for the window, simulation time if headless)
+     */
+    static void update(double time);
+    static void shutdown();
+    
+    /**
+     * Separate input state for a headless engine
+     */
+    static InputContext* createContext();
+    static void destroyContext(InputContext* context);
+    
+    /**
+     * Route Input calls made on this thread to a context (nullptr = window)
+     */
+    static void setThreadContext(InputContext* context);
+    static InputContext* getThreadContext();
+    
+    /**
+     * Start a fixed step: apply queued events up to the end of the step
+     * @param timeRemaining Simulation time still left to step this frame
+     *                      after this step (accumulator - fixedTimeStep)
+     */
+    static void beginFixedStep(float timeRemaining);
+    static void endFixedStep();
+    
+    /**
+     * glfwGetTime() of the oldest key/button event consumed by the last
+     * update(), or 0 if that frame had no input events
+     */
+    static double getFrameEventTime();
+    
+    // Synthetic input for the current context, seen from the next update()
+    static void injectKey(int keycode, bool down);
+    static void injectMouseButton(int button, bool down);
+    static void injectMousePosition(const glm::vec2& position);
+    static void injectGamepadButton(int button, bool down, int gamepad = 0);
+    static void injectGamepadAxis(int axis, float value, int gamepad = 0);
     
     // Keyboard
-    static bool isKeyDown(int keycode) {
-        if (!s_window) return false;
-        bool state = glfwGetKey(s_window, keycode) == GLFW_PRESS;
-        s_currentKeyState[keycode] = state;
-        return state;
-    }
-    
-    static bool isKeyPressed(int keycode) {
-        bool current = isKeyDown(keycode);
-        bool previous = s_prevKeyState[keycode];
-        return current && !previous;
-    }
-    
-    static bool isKeyReleased(int keycode) {
-        bool current = isKeyDown(keycode);
-        bool previous = s_prevKeyState[keycode];
-        return !current && previous;
-    }
+    static bool isKeyDown(int keycode);
+    static bool isKeyPressed(int keycode);
+    static bool isKeyReleased(int keycode);
     
     // Mouse
-    static glm::vec2 getMousePosition() {
-        if (!s_window) return glm::vec2(0.0f);
-        double x, y;
-        glfwGetCursorPos(s_window, &x, &y);
-        return glm::vec2(static_cast<float>(x), static_cast<float>(y));
-    }
-    
-    static bool isMouseButtonDown(int button) {
-        if (!s_window) return false;
-        return glfwGetMouseButton(s_window, button) == GLFW_PRESS;
-    }
-    
-    // Gamepad
-    static bool isGamepadConnected(int gamepad = 0) {
-        return glfwJoystickIsGamepad(gamepad);
-    }
-    
-    static float getGamepadAxis(int axis, int gamepad = 0) {
-        int count;
-        const float* axes = glfwGetJoystickAxes(gamepad, &count);
-        if (axes && axis < count) {
-            return axes[axis];
-        }
-        return 0.0f;
-    }
+    static glm::vec2 getMousePosition();
+    static glm::vec2 getMouseScroll();
+    static bool isMouseButtonDown(int button);
+    static bool isMouseButtonPressed(int button);
+    static bool isMouseButtonReleased(int button);
+    
+    // Gamepad (standard GLFW gamepad mapping)
+    static bool isGamepadConnected(int gamepad = 0);
+    static float getGamepadAxis(int axis, int gamepad = 0);
+    static bool isGamepadButtonDown(int button, int gamepad = 0);
+    static bool isGamepadButtonPressed(int button, int gamepad = 0);
+    static bool isGamepadButtonReleased(int button, int gamepad = 0);
     
     // Helper for WASD movement
     static glm::vec2 getMovementInput() {
@@ -285,17 +415,8 @@ public:
         if (isKeyDown(GLFW_KEY_D)) input.x += 1.0f;
         return input;
     }
-    
-private:
-    static GLFWwindow* s_window;
-    static std::unordered_map<int, bool> s_currentKeyState;
-    static std::unordered_map<int, bool> s_prevKeyState;
 };
 
-inline GLFWwindow* Input::s_window = nullptr;
-inline std::unordered_map<int, bool> Input::s_currentKeyState;
-inline std::unordered_map<int, bool> Input::s_prevKeyState;
-
 ///////////////////////////////////////////////////////////////////////////////
 // Game Base Class
 
@@ -330,23 +451,71 @@ protected:
 
 ///////////////////////////////////////////////////////////////////////////////
 // Engine - Main loop manager
+//
+// Engines are independent: besides the windowed one FROGGI_MAIN runs, a
+// process can create any number of headless engines (no window, renderer or
+// debug tools) and step each on its own thread for batch simulation. Jolt's
+// type registry and collision meshes are shared read-only between them.
+
+struct EngineConfig {
+    int width = 1280;
+    int height = 720;
+    
+    // No window, renderer or GLFW input; time advances by frameTime per step()
+    bool headless = false;
+    float frameTime = 1.0f / 60.0f;
+    
+    // Physics worker threads (-2 = follow p.jobThreads, -1 = hardware threads
+    // - 1, 0 = run physics jobs on the engine's own thread, the usual choice
+    // for one engine per core)
+    int physicsThreads = -2;
+};
 
 class Engine {
 public:
-    static Engine& getInstance() {
-        static Engine instance;
-        return instance;
-    }
+    Engine() = default;
+    ~Engine() = default;
+    
+    Engine(const Engine&) = delete;
+    Engine& operator=(const Engine&) = delete;
+    
+    /**
+     * The engine running on this thread (inside init/run/step/shutdown), or
+     * the process-wide default engine started by FROGGI_MAIN
+     */
+    static Engine& getInstance();
     
     bool init(Game* gameInstance, int width = 1280, int height = 720);
+    bool init(Game* gameInstance, const EngineConfig& config);
     void run();
+    
+    /**
+     * Advance a headless engine by whole frames of config.frameTime
+     * @return false once quit() was requested
+     */
+    bool step(uint32_t frames = 1);
     void shutdown();
     
     float getDeltaTime() const { return deltaTime; }
     float getTime() const { return totalTime; }
     float getAlpha() const { return accumulator / fixedTimeStep; }
+    uint64_t getFrameIndex() const { return frameIndex; }
+    
+    const EngineConfig& getConfig() const { return config; }
+    bool isHeadless() const { return config.headless; }
+    
+    // Stop the main loop after the current frame
+    void quit(int code = 0) { quitRequested = true; exitCode = code; }
+    bool isQuitRequested() const { return quitRequested; }
+    int getExitCode() const { return exitCode; }
     
     Renderer* getRenderer() { return renderer; }
+    InputContext* getInputContext() { return inputContext; }
+    Scheduler& getScheduler() { return scheduler; }
+    TaskQueue& getTaskQueue() { return tasks; }
+#ifdef FROGGI_COROUTINES
+    ScriptScheduler& getScripts() { return scripts; }
+#endif
     
     void setZoom(float zoom);
     void setZoomCenter(float x, float y);
@@ -354,31 +523,43 @@ public:
     float getAspectRatio() const;
     
 private:
-    Engine() = default;
-    ~Engine() = default;
-    
+    void tick();
     void updateScene(Scene* scene, float deltaTime);
     void updateSceneFixed(Scene* scene, float fixedDeltaTime);
     
+    EngineConfig config;
     Game* game = nullptr;
     Renderer* renderer = nullptr;
+    InputContext* inputContext = nullptr;
+    Scheduler scheduler;
+    TaskQueue tasks;
+#ifdef FROGGI_COROUTINES
+    ScriptScheduler scripts{ scheduler };
+#endif
     
     float deltaTime = 0.0f;
     float totalTime = 0.0f;
     float accumulator = 0.0f;
     const float fixedTimeStep = 1.0f / 60.0f;
+    uint64_t frameIndex = 0;
+    
+    bool quitRequested = false;
+    int exitCode = 0;
 };
 
 } // namespace froggi
 
 #include "collision_system.h"
+#include "cvar.h"
+#include "log.h"
 
 // Convenience macros
 #define FROGGI_GAME_CLASS(ClassName) \
     class ClassName : public froggi::Game
 
 #define FROGGI_MAIN(GameClass) \
-    int main() { \
+    int main(int argc, char** argv) { \
+        froggi::CVarRegistry::init(argc, argv); \
         froggi::Engine& engine = froggi::Engine::getInstance(); \
         GameClass game; \
         if (!engine.init(&game)) { \
@@ -386,5 +567,5 @@ private:
         } \
         engine.run(); \
         engine.shutdown(); \
-        return 0; \
+        return engine.getExitCode(); \
     }
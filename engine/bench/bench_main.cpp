@@ -0,0 +1,573 @@
+///////////////////////////////////////////////////////////////////////////////
+// froggi_bench - Headless engine benchmarks
+//
+// Builds synthetic scenes at each requested scale, steps them in a headless
+// engine and times the phases of a frame. Results go to JSON; with a
+// baseline report the medians are compared and the exit code is 2 if any
+// phase got slower than bench.tolerance allows, so CI can run it per commit:
+//
+//     froggi_bench --bench.scales=1000,10000 --bench.baseline=bench/baseline.json
+//
+// Options are CVars (bench.*) and can also come from froggi.cfg. The
+// engine's own CVars apply as usual, e.g. --p.jobThreads=0.
+
+#include "bench_report.h"
+#include "bench_scene.h"
+#include "pond_interface.h"
+#include "draw_list.h"
+#include "frame_profiler.h"
+#include "mesh_optimizer.h"
+#include "net_transport.h"
+#include "occlusion_culler.h"
+#include "replication.h"
+#include "resource_manager.h"
+#include "vertex_format.h"
+#include "worker_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <unordered_map>
+
+using namespace froggi;
+using namespace froggi::bench;
+
+static AutoCVarString cv_benchScales("bench.scales",
+    "Comma-separated object counts to run", "1000,10000,100000", CVarFlag_NoSave);
+static AutoCVarInt cv_benchFrames("bench.frames",
+    "Measured frames per scale", 300, 1, 100000, CVarFlag_NoSave);
+static AutoCVarInt cv_benchWarmup("bench.warmup",
+    "Frames stepped before measuring (bodies settle, caches fill)", 60, 0, 100000, CVarFlag_NoSave);
+static AutoCVarInt cv_benchSeed("bench.seed",
+    "Seed for the synthetic scenes", 1234, 0, 1 << 30, CVarFlag_NoSave);
+static AutoCVarString cv_benchOut("bench.out",
+    "Where to write the JSON results", "bench_results.json", CVarFlag_NoSave);
+static AutoCVarString cv_benchBaseline("bench.baseline",
+    "JSON results to compare against (empty = no comparison)", "", CVarFlag_NoSave);
+static AutoCVarFloat cv_benchTolerance("bench.tolerance",
+    "Allowed median slowdown before a phase counts as a regression", 0.10f, 0.0f, 10.0f, CVarFlag_NoSave);
+static AutoCVarFloat cv_benchMinDeltaMs("bench.minDeltaMs",
+    "Slowdowns below this many ms are treated as noise", 0.05f, 0.0f, 1000.0f, CVarFlag_NoSave);
+static AutoCVarInt cv_benchCityBuildings("bench.cityBuildings",
+    "Buildings in the occlusion culling city scene (0 = skip)", 20000, 0, 1000000, CVarFlag_NoSave);
+static AutoCVarInt cv_benchAssetTriangles("bench.assetTriangles",
+    "Triangles in the generated OBJ for the asset load phase (0 = skip)", 100000, 0, 10000000, CVarFlag_NoSave);
+static AutoCVarInt cv_benchAssetRepeats("bench.assetRepeats",
+    "How many times the generated OBJ is loaded", 5, 1, 1000, CVarFlag_NoSave);
+static AutoCVarInt cv_benchNetClients("bench.netClients",
+    "Clients in the loopback replication scenario (0 = skip)", 16, 0, 4096, CVarFlag_NoSave);
+static AutoCVarInt cv_benchNetObjects("bench.netObjects",
+    "Replicated objects in the loopback replication scenario", 1000, 1, 100000, CVarFlag_NoSave);
+static AutoCVarFloat cv_benchNetLoss("bench.netLoss",
+    "Packet loss of the loopback network (0..1)", 0.05f, 0.0f, 0.9f, CVarFlag_NoSave);
+static AutoCVarFloat cv_benchNetLatencyMs("bench.netLatencyMs",
+    "One-way latency of the loopback network (jitter is a fifth of it)", 50.0f, 0.0f, 1000.0f,
+    CVarFlag_NoSave);
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t kJoltMaxBodies = 65536;     // upper bound of p.maxBodies
+
+float elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+}
+
+float zoneMs(const FrameRecord& record, ProfileZone zone) {
+    return record.zoneMs[static_cast<size_t>(zone)];
+}
+
+std::vector<uint32_t> parseScales(const std::string& text) {
+    std::vector<uint32_t> scales;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        try {
+            long value = std::stol(item);
+            if (value > 0) scales.push_back(static_cast<uint32_t>(value));
+        } catch (const std::exception&) {
+            std::fprintf(stderr, "froggi_bench: ignoring scale '%s'\n", item.c_str());
+        }
+    }
+    return scales;
+}
+
+std::string buildDescription() {
+    std::string build;
+#if defined(__clang__)
+    build = "clang " __clang_version__;
+#elif defined(__GNUC__)
+    build = "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    build = "msvc " + std::to_string(_MSC_VER);
+#else
+    build = "unknown compiler";
+#endif
+#ifdef NDEBUG
+    build += ", release";
+#else
+    build += ", debug";
+#endif
+    return build;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Scene scenario
+
+bool runScene(uint32_t objectCount, BenchReport& report) {
+    SceneCounts counts = planScene(objectCount, SceneMix(), kJoltMaxBodies);
+
+    // Room for every body of the scene (these are read when the scene loads)
+    uint32_t bodies = counts.staticBodies + counts.dynamicBodies + counts.kinematicBodies + 1;
+    std::string capacity = std::to_string(std::min(kJoltMaxBodies, std::max<uint32_t>(1024, bodies)));
+    CVarRegistry::set("p.maxBodies", capacity);
+    CVarRegistry::set("p.maxBodyPairs", capacity);
+    CVarRegistry::set("p.maxContactConstraints", capacity);
+
+    std::printf("froggi_bench: %u objects...\n", objectCount);
+    std::fflush(stdout);
+
+    Engine engine;
+    BenchGame game(counts, report.seed);
+    EngineConfig config;
+    config.headless = true;
+
+    Clock::time_point loadStart = Clock::now();
+    if (!engine.init(&game, config)) {
+        std::fprintf(stderr, "froggi_bench: engine init failed\n");
+        return false;
+    }
+    std::vector<float> sceneLoad = { elapsedMs(loadStart) };
+
+    engine.step(report.warmupFrames);
+
+    Scene* scene = game.getCurrentScene();
+    std::vector<float> frame, update, fixed, physics, interpolate, tasks, transform, extract, cull, sort;
+    std::vector<glm::mat4> worldTransforms;
+    worldTransforms.reserve(scene->gameObjects.size());
+
+    // Headless engines have no renderer; register the scene's meshes by hand
+    MeshRegistry meshes;
+    meshes.add("cube", glm::vec3(-0.5f), glm::vec3(0.5f), std::sqrt(0.75f));
+    DrawList drawList;
+    WorkerPool workers(WorkerPool::hardwareThreads() - 1);     // the renderer's default
+    glm::mat4 viewProjection(1.0f);
+    if (CameraComponent* camera = game.getMainCamera()) {
+        viewProjection = camera->getProjectionMatrix(16.0f / 9.0f) * camera->getViewMatrix();
+    }
+    Frustum frustum = Frustum::fromViewProjection(viewProjection);
+
+    for (uint32_t i = 0; i < report.frames; ++i) {
+        Clock::time_point frameStart = Clock::now();
+        FrameProfiler::beginFrame();
+        engine.step(1);
+        FrameProfiler::endFrame();
+
+        const FrameRecord& record = FrameProfiler::getLastFrame();
+        update.push_back(zoneMs(record, ProfileZone::GameUpdate));
+        fixed.push_back(zoneMs(record, ProfileZone::FixedUpdate));
+        physics.push_back(zoneMs(record, ProfileZone::Physics));
+        interpolate.push_back(zoneMs(record, ProfileZone::Interpolate));
+        tasks.push_back(zoneMs(record, ProfileZone::Tasks));
+
+        // ═══════════════════════════════════════════════════════════════
+        // TRANSFORMS (world matrices through the hierarchy)
+        // ═══════════════════════════════════════════════════════════════
+        Clock::time_point phaseStart = Clock::now();
+        worldTransforms.clear();
+        for (const GameObject* obj : scene->gameObjects) {
+            worldTransforms.push_back(obj->getWorldTransform());
+        }
+        transform.push_back(elapsedMs(phaseStart));
+
+        // ═══════════════════════════════════════════════════════════════
+        // DRAW LIST EXTRACTION (what Renderer::renderScene does per frame)
+        // ═══════════════════════════════════════════════════════════════
+        phaseStart = Clock::now();
+        drawList.extract(scene, meshes, viewProjection);
+        extract.push_back(elapsedMs(phaseStart));
+
+        phaseStart = Clock::now();
+        drawList.cull(frustum, &workers);
+        cull.push_back(elapsedMs(phaseStart));
+
+        phaseStart = Clock::now();
+        drawList.sort();
+        sort.push_back(elapsedMs(phaseStart));
+
+        frame.push_back(elapsedMs(frameStart));
+    }
+
+    ScenarioResult result;
+    result.name = "scene_" + std::to_string(objectCount);
+    result.counts = counts;
+    if (scene->collisionSystem) result.bodies = scene->collisionSystem->getBodyCount();
+    result.phases.push_back(summarize("frame", frame));
+    result.phases.push_back(summarize("update", update));
+    result.phases.push_back(summarize("fixedStep", fixed));
+    result.phases.push_back(summarize("physics", physics));
+    result.phases.push_back(summarize("interpolate", interpolate));
+    result.phases.push_back(summarize("tasks", tasks));
+    result.phases.push_back(summarize("transform", transform));
+    result.phases.push_back(summarize("extract", extract));
+    result.phases.push_back(summarize("cull", cull));
+    result.phases.push_back(summarize("sort", sort));
+    result.phases.push_back(summarize("sceneLoad", sceneLoad));
+    report.scenarios.push_back(result);
+
+    engine.shutdown();
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// City scenario (draw list culling only, no engine)
+
+bool runCity(uint32_t buildings, BenchReport& report) {
+    std::printf("froggi_bench: city of %u buildings...\n", buildings);
+    std::fflush(stdout);
+
+    CityScene scene(buildings, report.seed);
+    scene.onLoad();
+
+    MeshRegistry meshes;
+    MeshHandle cube = meshes.add("cube", glm::vec3(-0.5f), glm::vec3(0.5f), std::sqrt(0.75f));
+    meshes.setOccluder(cube.index, cubeTriangles());
+
+    glm::mat4 viewProjection = scene.getCamera()->getProjectionMatrix(16.0f / 9.0f) *
+                               scene.getCamera()->getViewMatrix();
+    Frustum frustum = Frustum::fromViewProjection(viewProjection);
+
+    DrawList drawList;
+    OcclusionCuller occlusion;
+    WorkerPool workers(WorkerPool::hardwareThreads() - 1);     // the renderer's default
+    std::vector<float> extract, cull, rasterize, occlusionTest, sort;
+    for (uint32_t i = 0; i < report.warmupFrames + report.frames; ++i) {
+        bool measured = i >= report.warmupFrames;
+
+        Clock::time_point phaseStart = Clock::now();
+        drawList.extract(&scene, meshes, viewProjection);
+        if (measured) extract.push_back(elapsedMs(phaseStart));
+
+        phaseStart = Clock::now();
+        drawList.cull(frustum, &workers);
+        if (measured) cull.push_back(elapsedMs(phaseStart));
+
+        phaseStart = Clock::now();
+        occlusion.render(drawList.getItems(), meshes, viewProjection, &workers);
+        if (measured) rasterize.push_back(elapsedMs(phaseStart));
+
+        phaseStart = Clock::now();
+        drawList.cullOccluded(occlusion);
+        if (measured) occlusionTest.push_back(elapsedMs(phaseStart));
+
+        phaseStart = Clock::now();
+        drawList.sort();
+        if (measured) sort.push_back(elapsedMs(phaseStart));
+    }
+
+    const CullStats& cullStats = drawList.getCullStats();
+    const OcclusionStats& occlusionStats = occlusion.getStats();
+    std::printf("froggi_bench: %u visible, %u outside the frustum, %u occluded (%u occluders, %u triangles)\n",
+                cullStats.visible, cullStats.culled, cullStats.occluded, occlusionStats.occluders,
+                occlusionStats.triangles);
+
+    ScenarioResult result;
+    result.name = "city_" + std::to_string(buildings);
+    result.counts.objects = buildings;
+    result.counts.plainMeshes = buildings;
+    result.phases.push_back(summarize("extract", extract));
+    result.phases.push_back(summarize("cull", cull));
+    result.phases.push_back(summarize("occlusionRaster", rasterize));
+    result.phases.push_back(summarize("occlusionTest", occlusionTest));
+    result.phases.push_back(summarize("sort", sort));
+    report.scenarios.push_back(result);
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Asset load scenario
+
+// Flat grid of quads with positions, normals and uvs
+bool writeGridObj(const std::filesystem::path& path, uint32_t triangles) {
+    std::ofstream file(path);
+    if (!file) return false;
+
+    uint32_t quads = std::max<uint32_t>(1, triangles / 2);
+    uint32_t side = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(quads))));
+    for (uint32_t y = 0; y <= side; ++y) {
+        for (uint32_t x = 0; x <= side; ++x) {
+            float u = static_cast<float>(x) / side;
+            float v = static_cast<float>(y) / side;
+            file << "v " << u << " 0 " << v << "\n";
+            file << "vt " << u << " " << v << "\n";
+        }
+    }
+    file << "vn 0 1 0\n";
+
+    uint32_t written = 0;
+    for (uint32_t y = 0; y < side && written < quads; ++y) {
+        for (uint32_t x = 0; x < side && written < quads; ++x, ++written) {
+            uint32_t a = y * (side + 1) + x + 1;     // OBJ indices are 1-based
+            uint32_t b = a + 1;
+            uint32_t c = a + side + 1;
+            uint32_t d = c + 1;
+            file << "f " << a << "/" << a << "/1 " << c << "/" << c << "/1 " << b << "/" << b << "/1\n";
+            file << "f " << b << "/" << b << "/1 " << c << "/" << c << "/1 " << d << "/" << d << "/1\n";
+        }
+    }
+    return static_cast<bool>(file);
+}
+
+bool runAssetLoad(uint32_t triangles, uint32_t repeats, BenchReport& report) {
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "froggi_bench_grid.obj";
+    if (!writeGridObj(path, triangles)) {
+        std::fprintf(stderr, "froggi_bench: cannot write '%s'\n", path.string().c_str());
+        return false;
+    }
+
+    std::printf("froggi_bench: loading a %u-triangle OBJ %u times...\n", triangles, repeats);
+    std::fflush(stdout);
+
+    std::vector<float> parse;
+    std::vector<resource_manager::VertexAttributes> vertices;
+    std::vector<uint32_t> indices;
+    bool ok = true;
+    for (uint32_t i = 0; i < repeats && ok; ++i) {
+        Clock::time_point start = Clock::now();
+        ok = resource_manager::loadGeometryFromObj(path, vertices, indices);
+        parse.push_back(elapsedMs(start));
+    }
+
+    std::error_code error;
+    std::filesystem::remove(path, error);
+    if (!ok) {
+        std::fprintf(stderr, "froggi_bench: generated OBJ failed to load\n");
+        return false;
+    }
+
+    std::printf("froggi_bench: %zu corners -> %zu vertices, ACMR %.2f\n", indices.size(), vertices.size(),
+                analyzeVertexCache(indices, vertices.size()));
+
+    // GPU vertex size in each base layout, then the default one timed
+    std::vector<uint8_t> packed;
+    for (VertexLayout layout : { VertexLayout::Float, VertexLayout::Compact, VertexLayout::Precise }) {
+        VertexLayout chosen = chooseVertexLayout(vertices, layout);
+        std::printf("froggi_bench: %s vertices: %u bytes each, %.2f MB\n", vertexLayoutName(chosen),
+                    vertexStride(chosen), vertices.size() * vertexStride(chosen) / (1024.0 * 1024.0));
+    }
+    std::vector<float> pack;
+    for (uint32_t i = 0; i < repeats; ++i) {
+        Clock::time_point start = Clock::now();
+        packVertices(chooseVertexLayout(vertices, VertexLayout::Compact), vertices, packed);
+        pack.push_back(elapsedMs(start));
+    }
+
+    ScenarioResult result;
+    result.name = "assets_" + std::to_string(triangles);
+    result.phases.push_back(summarize("objLoad", parse));
+    result.phases.push_back(summarize("vertexPack", pack));
+    report.scenarios.push_back(result);
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Loopback replication scenario (one server, N clients, no engine)
+
+constexpr double kNetTickSeconds = 1.0 / 60.0;
+constexpr double kNetSettleSeconds = 10.0;
+constexpr float kNetPositionTolerance = 0.01f;     // positions are sent in 1/512 units
+
+struct NetClient {
+    explicit NetClient(LoopbackNetwork& network)
+        : transport(network.createEndpoint()), replication(transport.get()) {}
+
+    std::unique_ptr<Transport> transport;
+    ReplicationClient replication;
+    Scene scene;
+};
+
+// Every client holds every server object, at the server's position
+bool hasConverged(const Scene& server, const std::vector<std::unique_ptr<NetClient>>& clients) {
+    std::unordered_map<uint32_t, glm::vec3> expected;
+    for (Component* component : server.components) {
+        if (Replicated* replicated = dynamic_cast<Replicated*>(component)) {
+            expected.emplace(replicated->netId, replicated->owner->position);
+        }
+    }
+
+    for (const auto& client : clients) {
+        size_t matched = 0;
+        for (Component* component : client->scene.components) {
+            Replicated* replicated = dynamic_cast<Replicated*>(component);
+            if (!replicated || !replicated->owner->active) continue;
+            auto it = expected.find(replicated->netId);
+            if (it == expected.end()) return false;
+            if (glm::length(replicated->owner->position - it->second) > kNetPositionTolerance) return false;
+            matched++;
+        }
+        if (matched != expected.size()) return false;
+    }
+    return true;
+}
+
+bool runReplication(uint32_t clientCount, uint32_t objectCount, BenchReport& report) {
+    std::printf("froggi_bench: replicating %u objects to %u clients over loopback...\n", objectCount, clientCount);
+    std::fflush(stdout);
+
+    NetScene scene(objectCount, report.seed);
+    scene.onLoad();
+
+    // Every client sees the whole scene, so all of them converge to all of it
+    CVarRegistry::set("net.relevanceRadius", std::to_string(scene.extent()));
+    CVarRegistry::set("net.maxClients", std::to_string(clientCount));
+
+    LoopbackNetwork network(report.seed);
+    LoopbackConditions conditions;
+    conditions.lossRate = cv_benchNetLoss.get();
+    conditions.latencyMs = cv_benchNetLatencyMs.get();
+    conditions.jitterMs = conditions.latencyMs * 0.2f;
+    network.setConditions(conditions);
+
+    std::unique_ptr<Transport> serverTransport = network.createEndpoint();
+    ReplicationServer server(serverTransport.get());
+
+    std::vector<std::unique_ptr<NetClient>> clients;
+    for (uint32_t i = 0; i < clientCount; ++i) {
+        auto client = std::make_unique<NetClient>(network);
+        client->replication.setSpawnCallback([](Scene* target, uint32_t, uint16_t) {
+            GameObject* obj = target->createGameObject("Remote");
+            target->addComponent<Replicated>(obj);
+            return obj;
+        });
+        client->replication.connect(serverTransport->getLocalAddress());
+        clients.push_back(std::move(client));
+    }
+
+    std::vector<float> serverUpdate, serverPerClient, clientUpdate;
+    uint64_t bytesSent = 0;
+    auto tick = [&](bool moving, bool measured) {
+        network.advance(kNetTickSeconds);
+        double time = network.now();
+        if (moving) scene.move(time);
+
+        Clock::time_point start = Clock::now();
+        server.update(&scene, time);
+        float serverMs = elapsedMs(start);
+
+        // Only ticks that sent snapshots say anything about the send cost
+        const ReplicationStats& stats = server.getStats();
+        if (measured && stats.time == time && stats.clients > 0) {
+            serverUpdate.push_back(serverMs);
+            serverPerClient.push_back(stats.cpuUsPerClient * 0.001f);
+            bytesSent += stats.bytesSent;
+        }
+
+        start = Clock::now();
+        for (auto& client : clients) {
+            client->replication.update(&client->scene, time);
+        }
+        if (measured) clientUpdate.push_back(elapsedMs(start) / static_cast<float>(clients.size()));
+    };
+
+    for (uint32_t i = 0; i < report.warmupFrames + report.frames; ++i) {
+        tick(true, i >= report.warmupFrames);
+    }
+
+    // Hold still until every client has caught up
+    double stopTime = network.now();
+    while (!hasConverged(scene, clients)) {
+        if (network.now() - stopTime > kNetSettleSeconds) {
+            std::fprintf(stderr, "froggi_bench: clients did not converge within %.0f s of the last move\n",
+                         kNetSettleSeconds);
+            return false;
+        }
+        tick(false, false);
+    }
+
+    const LoopbackStats& netStats = network.getStats();
+    double measuredSeconds = report.frames * kNetTickSeconds;
+    ScenarioResult result;
+    result.name = "net_" + std::to_string(clientCount) + "x" + std::to_string(objectCount);
+    result.counts.objects = objectCount;
+    result.phases.push_back(summarize("serverUpdate", serverUpdate));
+    result.phases.push_back(summarize("serverPerClient", serverPerClient));
+    result.phases.push_back(summarize("clientUpdate", clientUpdate));
+
+    std::printf("froggi_bench: %.0f bytes/client/s, %.1f us/client per snapshot, converged %.2f s after "
+                "the last move (%llu of %llu packets lost)\n",
+                static_cast<double>(bytesSent) / (clientCount * measuredSeconds),
+                result.phases[1].meanMs * 1000.0, network.now() - stopTime,
+                static_cast<unsigned long long>(netStats.packetsDropped),
+                static_cast<unsigned long long>(netStats.packetsSent));
+    report.scenarios.push_back(result);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    CVarRegistry::init(argc, argv);
+
+    // Zone times come from the frame profiler; never write spike captures
+    FrameProfiler::setEnabled(true);
+    FrameProfiler::setSpikeThreshold(0.0f);
+
+    std::vector<uint32_t> scales = parseScales(cv_benchScales.get());
+    if (scales.empty()) {
+        std::fprintf(stderr, "froggi_bench: bench.scales has no object counts\n");
+        return 1;
+    }
+
+    BenchReport report;
+    report.build = buildDescription();
+    report.frames = static_cast<uint32_t>(cv_benchFrames.get());
+    report.warmupFrames = static_cast<uint32_t>(cv_benchWarmup.get());
+    report.seed = static_cast<uint32_t>(cv_benchSeed.get());
+
+    for (uint32_t scale : scales) {
+        if (!runScene(scale, report)) return 1;
+    }
+    if (cv_benchCityBuildings.get() > 0) {
+        if (!runCity(static_cast<uint32_t>(cv_benchCityBuildings.get()), report)) return 1;
+    }
+    if (cv_benchAssetTriangles.get() > 0) {
+        if (!runAssetLoad(static_cast<uint32_t>(cv_benchAssetTriangles.get()),
+                          static_cast<uint32_t>(cv_benchAssetRepeats.get()), report)) {
+            return 1;
+        }
+    }
+    if (cv_benchNetClients.get() > 0) {
+        if (!runReplication(static_cast<uint32_t>(cv_benchNetClients.get()),
+                            static_cast<uint32_t>(cv_benchNetObjects.get()), report)) {
+            return 1;
+        }
+    }
+
+    BenchReport baseline;
+    bool hasBaseline = !cv_benchBaseline.get().empty();
+    if (hasBaseline && !readReport(cv_benchBaseline.get(), baseline)) return 1;
+
+    printReport(report, hasBaseline ? &baseline : nullptr);
+    if (!cv_benchOut.get().empty()) {
+        if (!writeReport(report, cv_benchOut.get())) return 1;
+        std::printf("\nfroggi_bench: results written to %s\n", cv_benchOut.get().c_str());
+    }
+
+    if (!hasBaseline) return 0;
+
+    std::vector<Regression> regressions = compareReports(report, baseline,
+                                                         cv_benchTolerance.get(), cv_benchMinDeltaMs.get());
+    for (const Regression& r : regressions) {
+        std::printf("REGRESSION %s/%s: %.3f ms -> %.3f ms\n", r.scenario.c_str(), r.phase.c_str(),
+                    r.baselineMs, r.currentMs);
+    }
+    if (!regressions.empty()) return 2;
+
+    std::printf("froggi_bench: no regressions against %s\n", cv_benchBaseline.get().c_str());
+    return 0;
+}
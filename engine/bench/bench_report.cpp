@@ -0,0 +1,207 @@
+#include "bench_report.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <numeric>
+
+namespace froggi {
+namespace bench {
+
+using nlohmann::json;
+
+namespace {
+
+constexpr int kReportVersion = 1;
+
+const ScenarioResult* findScenario(const BenchReport& report, const std::string& name) {
+    for (const ScenarioResult& scenario : report.scenarios) {
+        if (scenario.name == name) return &scenario;
+    }
+    return nullptr;
+}
+
+const PhaseStats* findPhase(const ScenarioResult& scenario, const std::string& name) {
+    for (const PhaseStats& phase : scenario.phases) {
+        if (phase.name == name) return &phase;
+    }
+    return nullptr;
+}
+
+json countsToJson(const SceneCounts& counts) {
+    return {
+        { "objects", counts.objects },
+        { "staticBodies", counts.staticBodies },
+        { "dynamicBodies", counts.dynamicBodies },
+        { "kinematicBodies", counts.kinematicBodies },
+        { "hierarchyNodes", counts.hierarchyNodes },
+        { "animators", counts.animators },
+        { "plainMeshes", counts.plainMeshes },
+    };
+}
+
+SceneCounts countsFromJson(const json& j) {
+    SceneCounts counts;
+    counts.objects = j.value("objects", 0u);
+    counts.staticBodies = j.value("staticBodies", 0u);
+    counts.dynamicBodies = j.value("dynamicBodies", 0u);
+    counts.kinematicBodies = j.value("kinematicBodies", 0u);
+    counts.hierarchyNodes = j.value("hierarchyNodes", 0u);
+    counts.animators = j.value("animators", 0u);
+    counts.plainMeshes = j.value("plainMeshes", 0u);
+    return counts;
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// Statistics
+
+PhaseStats summarize(const std::string& name, std::vector<float>& samples) {
+    PhaseStats stats;
+    stats.name = name;
+    if (samples.empty()) return stats;
+
+    std::sort(samples.begin(), samples.end());
+    size_t count = samples.size();
+    stats.meanMs = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(count);
+    stats.medianMs = count % 2 ? samples[count / 2]
+                               : 0.5 * (static_cast<double>(samples[count / 2 - 1]) + samples[count / 2]);
+    stats.p95Ms = samples[std::min(count - 1, static_cast<size_t>(static_cast<double>(count) * 0.95))];
+    stats.maxMs = samples.back();
+    return stats;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// JSON I/O
+
+bool writeReport(const BenchReport& report, const std::string& path) {
+    json root;
+    root["version"] = kReportVersion;
+    root["build"] = report.build;
+    root["frames"] = report.frames;
+    root["warmupFrames"] = report.warmupFrames;
+    root["seed"] = report.seed;
+
+    json scenarios = json::array();
+    for (const ScenarioResult& scenario : report.scenarios) {
+        json phases = json::object();
+        for (const PhaseStats& phase : scenario.phases) {
+            phases[phase.name] = {
+                { "meanMs", phase.meanMs },
+                { "medianMs", phase.medianMs },
+                { "p95Ms", phase.p95Ms },
+                { "maxMs", phase.maxMs },
+            };
+        }
+        scenarios.push_back({
+            { "name", scenario.name },
+            { "counts", countsToJson(scenario.counts) },
+            { "bodies", scenario.bodies },
+            { "phases", phases },
+        });
+    }
+    root["scenarios"] = scenarios;
+
+    std::ofstream file(path);
+    if (!file) {
+        std::fprintf(stderr, "froggi_bench: cannot write '%s'\n", path.c_str());
+        return false;
+    }
+    file << root.dump(2) << '\n';
+    return static_cast<bool>(file);
+}
+
+bool readReport(const std::string& path, BenchReport& report) {
+    std::ifstream file(path);
+    if (!file) {
+        std::fprintf(stderr, "froggi_bench: cannot read baseline '%s'\n", path.c_str());
+        return false;
+    }
+
+    json root = json::parse(file, nullptr, false);
+    if (root.is_discarded() || !root.is_object()) {
+        std::fprintf(stderr, "froggi_bench: '%s' is not valid JSON\n", path.c_str());
+        return false;
+    }
+    if (root.value("version", 0) != kReportVersion) {
+        std::fprintf(stderr, "froggi_bench: '%s' has an unsupported report version\n", path.c_str());
+        return false;
+    }
+
+    report = BenchReport();
+    report.build = root.value("build", std::string());
+    report.frames = root.value("frames", 0u);
+    report.warmupFrames = root.value("warmupFrames", 0u);
+    report.seed = root.value("seed", 0u);
+
+    for (const json& entry : root.value("scenarios", json::array())) {
+        ScenarioResult scenario;
+        scenario.name = entry.value("name", std::string());
+        scenario.counts = countsFromJson(entry.value("counts", json::object()));
+        scenario.bodies = entry.value("bodies", 0u);
+        json phases = entry.value("phases", json::object());
+        for (const auto& item : phases.items()) {
+            PhaseStats phase;
+            phase.name = item.key();
+            phase.meanMs = item.value().value("meanMs", 0.0);
+            phase.medianMs = item.value().value("medianMs", 0.0);
+            phase.p95Ms = item.value().value("p95Ms", 0.0);
+            phase.maxMs = item.value().value("maxMs", 0.0);
+            scenario.phases.push_back(phase);
+        }
+        report.scenarios.push_back(scenario);
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Comparison
+
+std::vector<Regression> compareReports(const BenchReport& current, const BenchReport& baseline,
+                                       float tolerance, float minDeltaMs) {
+    std::vector<Regression> regressions;
+    for (const ScenarioResult& scenario : current.scenarios) {
+        const ScenarioResult* before = findScenario(baseline, scenario.name);
+        if (!before) continue;
+
+        for (const PhaseStats& phase : scenario.phases) {
+            const PhaseStats* old = findPhase(*before, phase.name);
+            if (!old) continue;
+
+            double delta = phase.medianMs - old->medianMs;
+            if (delta > minDeltaMs && phase.medianMs > old->medianMs * (1.0 + tolerance)) {
+                regressions.push_back({ scenario.name, phase.name, old->medianMs, phase.medianMs });
+            }
+        }
+    }
+    return regressions;
+}
+
+void printReport(const BenchReport& report, const BenchReport* baseline) {
+    for (const ScenarioResult& scenario : report.scenarios) {
+        std::printf("\n%s  (%u objects, %u bodies)\n", scenario.name.c_str(),
+                    scenario.counts.objects, scenario.bodies);
+        std::printf("  %-12s %10s %10s %10s %10s", "phase", "mean", "median", "p95", "max");
+        if (baseline) std::printf(" %10s %8s", "baseline", "change");
+        std::printf("\n");
+
+        const ScenarioResult* before = baseline ? findScenario(*baseline, scenario.name) : nullptr;
+        for (const PhaseStats& phase : scenario.phases) {
+            std::printf("  %-12s %10.3f %10.3f %10.3f %10.3f", phase.name.c_str(),
+                        phase.meanMs, phase.medianMs, phase.p95Ms, phase.maxMs);
+
+            const PhaseStats* old = before ? findPhase(*before, phase.name) : nullptr;
+            if (old && old->medianMs > 0.0) {
+                double change = (phase.medianMs / old->medianMs - 1.0) * 100.0;
+                std::printf(" %10.3f %+7.1f%%", old->medianMs, change);
+            } else if (baseline) {
+                std::printf(" %10s %8s", "-", "-");
+            }
+            std::printf("\n");
+        }
+    }
+}
+
+} // namespace bench
+} // namespace froggi
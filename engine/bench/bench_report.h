@@ -0,0 +1,69 @@
+#pragma once
+
+#include "bench_scene.h"
+#include <string>
+#include <vector>
+
+namespace froggi {
+namespace bench {
+
+///////////////////////////////////////////////////////////////////////////////
+// Results
+
+struct PhaseStats {
+    std::string name;
+    double meanMs = 0.0;
+    double medianMs = 0.0;
+    double p95Ms = 0.0;
+    double maxMs = 0.0;
+};
+
+/**
+ * Summarize per-frame samples (sorts them in place)
+ */
+PhaseStats summarize(const std::string& name, std::vector<float>& samples);
+
+struct ScenarioResult {
+    std::string name;
+    SceneCounts counts;
+    uint32_t bodies = 0;            // as reported by the collision system
+    std::vector<PhaseStats> phases;
+};
+
+struct BenchReport {
+    std::string build;              // compiler and configuration
+    uint32_t frames = 0;
+    uint32_t warmupFrames = 0;
+    uint32_t seed = 0;
+    std::vector<ScenarioResult> scenarios;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// JSON I/O and baseline comparison
+
+bool writeReport(const BenchReport& report, const std::string& path);
+bool readReport(const std::string& path, BenchReport& report);
+
+struct Regression {
+    std::string scenario;
+    std::string phase;
+    double baselineMs = 0.0;
+    double currentMs = 0.0;
+};
+
+/**
+ * Compare medians of every phase present in both reports
+ * @param tolerance Allowed slowdown as a fraction (0.1 = 10%)
+ * @param minDeltaMs Slowdowns smaller than this are noise, never regressions
+ */
+std::vector<Regression> compareReports(const BenchReport& current, const BenchReport& baseline,
+                                       float tolerance, float minDeltaMs);
+
+/**
+ * Print the results as a table, with the baseline median next to each
+ * phase when a baseline is given
+ */
+void printReport(const BenchReport& report, const BenchReport* baseline);
+
+} // namespace bench
+} // namespace froggi
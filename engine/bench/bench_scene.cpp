@@ -0,0 +1,342 @@
+#include "bench_scene.h"
+#include "animation_system.h"
+#include "collision_system.h"
+#include "replication.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace froggi {
+namespace bench {
+
+namespace {
+
+constexpr float kSpacing = 3.0f;
+constexpr int kHierarchyChildren = 3;
+constexpr int kAnimationFrames = 4;
+
+///////////////////////////////////////////////////////////////////////////////
+// Bench components
+
+// Rotates its object, dragging any children along
+class Spinner : public Component {
+public:
+    float speed = 1.0f;
+
+    void onUpdate(float deltaTime) override {
+        owner->rotation.z += speed * deltaTime;
+    }
+};
+
+// Moves a kinematic body around a small circle
+class KinematicMover : public Component {
+public:
+    glm::vec3 center = glm::vec3(0.0f);
+    float radius = 1.0f;
+    float speed = 1.0f;
+    float phase = 0.0f;
+
+    void onUpdate(float deltaTime) override {
+        phase += speed * deltaTime;
+        owner->position = center + glm::vec3(std::cos(phase), std::sin(phase), 0.0f) * radius;
+    }
+};
+
+// Square-ish grid, row by row, centered on the origin
+class GridLayout {
+public:
+    explicit GridLayout(uint32_t count)
+        : columns(std::max<uint32_t>(1, static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(count)))))) {}
+
+    glm::vec3 next() {
+        uint32_t column = index % columns;
+        uint32_t row = index / columns;
+        index++;
+        float half = static_cast<float>(columns) * 0.5f;
+        return glm::vec3((static_cast<float>(column) - half) * kSpacing,
+                         (static_cast<float>(row) - half) * kSpacing, 0.0f);
+    }
+
+    float extent() const { return static_cast<float>(columns) * kSpacing; }
+
+private:
+    uint32_t columns;
+    uint32_t index = 0;
+};
+
+uint32_t fraction(uint32_t total, float share) {
+    return static_cast<uint32_t>(static_cast<double>(total) * std::max(0.0f, share));
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// Scene planning
+
+SceneCounts planScene(uint32_t objectCount, const SceneMix& mix, uint32_t maxBodies) {
+    SceneCounts counts;
+    counts.objects = objectCount;
+    counts.staticBodies = fraction(objectCount, mix.staticBodies);
+    counts.dynamicBodies = fraction(objectCount, mix.dynamicBodies);
+    counts.kinematicBodies = fraction(objectCount, mix.kinematicBodies);
+
+    // Scale all three kinds down together; one body is the ground plane
+    uint32_t bodyBudget = maxBodies > 1 ? maxBodies - 1 : 0;
+    uint32_t bodies = counts.staticBodies + counts.dynamicBodies + counts.kinematicBodies;
+    if (bodies > bodyBudget) {
+        double scale = static_cast<double>(bodyBudget) / static_cast<double>(bodies);
+        counts.staticBodies = static_cast<uint32_t>(counts.staticBodies * scale);
+        counts.dynamicBodies = static_cast<uint32_t>(counts.dynamicBodies * scale);
+        counts.kinematicBodies = static_cast<uint32_t>(counts.kinematicBodies * scale);
+    }
+
+    // Whole groups only
+    uint32_t groupSize = 1 + kHierarchyChildren;
+    counts.hierarchyNodes = fraction(objectCount, mix.hierarchies) / groupSize * groupSize;
+    counts.animators = fraction(objectCount, mix.animators);
+
+    uint32_t used = counts.staticBodies + counts.dynamicBodies + counts.kinematicBodies +
+                    counts.hierarchyNodes + counts.animators;
+    counts.plainMeshes = objectCount > used ? objectCount - used : 0;
+    return counts;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// BenchScene Implementation
+
+BenchScene::BenchScene(const SceneCounts& sceneCounts, uint32_t sceneSeed)
+    : counts(sceneCounts), seed(sceneSeed) {
+    name = "Bench Scene";
+}
+
+void BenchScene::onLoad() {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    gameObjects.reserve(counts.objects + 2);
+    components.reserve(static_cast<size_t>(counts.objects) * 3 + 4);
+
+    GridLayout grid(counts.objects);
+
+    // ═══════════════════════════════════════════════════════════════
+    // CAMERA & GROUND
+    // ═══════════════════════════════════════════════════════════════
+
+    GameObject* cameraObject = createGameObject("Camera");
+    camera = addComponent<CameraComponent>(cameraObject);
+
+    GameObject* ground = createGameObject("Ground");
+    ground->position = glm::vec3(0.0f, 0.0f, -1.0f);
+    Collider* groundCollider = addComponent<Collider>(ground);
+    groundCollider->size = glm::vec3(grid.extent() + kSpacing, grid.extent() + kSpacing, 1.0f);
+    groundCollider->collisionLayer = CollisionLayer::Ground;
+
+    // ═══════════════════════════════════════════════════════════════
+    // PHYSICS BODIES
+    // ═══════════════════════════════════════════════════════════════
+
+    for (uint32_t i = 0; i < counts.staticBodies; ++i) {
+        GameObject* obj = createGameObject("Static");
+        obj->position = grid.next();
+        addComponent<MeshComponent>(obj)->setMesh("cube");
+        Collider* collider = addComponent<Collider>(obj);
+        collider->collisionLayer = CollisionLayer::Wall;
+    }
+
+    for (uint32_t i = 0; i < counts.dynamicBodies; ++i) {
+        GameObject* obj = createGameObject("Dynamic");
+        // Staggered drop heights so some land on each other
+        obj->position = grid.next() + glm::vec3(0.0f, 0.0f, 2.0f + static_cast<float>(i % 4) * 1.5f);
+        addComponent<MeshComponent>(obj)->setMesh("cube");
+        Collider* collider = addComponent<Collider>(obj);
+        collider->collisionLayer = CollisionLayer::Enemy;
+        Rigidbody* rb = addComponent<Rigidbody>(obj);
+        rb->velocity = glm::vec3(unit(rng) - 0.5f, unit(rng) - 0.5f, 0.0f) * 4.0f;
+    }
+
+    for (uint32_t i = 0; i < counts.kinematicBodies; ++i) {
+        GameObject* obj = createGameObject("Kinematic");
+        glm::vec3 center = grid.next() + glm::vec3(0.0f, 0.0f, 1.0f);
+        obj->position = center;
+        addComponent<MeshComponent>(obj)->setMesh("cube");
+        Collider* collider = addComponent<Collider>(obj);
+        collider->collisionLayer = CollisionLayer::Enemy;
+        Rigidbody* rb = addComponent<Rigidbody>(obj);
+        rb->isKinematic = true;
+        rb->useGravity = false;
+        KinematicMover* mover = addComponent<KinematicMover>(obj);
+        mover->center = center;
+        mover->speed = 0.5f + unit(rng);
+        mover->phase = unit(rng) * 6.2831853f;
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // HIERARCHIES
+    // ═══════════════════════════════════════════════════════════════
+
+    for (uint32_t i = 0; i < counts.hierarchyNodes; i += 1 + kHierarchyChildren) {
+        GameObject* root = createGameObject("HierarchyRoot");
+        root->position = grid.next();
+        addComponent<MeshComponent>(root)->setMesh("cube");
+        addComponent<Spinner>(root)->speed = 0.5f + unit(rng);
+
+        for (int c = 0; c < kHierarchyChildren; ++c) {
+            GameObject* child = createGameObject("HierarchyChild");
+            float angle = static_cast<float>(c) * 6.2831853f / kHierarchyChildren;
+            child->position = glm::vec3(std::cos(angle), std::sin(angle), 0.0f);
+            child->scale = glm::vec3(0.5f);
+            child->parent = root;
+            root->children.push_back(child);
+            addComponent<MeshComponent>(child)->setMesh("cube");
+            // Children don't take a grid cell
+        }
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // ANIMATORS (meshes don't exist headless; the clip still swaps names)
+    // ═══════════════════════════════════════════════════════════════
+
+    AnimationClip clip("idle");
+    for (int f = 0; f < kAnimationFrames; ++f) {
+        clip.frameNames.push_back("idle_" + std::to_string(f));
+    }
+    clip.frameRate = 12.0f;
+
+    for (uint32_t i = 0; i < counts.animators; ++i) {
+        GameObject* obj = createGameObject("Animated");
+        obj->position = grid.next();
+        addComponent<MeshComponent>(obj);
+        Animator* animator = addComponent<Animator>(obj);
+        animator->addClip(clip);
+        animator->setSpeed(0.75f + unit(rng) * 0.5f);
+        animator->play("idle");
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // PLAIN MESHES
+    // ═══════════════════════════════════════════════════════════════
+
+    for (uint32_t i = 0; i < counts.plainMeshes; ++i) {
+        GameObject* obj = createGameObject("Prop");
+        obj->position = grid.next();
+        obj->rotation.z = unit(rng) * 6.2831853f;
+        addComponent<MeshComponent>(obj)->setMesh("cube");
+    }
+
+    // Look down on the middle of the field
+    cameraObject->position = glm::vec3(0.0f, 0.0f, 10.0f);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// CityScene Implementation
+
+CityScene::CityScene(uint32_t buildingCount, uint32_t sceneSeed)
+    : buildings(buildingCount), seed(sceneSeed) {
+    name = "City Scene";
+}
+
+void CityScene::onLoad() {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    gameObjects.reserve(buildings + 1);
+    components.reserve(static_cast<size_t>(buildings) + 1);
+
+    GridLayout grid(buildings);
+    for (uint32_t i = 0; i < buildings; ++i) {
+        GameObject* obj = createGameObject("Building");
+        // Mostly low blocks with the odd tower
+        float height = 3.0f + 27.0f * unit(rng) * unit(rng);
+        obj->position = grid.next() + glm::vec3(0.0f, 0.0f, height * 0.5f);
+        obj->scale = glm::vec3(kSpacing * 0.9f, kSpacing * 0.9f, height);
+        addComponent<MeshComponent>(obj)->setMesh("cube");
+    }
+
+    // Isometric view of the middle of the block, wide enough to see a
+    // few thousand buildings at once
+    GameObject* cameraObject = createGameObject("Camera");
+    camera = addComponent<CameraComponent>(cameraObject);
+    cameraObject->rotation = glm::vec3(-1.1f, 0.0f, 0.785398f);
+
+    float halfWidth = std::min(grid.extent() * 0.5f, 90.0f);
+    camera->orthoLeft = -halfWidth;
+    camera->orthoRight = halfWidth;
+    camera->orthoTop = -halfWidth * 9.0f / 16.0f;
+    camera->orthoBottom = halfWidth * 9.0f / 16.0f;
+    camera->nearClip = -grid.extent();
+    camera->farClip = grid.extent();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// NetScene Implementation
+
+NetScene::NetScene(uint32_t objectCount, uint32_t sceneSeed)
+    : objects(objectCount), seed(sceneSeed) {
+    name = "Net Scene";
+}
+
+void NetScene::onLoad() {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    gameObjects.reserve(objects);
+    components.reserve(objects);
+    movers.reserve(objects);
+
+    GridLayout grid(objects);
+    for (uint32_t i = 0; i < objects; ++i) {
+        GameObject* obj = createGameObject("Mover");
+        addComponent<Replicated>(obj)->type = 1;
+
+        Mover mover;
+        mover.object = obj;
+        mover.center = grid.next();
+        mover.radius = 0.25f + unit(rng);
+        mover.speed = 0.5f + unit(rng) * 2.0f;
+        mover.phase = unit(rng) * 6.2831853f;
+        movers.push_back(mover);
+    }
+    radius = grid.extent() * 0.75f + 2.0f;
+    move(0.0);
+}
+
+void NetScene::move(double time) {
+    for (const Mover& mover : movers) {
+        float angle = mover.phase + mover.speed * static_cast<float>(time);
+        mover.object->position = mover.center + glm::vec3(std::cos(angle), std::sin(angle), 0.0f) * mover.radius;
+        mover.object->rotation.z = std::fmod(angle, 6.2831853f);
+    }
+}
+
+std::vector<glm::vec3> cubeTriangles() {
+    // Two triangles per face, corners indexed by their xyz sign bits
+    static const int kFaces[6][4] = {
+        { 0, 2, 6, 4 }, { 1, 5, 7, 3 },     // -x, +x
+        { 0, 4, 5, 1 }, { 2, 3, 7, 6 },     // -y, +y
+        { 0, 1, 3, 2 }, { 4, 6, 7, 5 },     // -z, +z
+    };
+    auto corner = [](int bits) {
+        return glm::vec3((bits & 1) ? 0.5f : -0.5f, (bits & 2) ? 0.5f : -0.5f, (bits & 4) ? 0.5f : -0.5f);
+    };
+
+    std::vector<glm::vec3> triangles;
+    triangles.reserve(36);
+    for (const auto& face : kFaces) {
+        for (int index : { face[0], face[1], face[2], face[0], face[2], face[3] }) {
+            triangles.push_back(corner(index));
+        }
+    }
+    return triangles;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// BenchGame Implementation
+
+void BenchGame::onInit() {
+    BenchScene* scene = new BenchScene(counts, seed);
+    loadScene(scene);
+    setMainCamera(scene->getCamera());
+}
+
+} // namespace bench
+} // namespace froggi
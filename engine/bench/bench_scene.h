@@ -0,0 +1,136 @@
+#pragma once
+
+#include "pond_interface.h"
+#include <cstdint>
+#include <vector>
+
+namespace froggi {
+namespace bench {
+
+///////////////////////////////////////////////////////////////////////////////
+// Synthetic scene mix
+//
+// Fractions of the requested object count. Physics bodies are capped by
+// p.maxBodies (Jolt's limit is 65536 here); objects over the cap become
+// plain meshes so the object count stays what was asked for.
+
+struct SceneMix {
+    float staticBodies = 0.10f;         // box collider, no rigidbody
+    float dynamicBodies = 0.15f;        // falling boxes on a ground plane
+    float kinematicBodies = 0.05f;      // moved by a component each frame
+    float hierarchies = 0.40f;          // spinning root + 3 children
+    float animators = 0.15f;            // 4-frame looping clip
+    // Remainder: plain static meshes
+};
+
+struct SceneCounts {
+    uint32_t objects = 0;
+    uint32_t staticBodies = 0;
+    uint32_t dynamicBodies = 0;
+    uint32_t kinematicBodies = 0;
+    uint32_t hierarchyNodes = 0;
+    uint32_t animators = 0;
+    uint32_t plainMeshes = 0;
+};
+
+/**
+ * Compute how many of each kind a scene of objectCount gets
+ * @param maxBodies Cap on static + dynamic + kinematic bodies
+ */
+SceneCounts planScene(uint32_t objectCount, const SceneMix& mix, uint32_t maxBodies);
+
+///////////////////////////////////////////////////////////////////////////////
+// BenchScene - Deterministic synthetic scene (fixed seed, grid layout)
+
+class BenchScene : public Scene {
+public:
+    BenchScene(const SceneCounts& counts, uint32_t seed);
+
+    void onLoad() override;
+
+    const SceneCounts& getCounts() const { return counts; }
+    CameraComponent* getCamera() const { return camera; }
+
+private:
+    SceneCounts counts;
+    uint32_t seed;
+    CameraComponent* camera = nullptr;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// CityScene - Dense block of box buildings under an isometric camera
+//
+// Most buildings are hidden behind taller ones in front of them, which is
+// what the occlusion culling benchmark measures. Needs no engine: call
+// onLoad() directly and extract draws with a registry holding "cube".
+
+class CityScene : public Scene {
+public:
+    CityScene(uint32_t buildings, uint32_t seed);
+
+    void onLoad() override;
+
+    CameraComponent* getCamera() const { return camera; }
+
+private:
+    uint32_t buildings;
+    uint32_t seed;
+    CameraComponent* camera = nullptr;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// NetScene - Replicated objects circling on a grid
+//
+// Server side of the replication benchmark. Nothing updates the objects on
+// its own: move() places every object on its circle for a given time, so
+// the caller decides when the world changes and when it holds still.
+
+class NetScene : public Scene {
+public:
+    NetScene(uint32_t objects, uint32_t seed);
+
+    void onLoad() override;
+    void move(double time);
+
+    // Distance from the origin that covers every object
+    float extent() const { return radius; }
+
+private:
+    struct Mover {
+        GameObject* object;
+        glm::vec3 center;
+        float radius;
+        float speed;
+        float phase;
+    };
+
+    uint32_t objects;
+    uint32_t seed;
+    float radius = 0.0f;
+    std::vector<Mover> movers;
+};
+
+/**
+ * The unit cube ("cube", -0.5..0.5) as a triangle list, for registries
+ * that need occluder geometry
+ */
+std::vector<glm::vec3> cubeTriangles();
+
+///////////////////////////////////////////////////////////////////////////////
+// BenchGame - Loads one BenchScene and otherwise stays out of the way
+
+class BenchGame : public Game {
+public:
+    BenchGame(const SceneCounts& counts, uint32_t seed) : counts(counts), seed(seed) {}
+
+    void onInit() override;
+    void onUpdate(float deltaTime) override { (void)deltaTime; }
+    void onShutdown() override {}
+
+private:
+    SceneCounts counts;
+    uint32_t seed;
+};
+
+} // namespace bench
+} // namespace froggi
@@ -1,5 +1,8 @@
 #include "animation_system.h"
 #include "pond_interface.h"
+#include "memory_tracker.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <iomanip>
 #include <sstream>
@@ -9,24 +12,32 @@ namespace froggi {
 ///////////////////////////////////////////////////////////////////////////////
 // Animator Component Implementation
 
+Animator::Animator() {
+    updateLod.enabled = true;
+    updateLod.nearDistance = 30.0f;
+    updateLod.farDistance = 90.0f;
+    updateLod.farInterval = 4;
+    updateLod.offscreenInterval = 0;
+}
+
 void Animator::onUpdate(float deltaTime) {
+    FROGGI_MEMORY_SCOPE(Animation);
     if (playing && !paused && currentClip) {
         updateAnimation(deltaTime);
     }
 }
 
 void Animator::play(const std::string& clipName, bool forceRestart) {
-   // std::cout << "[Animator] Attempting to play: " << clipName << std::endl;
-    //std::cout << "[Animator] Available clips: " << clips.size() << std::endl;
-    
     auto it = clips.find(clipName);
     if (it == clips.end()) {
-        std::cerr << "[Animator] ERROR: Animation clip not found: " << clipName << std::endl;
-        std::cerr << "[Animator] Available clips are: ";
-        for (const auto& pair : clips) {
-            std::cerr << pair.first << " ";
+        FROGGI_LOG_ERROR(Animation, "[Animator] ERROR: Animation clip not found: %s", clipName.c_str());
+        if (Log::isEnabled(LogLevel::Error, LogCategory::Animation)) {
+            std::string available;
+            for (const auto& pair : clips) {
+                available += pair.first + " ";
+            }
+            FROGGI_LOG_ERROR(Animation, "[Animator] Available clips are: %s", available.c_str());
         }
-        std::cerr << std::endl;
         return;
     }
     
@@ -43,10 +54,6 @@ void Animator::play(const std::string& clipName, bool forceRestart) {
     playing = true;
     paused = false;
     
-   // std::cout << "[Animator] Starting clip: " << clipName 
-         //     << " with " << currentClip->frameNames.size() << " frames at " 
-        //      << currentClip->frameRate << " fps" << std::endl;
-    
     setFrame(0);
 }
 
@@ -65,6 +72,15 @@ void Animator::resume() {
     paused = false;
 }
 
+void Animator::seekFrame(int frame) {
+    if (!currentClip || currentClip->frameNames.empty()) return;
+    
+    int totalFrames = static_cast<int>(currentClip->frameNames.size());
+    currentFrame = std::max(0, std::min(frame, totalFrames - 1));
+    currentTime = static_cast<float>(currentFrame) / currentClip->frameRate;
+    setFrame(currentFrame);
+}
+
 void Animator::addClip(const AnimationClip& clip) {
     clips[clip.name] = clip;
 }
@@ -90,11 +106,11 @@ void Animator::updateAnimation(float deltaTime) {
     int totalFrames = static_cast<int>(currentClip->frameNames.size());
     int newFrame = static_cast<int>(currentTime / frameDuration);
     
-    // Handle looping
+    // Handle looping (deltaTime can span many frames under update LOD)
     if (newFrame >= totalFrames) {
         if (currentClip->loop) {
-            currentTime = 0.0f;
-            newFrame = 0;
+            currentTime = std::fmod(currentTime, frameDuration * static_cast<float>(totalFrames));
+            newFrame = std::min(static_cast<int>(currentTime / frameDuration), totalFrames - 1);
        //     std::cout << "[Animator] Looping animation: " << currentClipName << std::endl;
         } else {
             // Animation finished
@@ -115,26 +131,26 @@ void Animator::updateAnimation(float deltaTime) {
 
 void Animator::setFrame(int frame) {
     if (!owner || !currentClip) {
-        std::cerr << "[Animator] ERROR: Cannot set frame - owner or currentClip is null" << std::endl;
+        FROGGI_LOG_ERROR(Animation, "[Animator] ERROR: Cannot set frame - owner or currentClip is null");
         return;
     }
     
     if (frame < 0 || frame >= static_cast<int>(currentClip->frameNames.size())) {
-        std::cerr << "[Animator] ERROR: Frame out of bounds: " << frame << std::endl;
+        FROGGI_LOG_ERROR(Animation, "[Animator] ERROR: Frame out of bounds: %d", frame);
         return;
     }
     
     // Get mesh component
     MeshComponent* meshComp = owner->getComponent<MeshComponent>();
     if (!meshComp) {
-        std::cerr << "[Animator] ERROR: Animator requires MeshComponent on owner" << std::endl;
+        FROGGI_LOG_ERROR(Animation, "[Animator] ERROR: Animator requires MeshComponent on owner");
         return;
     }
     
     // Update mesh to current frame
-    std::string newMeshName = currentClip->frameNames[frame];
+    const std::string& newMeshName = currentClip->frameNames[frame];
   //  std::cout << "[Animator] Setting mesh to: " << newMeshName << std::endl;
-    meshComp->meshName = newMeshName;
+    meshComp->setMesh(newMeshName);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
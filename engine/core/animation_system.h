@@ -25,7 +25,11 @@ struct AnimationClip {
 
 class Animator : public Component {
 public:
-    Animator() = default;
+    /**
+     * Uses update LOD by default: distant animators step less often and
+     * off-screen ones stop swapping meshes until they are visible again
+     */
+    Animator();
     
     void onUpdate(float deltaTime) override;
     
@@ -36,6 +40,11 @@ public:
     void resume();
     void setSpeed(float speed) { playbackSpeed = speed; }
     
+    /**
+     * Jump to a frame of the current clip (e.g. to follow a server)
+     */
+    void seekFrame(int frame);
+    
     // Query state
     bool isPlaying() const { return playing && !paused; }
     bool isPaused() const { return paused; }
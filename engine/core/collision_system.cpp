@@ -3,16 +3,39 @@
 #include "resource_manager.h"
 #include "tiny_obj_loader.h"
 #include "jolt_debug_renderer.h"
-#include <iostream>
+#include "cvar.h"
+#include "metrics.h"
 #include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <cstdarg>
-#include <cstdio>
+#include <mutex>
 
 // Jolt uses STL containers, disable warnings
 JPH_SUPPRESS_WARNINGS
 
 namespace froggi {
 
+///////////////////////////////////////////////////////////////////////////////
+// Physics CVars
+
+static AutoCVarInt cv_collisionSteps("p.collisionSteps", "Jolt collision steps per fixed update when p.adaptiveSteps is off", 4, 1, 16);
+static AutoCVarBool cv_adaptiveSteps("p.adaptiveSteps", "Choose collision steps per fixed update from body speeds, contacts and budget", true);
+static AutoCVarInt cv_minCollisionSteps("p.minCollisionSteps", "Fewest collision steps the governor picks", 1, 1, 16);
+static AutoCVarInt cv_maxCollisionSteps("p.maxCollisionSteps", "Most collision steps the governor picks", 8, 1, 16);
+static AutoCVarFloat cv_maxStepTravel("p.maxStepTravel", "Fraction of its thinnest dimension a body may move per collision step", 0.5f, 0.05f, 4.0f);
+static AutoCVarInt cv_contactsPerStep("p.contactsPerStep", "Contacts per extra collision step (0 = ignore contacts)", 256, 0, 65536);
+static AutoCVarInt cv_jobThreads("p.jobThreads", "Physics worker threads (-1 = hardware threads - 1)", 4, -1, 64);
+static AutoCVarInt cv_tempAllocatorMB("p.tempAllocatorMB", "Jolt per-step temp allocator size in MB", 10, 1, 512);
+static AutoCVarInt cv_maxBodies("p.maxBodies", "Maximum physics bodies", 1024, 16, 65536, CVarFlag_Restart);
+static AutoCVarInt cv_maxBodyPairs("p.maxBodyPairs", "Maximum broad phase body pairs", 1024, 16, 65536, CVarFlag_Restart);
+static AutoCVarInt cv_maxContactConstraints("p.maxContactConstraints", "Maximum contact constraints", 1024, 16, 65536, CVarFlag_Restart);
+
+static MetricCounter metric_contacts("physics.contacts");
+static MetricGauge metric_bodies("physics.bodies");
+static MetricGauge metric_activeBodies("physics.active_bodies");
+static MetricGauge metric_collisionSteps("physics.collision_steps");
+
 ///////////////////////////////////////////////////////////////////////////////
 // Helper: Convert glm to Jolt types
 
@@ -32,14 +55,185 @@ static JPH::Quat toJoltQuat(const glm::vec3& eulerRadians) {
     return qz * qy * qx;
 }
 
+// Smallest dimension of a collider's shape (how far it can move before tunneling)
+static float colliderThickness(const Collider* collider) {
+    switch (collider->shapeType) {
+        case CollisionShapeType::Sphere:
+        case CollisionShapeType::Capsule:
+            return 2.0f * collider->radius;
+        default:
+            return std::min(collider->size.x, std::min(collider->size.y, collider->size.z));
+    }
+}
+
 // Trace callback function (not a lambda with variadic args)
 static void TraceImpl(const char* inFMT, ...) {
+    if (!Log::isEnabled(LogLevel::Info, LogCategory::Physics)) return;
+    static LogSite site(__FILE__, __LINE__);
     va_list list;
     va_start(list, inFMT);
-    char buffer[1024];
-    vsnprintf(buffer, sizeof(buffer), inFMT, list);
+    Log::writeV(&site, LogLevel::Info, LogCategory::Physics, inFMT, list);
     va_end(list);
-    std::cout << buffer << std::endl;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Shared Jolt Runtime
+//
+// Jolt's allocator hooks, factory and type registry are process globals.
+// They are set up by the first CollisionSystem and torn down with the last,
+// so any number of engines can simulate side by side. Collision meshes are
+// immutable once built and shared between all of them.
+
+static std::mutex& joltRuntimeMutex() {
+    static std::mutex instance;
+    return instance;
+}
+
+static int s_joltUsers = 0;
+static std::unordered_map<std::string, JPH::RefConst<JPH::Shape>> s_meshShapes;
+
+static void acquireJoltRuntime() {
+    std::lock_guard<std::mutex> lock(joltRuntimeMutex());
+    if (s_joltUsers++ > 0) return;
+
+    // Register allocation hook
+    JPH::RegisterDefaultAllocator();
+    
+    // Install trace and assert callbacks
+    JPH::Trace = TraceImpl;
+    
+    JPH_IF_ENABLE_ASSERTS(JPH::AssertFailed = [](const char* inExpression, const char* inMessage, const char* inFile, uint inLine) {
+        FROGGI_LOG_ERROR(Physics, "%s:%u: (%s) %s", inFile, inLine, inExpression, inMessage != nullptr ? inMessage : "");
+        Log::flush();
+        return true;
+    };)
+    
+    // Create factory
+    JPH::Factory::sInstance = new JPH::Factory();
+    
+    // Register all Jolt physics types
+    JPH::RegisterTypes();
+}
+
+static void releaseJoltRuntime() {
+    std::lock_guard<std::mutex> lock(joltRuntimeMutex());
+    if (--s_joltUsers > 0) return;
+
+    s_meshShapes.clear();
+    
+    // Unregister types
+    JPH::UnregisterTypes();
+    
+    // Destroy factory
+    delete JPH::Factory::sInstance;
+    JPH::Factory::sInstance = nullptr;
+}
+
+// Build a mesh shape from an OBJ file (Y-up, converted to Z-up)
+static JPH::RefConst<JPH::Shape> buildMeshShape(const std::string& path) {
+    FROGGI_LOG_DEBUG(Physics, "[Collider] Loading mesh collision from: %s", path.c_str());
+    
+    tinyobj::attrib_t attrib;
+    std::vector<tinyobj::shape_t> shapes;
+    std::vector<tinyobj::material_t> materials;
+    std::string warn, err;
+    
+    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, path.c_str())) {
+        FROGGI_LOG_ERROR(Physics, "[Collider] Failed to load mesh: %s", err.c_str());
+        return nullptr;
+    }
+    
+    if (!warn.empty()) {
+        FROGGI_LOG_WARN(Physics, "[Collider] Warning: %s", warn.c_str());
+    }
+    
+    // Convert to Jolt triangle list
+    JPH::TriangleList triangles;
+    
+    for (const auto& objShape : shapes) {
+        size_t index_offset = 0;
+        
+        for (size_t f = 0; f < objShape.mesh.num_face_vertices.size(); f++) {
+            int fv = objShape.mesh.num_face_vertices[f];
+            
+            if (fv == 3) {
+                // Triangle - get the 3 vertices
+                JPH::Float3 v0, v1, v2;
+                
+                for (int v = 0; v < 3; v++) {
+                    tinyobj::index_t idx = objShape.mesh.indices[index_offset + v];
+                    
+                    float vx = attrib.vertices[3 * idx.vertex_index + 0];
+                    float vy = attrib.vertices[3 * idx.vertex_index + 1];
+                    float vz = attrib.vertices[3 * idx.vertex_index + 2];
+                    
+                    // Convert from OBJ coords (Y-up) to game coords (Z-up)
+                    // Y-up to Z-up: (x, y, z) -> (x, -z, y)
+                    if (v == 0) {
+                        v0 = JPH::Float3(vx, -vz, vy);
+                    } else if (v == 1) {
+                        v1 = JPH::Float3(vx, -vz, vy);
+                    } else {
+                        v2 = JPH::Float3(vx, -vz, vy);
+                    }
+                }
+                
+                triangles.push_back(JPH::Triangle(v0, v1, v2));
+            } else if (fv == 4) {
+                // Quad - split into 2 triangles
+                JPH::Float3 v0, v1, v2, v3;
+                
+                for (int v = 0; v < 4; v++) {
+                    tinyobj::index_t idx = objShape.mesh.indices[index_offset + v];
+                    
+                    float vx = attrib.vertices[3 * idx.vertex_index + 0];
+                    float vy = attrib.vertices[3 * idx.vertex_index + 1];
+                    float vz = attrib.vertices[3 * idx.vertex_index + 2];
+                    
+                    JPH::Float3 vert(vx, -vz, vy);
+                    
+                    if (v == 0) v0 = vert;
+                    else if (v == 1) v1 = vert;
+                    else if (v == 2) v2 = vert;
+                    else v3 = vert;
+                }
+                
+                // Split quad into 2 triangles
+                triangles.push_back(JPH::Triangle(v0, v1, v2));
+                triangles.push_back(JPH::Triangle(v0, v2, v3));
+            }
+            
+            index_offset += fv;
+        }
+    }
+    
+    if (triangles.empty()) {
+        FROGGI_LOG_WARN(Physics, "[Collider] No triangles found in mesh, using box");
+        return nullptr;
+    }
+    
+    FROGGI_LOG_DEBUG(Physics, "[Collider] Created mesh with %zu triangles", static_cast<size_t>(triangles.size()));
+    
+    // Create mesh shape
+    JPH::MeshShapeSettings meshSettings(triangles);
+    JPH::ShapeSettings::ShapeResult result = meshSettings.Create();
+    
+    if (result.HasError()) {
+        FROGGI_LOG_ERROR(Physics, "[Collider] Failed to create mesh shape: %s", result.GetError().c_str());
+        return nullptr;
+    }
+    return result.Get();
+}
+
+// Mesh shape for a path, built once per process (nullptr if it can't be loaded)
+static JPH::RefConst<JPH::Shape> loadMeshShape(const std::string& path) {
+    std::lock_guard<std::mutex> lock(joltRuntimeMutex());
+    auto it = s_meshShapes.find(path);
+    if (it != s_meshShapes.end()) return it->second;
+    
+    JPH::RefConst<JPH::Shape> shape = buildMeshShape(path);
+    s_meshShapes.emplace(path, shape);
+    return shape;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -211,6 +405,8 @@ void ContactListenerImpl::OnContactAdded(
     JPH::ContactSettings &ioSettings)
 {
     (void)ioSettings;
+    contactCount.fetch_add(1, std::memory_order_relaxed);
+    metric_contacts.add();
     
     GameObject* obj1 = collisionSystem->getGameObjectFromBodyID(inBody1.GetID());
     GameObject* obj2 = collisionSystem->getGameObjectFromBodyID(inBody2.GetID());
@@ -257,6 +453,8 @@ void ContactListenerImpl::OnContactPersisted(
     JPH::ContactSettings &ioSettings)
 {
     (void)ioSettings;
+    contactCount.fetch_add(1, std::memory_order_relaxed);
+    metric_contacts.add();
     
     GameObject* obj1 = collisionSystem->getGameObjectFromBodyID(inBody1.GetID());
     GameObject* obj2 = collisionSystem->getGameObjectFromBodyID(inBody2.GetID());
@@ -301,35 +499,23 @@ void ContactListenerImpl::OnContactRemoved(const JPH::SubShapeIDPair &inSubShape
 ///////////////////////////////////////////////////////////////////////////////
 // CollisionSystem Implementation
 
-CollisionSystem::CollisionSystem() {
-    // Register allocation hook
-    JPH::RegisterDefaultAllocator();
-    
-    // Install trace and assert callbacks
-    JPH::Trace = TraceImpl;
-    
-    JPH_IF_ENABLE_ASSERTS(JPH::AssertFailed = [](const char* inExpression, const char* inMessage, const char* inFile, uint inLine) {
-        std::cout << inFile << ":" << inLine << ": (" << inExpression << ") " << (inMessage != nullptr ? inMessage : "") << std::endl;
-        return true;
-    };)
-    
-    // Create factory
-    JPH::Factory::sInstance = new JPH::Factory();
-    
-    // Register all Jolt physics types
-    JPH::RegisterTypes();
+CollisionSystem::CollisionSystem(int jobThreads) : jobThreadsOverride(jobThreads) {
+    acquireJoltRuntime();
     
     // Create temp allocator
-    tempAllocator = std::make_unique<JPH::TempAllocatorImpl>(10 * 1024 * 1024);
+    tempAllocator = std::make_unique<JPH::TempAllocatorImpl>(cv_tempAllocatorMB.get() * 1024 * 1024);
+    tempAllocatorVersion = cv_tempAllocatorMB.version();
     
     // Create job system
-    jobSystem = std::make_unique<JPH::JobSystemThreadPool>(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers, 4);
+    jobSystem = std::make_unique<JPH::JobSystemThreadPool>(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers,
+        jobThreadsOverride != kJobThreadsFromCVar ? jobThreadsOverride : cv_jobThreads.get());
+    jobThreadsVersion = cv_jobThreads.version();
     
     // Create physics system
-    const uint cMaxBodies = 1024;
+    const uint cMaxBodies = static_cast<uint>(cv_maxBodies.get());
     const uint cNumBodyMutexes = 0; // Auto-detect
-    const uint cMaxBodyPairs = 1024;
-    const uint cMaxContactConstraints = 1024;
+    const uint cMaxBodyPairs = static_cast<uint>(cv_maxBodyPairs.get());
+    const uint cMaxContactConstraints = static_cast<uint>(cv_maxContactConstraints.get());
     
     physicsSystem = std::make_unique<JPH::PhysicsSystem>();
     physicsSystem->Init(
@@ -372,12 +558,7 @@ CollisionSystem::~CollisionSystem() {
         tempAllocator.reset();
     }
     
-    // Unregister types
-    JPH::UnregisterTypes();
-    
-    // Destroy factory
-    delete JPH::Factory::sInstance;
-    JPH::Factory::sInstance = nullptr;
+    releaseJoltRuntime();
 }
 
 void CollisionSystem::initialize(Scene* scene) {
@@ -401,7 +582,7 @@ void CollisionSystem::initialize(Scene* scene) {
         }
     }
     
-    std::cout << "[CollisionSystem] Initialized with " << colliders.size() << " colliders using Jolt Physics" << std::endl;
+    FROGGI_LOG_INFO(Physics, "[CollisionSystem] Initialized with %zu colliders using Jolt Physics", colliders.size());
 }
 
 JPH::BodyID CollisionSystem::createBody(Collider* collider, Rigidbody* rigidbody) {
@@ -421,106 +602,14 @@ JPH::BodyID CollisionSystem::createBody(Collider* collider, Rigidbody* rigidbody
             break;
       case CollisionShapeType::Mesh: {
             if (collider->meshPath.empty()) {
-                std::cerr << "[Collider] Mesh path not set, using box" << std::endl;
+                FROGGI_LOG_WARN(Physics, "[Collider] Mesh path not set, using box");
                 shape = new JPH::BoxShape(toJoltVec3(collider->size * 0.5f));
                 break;
             }
             
-            // Load OBJ file
-            std::cout << "[Collider] Loading mesh collision from: " << collider->meshPath << std::endl;
-            
-            tinyobj::attrib_t attrib;
-            std::vector<tinyobj::shape_t> shapes;
-            std::vector<tinyobj::material_t> materials;
-            std::string warn, err;
-            
-            if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, collider->meshPath.c_str())) {
-                std::cerr << "[Collider] Failed to load mesh: " << err << std::endl;
+            shape = loadMeshShape(collider->meshPath);
+            if (shape == nullptr) {
                 shape = new JPH::BoxShape(toJoltVec3(collider->size * 0.5f));
-                break;
-            }
-            
-            if (!warn.empty()) {
-                std::cout << "[Collider] Warning: " << warn << std::endl;
-            }
-            
-            // Convert to Jolt triangle list
-            JPH::TriangleList triangles;
-            
-            for (const auto& objShape : shapes) {
-                size_t index_offset = 0;
-                
-                for (size_t f = 0; f < objShape.mesh.num_face_vertices.size(); f++) {
-                    int fv = objShape.mesh.num_face_vertices[f];
-                    
-                    if (fv == 3) {
-                        // Triangle - get the 3 vertices
-                        JPH::Float3 v0, v1, v2;
-                        
-                        for (int v = 0; v < 3; v++) {
-                            tinyobj::index_t idx = objShape.mesh.indices[index_offset + v];
-                            
-                            float vx = attrib.vertices[3 * idx.vertex_index + 0];
-                            float vy = attrib.vertices[3 * idx.vertex_index + 1];
-                            float vz = attrib.vertices[3 * idx.vertex_index + 2];
-                            
-                            // Convert from OBJ coords (Y-up) to game coords (Z-up)
-                            // Y-up to Z-up: (x, y, z) -> (x, -z, y)
-                            if (v == 0) {
-                                v0 = JPH::Float3(vx, -vz, vy);
-                            } else if (v == 1) {
-                                v1 = JPH::Float3(vx, -vz, vy);
-                            } else {
-                                v2 = JPH::Float3(vx, -vz, vy);
-                            }
-                        }
-                        
-                        triangles.push_back(JPH::Triangle(v0, v1, v2));
-                    } else if (fv == 4) {
-                        // Quad - split into 2 triangles
-                        JPH::Float3 v0, v1, v2, v3;
-                        
-                        for (int v = 0; v < 4; v++) {
-                            tinyobj::index_t idx = objShape.mesh.indices[index_offset + v];
-                            
-                            float vx = attrib.vertices[3 * idx.vertex_index + 0];
-                            float vy = attrib.vertices[3 * idx.vertex_index + 1];
-                            float vz = attrib.vertices[3 * idx.vertex_index + 2];
-                            
-                            JPH::Float3 vert(vx, -vz, vy);
-                            
-                            if (v == 0) v0 = vert;
-                            else if (v == 1) v1 = vert;
-                            else if (v == 2) v2 = vert;
-                            else v3 = vert;
-                        }
-                        
-                        // Split quad into 2 triangles
-                        triangles.push_back(JPH::Triangle(v0, v1, v2));
-                        triangles.push_back(JPH::Triangle(v0, v2, v3));
-                    }
-                    
-                    index_offset += fv;
-                }
-            }
-            
-            if (triangles.empty()) {
-                std::cerr << "[Collider] No triangles found in mesh, using box" << std::endl;
-                shape = new JPH::BoxShape(toJoltVec3(collider->size * 0.5f));
-                break;
-            }
-            
-            std::cout << "[Collider] Created mesh with " << triangles.size() << " triangles" << std::endl;
-            
-            // Create mesh shape
-            JPH::MeshShapeSettings meshSettings(triangles);
-            JPH::ShapeSettings::ShapeResult result = meshSettings.Create();
-            
-            if (result.HasError()) {
-                std::cerr << "[Collider] Failed to create mesh shape: " << result.GetError() << std::endl;
-                shape = new JPH::BoxShape(toJoltVec3(collider->size * 0.5f));
-            } else {
-                shape = result.Get();
             }
             break;
         }
@@ -532,13 +621,13 @@ JPH::BodyID CollisionSystem::createBody(Collider* collider, Rigidbody* rigidbody
     if (!rigidbody) {
         // No rigidbody component = completely static (like ground)
         motionType = JPH::EMotionType::Static;
-        std::cout << "[CollisionSystem] Creating STATIC body for: " << collider->owner->name << std::endl;
+        FROGGI_LOG_DEBUG(Physics, "[CollisionSystem] Creating STATIC body for: %s", collider->owner->name.c_str());
     } else if (rigidbody->isKinematic) {
         motionType = JPH::EMotionType::Kinematic;
-        std::cout << "[CollisionSystem] Creating KINEMATIC body for: " << collider->owner->name << std::endl;
+        FROGGI_LOG_DEBUG(Physics, "[CollisionSystem] Creating KINEMATIC body for: %s", collider->owner->name.c_str());
     } else {
         motionType = JPH::EMotionType::Dynamic;
-        std::cout << "[CollisionSystem] Creating DYNAMIC body for: " << collider->owner->name << std::endl;
+        FROGGI_LOG_DEBUG(Physics, "[CollisionSystem] Creating DYNAMIC body for: %s", collider->owner->name.c_str());
     }
     
     // Determine object layer
@@ -589,7 +678,7 @@ JPH::BodyID CollisionSystem::createBody(Collider* collider, Rigidbody* rigidbody
     // Create body
     JPH::Body* body = physicsSystem->GetBodyInterface().CreateBody(bodySettings);
     if (!body) {
-        std::cerr << "[CollisionSystem] Failed to create body for " << collider->owner->name << "!" << std::endl;
+        FROGGI_LOG_ERROR(Physics, "[CollisionSystem] Failed to create body for %s!", collider->owner->name.c_str());
         return JPH::BodyID();
     }
     
@@ -600,8 +689,8 @@ JPH::BodyID CollisionSystem::createBody(Collider* collider, Rigidbody* rigidbody
     
     physicsSystem->GetBodyInterface().AddBody(body->GetID(), activation);
     
-    std::cout << "[CollisionSystem] Body created successfully for " << collider->owner->name 
-              << " (ID: " << body->GetID().GetIndex() << ")" << std::endl;
+    FROGGI_LOG_DEBUG(Physics, "[CollisionSystem] Body created successfully for %s (ID: %u)",
+                     collider->owner->name.c_str(), body->GetID().GetIndex());
     
     return body->GetID();
 }
@@ -609,6 +698,10 @@ JPH::BodyID CollisionSystem::createBody(Collider* collider, Rigidbody* rigidbody
 void CollisionSystem::update(Scene* scene, float deltaTime) {
     if (!scene) return;
     
+    // Contacts of the previous step feed the step governor
+    uint32_t lastContacts = contactListener->getContactCount();
+    contactListener->resetContactCount();
+    
     // Reset grounded state
     for (auto* component : scene->components) {
         Rigidbody* rb = dynamic_cast<Rigidbody*>(component);
@@ -618,6 +711,7 @@ void CollisionSystem::update(Scene* scene, float deltaTime) {
     }
     
     // Update Jolt body transforms from GameObjects (for kinematic/updated objects)
+    float maxTravel = 0.0f;
     for (auto* collider : colliders) {
         if (!collider->enabled || !collider->owner->active) continue;
         
@@ -641,6 +735,13 @@ void CollisionSystem::update(Scene* scene, float deltaTime) {
             JPH::Vec3 currentJoltVel = physicsSystem->GetBodyInterface().GetLinearVelocity(collider->bodyID);
             glm::vec3 currentVel = toGlm(currentJoltVel);
             
+            // Fastest body relative to its size decides how many steps avoid tunneling
+            float thickness = colliderThickness(collider);
+            if (thickness > 0.0f) {
+                float speed = std::max(glm::length(currentVel), glm::length(rb->velocity));
+                maxTravel = std::max(maxTravel, speed * deltaTime / thickness);
+            }
+            
             // Only apply if velocity was changed from outside (player controller)
             if (glm::length(rb->velocity - currentVel) > 0.01f) {
                 // Velocity was set by game code - apply it
@@ -661,14 +762,61 @@ void CollisionSystem::update(Scene* scene, float deltaTime) {
         }
     }
     
-    // Step physics simulation - INCREASE COLLISION STEPS
-    const int collisionSteps = 4;  // Changed from 1 to 4
+    // Step physics simulation
+    applyCVarChanges();
+    const int collisionSteps = chooseCollisionSteps(maxTravel, lastContacts);
+    auto stepStart = std::chrono::steady_clock::now();
     physicsSystem->Update(deltaTime, collisionSteps, tempAllocator.get(), jobSystem.get());
+    float stepMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - stepStart).count();
+    
+    // Smoothed cost of one collision step, for the budget limit
+    float msPerStep = stepMs / static_cast<float>(collisionSteps);
+    stepCostMs = stepCostMs > 0.0f ? stepCostMs + (msPerStep - stepCostMs) * 0.1f : msPerStep;
+    stepDecision.msPerStep = stepCostMs;
+    
+    metric_collisionSteps.set(collisionSteps);
+    metric_bodies.set(getBodyCount());
+    metric_activeBodies.set(getActiveBodyCount());
     
     // Sync Jolt transforms back to GameObjects
     syncJoltToGameObjects();
 }
 
+int CollisionSystem::chooseCollisionSteps(float maxTravel, uint32_t contacts) {
+    CollisionStepDecision decision;
+    decision.maxTravel = maxTravel;
+    decision.contacts = contacts;
+    decision.msPerStep = stepCostMs;
+    
+    if (!cv_adaptiveSteps.get()) {
+        decision.steps = cv_collisionSteps.get();
+        stepDecision = decision;
+        return decision.steps;
+    }
+    
+    int minSteps = cv_minCollisionSteps.get();
+    int maxSteps = std::max(minSteps, cv_maxCollisionSteps.get());
+    
+    // Enough steps that no body moves more than p.maxStepTravel of its thickness per step
+    decision.speedSteps = static_cast<int>(std::ceil(maxTravel / cv_maxStepTravel.get()));
+    
+    // Crowded contact graphs (stacks, piles) settle better with more steps
+    int contactsPerStep = cv_contactsPerStep.get();
+    decision.contactSteps = contactsPerStep > 0 ? 1 + static_cast<int>(contacts) / contactsPerStep : 1;
+    
+    // Contact steps are only worth it while they fit the budget; speed steps
+    // are kept regardless, since missing them lets bodies pass through walls
+    int wanted = decision.contactSteps;
+    if (stepBudgetMs >= 0.0f && stepCostMs > 0.0f) {
+        decision.budgetSteps = std::max(1, static_cast<int>(stepBudgetMs / stepCostMs));
+        wanted = std::min(wanted, decision.budgetSteps);
+    }
+    
+    decision.steps = std::clamp(std::max(decision.speedSteps, wanted), minSteps, maxSteps);
+    stepDecision = decision;
+    return decision.steps;
+}
+
 void CollisionSystem::syncJoltToGameObjects() {
     JPH::BodyInterface& bodyInterface = physicsSystem->GetBodyInterface();
     
@@ -697,6 +845,34 @@ GameObject* CollisionSystem::getGameObjectFromBodyID(JPH::BodyID bodyID) {
     return nullptr;
 }
 
+void CollisionSystem::applyCVarChanges() {
+    // Safe here: no physics jobs are in flight between updates
+    // An engine that chose its own thread count keeps it
+    if (jobThreadsOverride == kJobThreadsFromCVar && cv_jobThreads.version() != jobThreadsVersion) {
+        jobThreadsVersion = cv_jobThreads.version();
+        jobSystem->SetNumThreads(cv_jobThreads.get());
+        FROGGI_LOG_INFO(Physics, "[CollisionSystem] Job threads set to %d", cv_jobThreads.get());
+    }
+    
+    if (cv_tempAllocatorMB.version() != tempAllocatorVersion) {
+        tempAllocatorVersion = cv_tempAllocatorMB.version();
+        tempAllocator = std::make_unique<JPH::TempAllocatorImpl>(cv_tempAllocatorMB.get() * 1024 * 1024);
+        FROGGI_LOG_INFO(Physics, "[CollisionSystem] Temp allocator resized to %dMB", cv_tempAllocatorMB.get());
+    }
+}
+
+uint32_t CollisionSystem::getBodyCount() const {
+    return physicsSystem ? physicsSystem->GetNumBodies() : 0;
+}
+
+uint32_t CollisionSystem::getActiveBodyCount() const {
+    return physicsSystem ? physicsSystem->GetNumActiveBodies(JPH::EBodyType::RigidBody) : 0;
+}
+
+uint32_t CollisionSystem::getContactCount() const {
+    return contactListener ? contactListener->getContactCount() : 0;
+}
+
 std::vector<CollisionResult> CollisionSystem::overlapBox(
     const glm::vec3& center, const glm::vec3& halfExtents, uint32_t layerMask) 
 {
@@ -802,7 +978,7 @@ void CollisionSystem::drawDebugShapes() {
     // ═══════════════════════════════════════════════════════════════
     
     if (!m_staticLinesCached) {
-        std::cout << "[CollisionSystem] Generating static mesh cache..." << std::endl;
+        FROGGI_LOG_DEBUG(Physics, "[CollisionSystem] Generating static mesh cache...");
         
         // Draw all static mesh shapes and cache the lines
         for (const auto& pair : bodyToGameObject) {
@@ -819,7 +995,7 @@ void CollisionSystem::drawDebugShapes() {
                 
                 // Only cache mesh shapes
                 if (shape->GetType() == JPH::EShapeType::Mesh) {
-                    std::cout << "[CollisionSystem]   Caching mesh triangles..." << std::endl;
+                    FROGGI_LOG_DEBUG(Physics, "[CollisionSystem]   Caching mesh triangles...");
                     
                     const JPH::MeshShape* meshShape = static_cast<const JPH::MeshShape*>(shape);
                     
@@ -860,7 +1036,7 @@ void CollisionSystem::drawDebugShapes() {
                         }
                     }
                     
-                    std::cout << "[CollisionSystem]   Cached " << triangleCount << " triangles" << std::endl;
+                    FROGGI_LOG_DEBUG(Physics, "[CollisionSystem]   Cached %d triangles", triangleCount);
                 }
             }
         }
@@ -869,7 +1045,7 @@ void CollisionSystem::drawDebugShapes() {
         m_cachedStaticLines = m_debugRenderer->getLines();
         m_staticLinesCached = true;
         
-        std::cout << "[CollisionSystem] Static cache created: " << m_cachedStaticLines.size() << " lines" << std::endl;
+        FROGGI_LOG_DEBUG(Physics, "[CollisionSystem] Static cache created: %zu lines", m_cachedStaticLines.size());
         
         // Clear for dynamic rendering
         m_debugRenderer->clear();
@@ -22,6 +22,7 @@
 #include "jolt_debug_renderer.h"
 
 #include <glm/glm.hpp>
+#include <atomic>
 #include <memory>
 #include <vector>
 #include <unordered_map>
@@ -176,16 +177,44 @@ public:
     virtual void OnContactRemoved(
         const JPH::SubShapeIDPair &inSubShapePair) override;
     
+    // Contacts added/persisted since the last reset (called from Jolt worker threads)
+    void resetContactCount() { contactCount.store(0, std::memory_order_relaxed); }
+    uint32_t getContactCount() const { return contactCount.load(std::memory_order_relaxed); }
+    
 private:
     CollisionSystem* collisionSystem = nullptr;
+    std::atomic<uint32_t> contactCount{0};
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Collision Step Decision - How the governor picked the last step count
+
+struct CollisionStepDecision {
+    int steps = 1;              // collision steps used
+    int speedSteps = 0;         // needed to keep the fastest body from tunneling
+    int contactSteps = 1;       // wanted for the previous step's contact count
+    int budgetSteps = 0;        // most steps the budget allowed (0 = no budget)
+    float maxTravel = 0.0f;     // fastest body's travel per fixed step / its thickness
+    uint32_t contacts = 0;
+    float msPerStep = 0.0f;     // smoothed cost of one collision step
 };
 
 ///////////////////////////////////////////////////////////////////////////////
 // Collision System (manages all collision detection)
+//
+// One per scene; several can run on different threads at once (the Jolt
+// type registry and collision meshes are shared between them).
 
 class CollisionSystem {
 public:
-    CollisionSystem();
+    static constexpr int kJobThreadsFromCVar = -2;
+    
+    /**
+     * @param jobThreads Physics worker threads (kJobThreadsFromCVar = follow
+     *                   p.jobThreads, -1 = hardware threads - 1, 0 = run jobs
+     *                   on the thread calling update())
+     */
+    explicit CollisionSystem(int jobThreads = kJobThreadsFromCVar);
     ~CollisionSystem();
     
     // Initialize/update collision world
@@ -217,6 +246,23 @@ public:
     
     JPH::PhysicsSystem* getPhysicsSystem() { return physicsSystem.get(); }
     
+    /**
+     * Time the next update() may spend on collision steps beyond the ones
+     * needed against tunneling (negative = unlimited). Engine sets it before
+     * each fixed step from what is left of p.budgetMs.
+     */
+    void setStepBudget(float milliseconds) { stepBudgetMs = milliseconds; }
+    
+    /**
+     * Collision step count chosen for the last update() and why
+     */
+    const CollisionStepDecision& getStepDecision() const { return stepDecision; }
+    
+    // Stats (for the frame profiler)
+    uint32_t getBodyCount() const;
+    uint32_t getActiveBodyCount() const;
+    uint32_t getContactCount() const;
+    
 private:
     std::vector<JoltDebugRenderer::DebugLine> m_cachedStaticLines;
     bool m_staticLinesCached = false;
@@ -239,6 +285,18 @@ private:
     JPH::BodyID createBody(Collider* collider, Rigidbody* rigidbody);
     void updateRigidbodies(Scene* scene, float deltaTime);
     void syncJoltToGameObjects();
+    void applyCVarChanges();
+    int chooseCollisionSteps(float maxTravel, uint32_t contacts);
+    
+    // CVar versions last applied
+    int jobThreadsOverride = kJobThreadsFromCVar;
+    uint32_t jobThreadsVersion = 0;
+    uint32_t tempAllocatorVersion = 0;
+    
+    // Collision step governor
+    float stepBudgetMs = -1.0f;
+    float stepCostMs = 0.0f;
+    CollisionStepDecision stepDecision;
     
     static JPH::ObjectLayer getObjectLayer(uint32_t collisionLayer);
     static JPH::BroadPhaseLayer getBroadPhaseLayer(JPH::ObjectLayer layer);
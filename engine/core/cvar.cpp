@@ -0,0 +1,507 @@
+#include "cvar.h"
+#include "log.h"
+#include <imgui.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+
+namespace froggi {
+
+namespace {
+
+// Function-local statics: AutoCVars register during static initialization
+std::map<std::string, std::unique_ptr<CVar>>& registry() {
+    static std::map<std::string, std::unique_ptr<CVar>> cvars;
+    return cvars;
+}
+
+constexpr size_t kConsoleLogLines = 256;
+std::deque<std::string> g_consoleLog;
+bool g_consoleVisible = false;
+char g_consoleInput[256] = {};
+char g_consoleFilter[64] = {};
+
+void consolePrint(const std::string& line) {
+    FROGGI_LOG_INFO(Engine, "[CVar] %s", line.c_str());
+    g_consoleLog.push_back(line);
+    while (g_consoleLog.size() > kConsoleLogLines) {
+        g_consoleLog.pop_front();
+    }
+}
+
+std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) return "";
+    size_t end = text.find_last_not_of(" \t\r\n");
+    return text.substr(begin, end - begin + 1);
+}
+
+// Split "name rest of line" at the first whitespace
+void splitFirst(const std::string& line, std::string& head, std::string& rest) {
+    std::string trimmed = trim(line);
+    size_t space = trimmed.find_first_of(" \t");
+    if (space == std::string::npos) {
+        head = trimmed;
+        rest.clear();
+    } else {
+        head = trimmed.substr(0, space);
+        rest = trim(trimmed.substr(space + 1));
+    }
+    // Allow quoted string values
+    if (rest.size() >= 2 && rest.front() == '"' && rest.back() == '"') {
+        rest = rest.substr(1, rest.size() - 2);
+    }
+}
+
+const char* typeName(CVarType type) {
+    switch (type) {
+        case CVarType::Bool:   return "bool";
+        case CVarType::Int:    return "int";
+        case CVarType::Float:  return "float";
+        case CVarType::String: return "string";
+    }
+    return "?";
+}
+
+bool setInternal(CVar* cvar, const std::string& value, bool allowReadOnly) {
+    if (!cvar) return false;
+    if (!allowReadOnly && (cvar->getFlags() & CVarFlag_ReadOnly)) {
+        consolePrint(cvar->getName() + " is read-only");
+        return false;
+    }
+    if (!cvar->setFromString(value)) {
+        consolePrint("invalid " + std::string(typeName(cvar->getType())) + " value '" + value +
+                     "' for " + cvar->getName());
+        return false;
+    }
+    if (cvar->getFlags() & CVarFlag_Restart) {
+        consolePrint(cvar->getName() + " = " + cvar->toString() + " (applies on restart / scene load)");
+    }
+    return true;
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// CVar Implementation
+
+CVar::CVar(const std::string& n, const std::string& desc, CVarType t, uint32_t f)
+    : name(n), description(desc), type(t), flags(f) {}
+
+void CVar::setBool(bool value) {
+    int v = value ? 1 : 0;
+    if (intValue == v) return;
+    intValue = v;
+    version++;
+}
+
+void CVar::setInt(int value) {
+    if (minValue != maxValue) {
+        value = std::clamp(value, static_cast<int>(minValue), static_cast<int>(maxValue));
+    }
+    if (intValue == value) return;
+    intValue = value;
+    version++;
+}
+
+void CVar::setFloat(float value) {
+    if (minValue != maxValue) {
+        value = std::clamp(value, minValue, maxValue);
+    }
+    if (floatValue == value) return;
+    floatValue = value;
+    version++;
+}
+
+void CVar::setString(const std::string& value) {
+    if (stringValue == value) return;
+    stringValue = value;
+    version++;
+}
+
+bool CVar::setFromString(const std::string& text) {
+    std::string value = trim(text);
+    switch (type) {
+        case CVarType::Bool: {
+            if (value == "1" || value == "true" || value == "on" || value == "yes") { setBool(true); return true; }
+            if (value == "0" || value == "false" || value == "off" || value == "no") { setBool(false); return true; }
+            return false;
+        }
+        case CVarType::Int: {
+            char* end = nullptr;
+            errno = 0;
+            long parsed = std::strtol(value.c_str(), &end, 10);
+            if (value.empty() || *end != '\0' || errno == ERANGE) return false;
+            setInt(static_cast<int>(parsed));
+            return true;
+        }
+        case CVarType::Float: {
+            char* end = nullptr;
+            errno = 0;
+            float parsed = std::strtof(value.c_str(), &end);
+            if (value.empty() || *end != '\0' || errno == ERANGE) return false;
+            setFloat(parsed);
+            return true;
+        }
+        case CVarType::String:
+            setString(value);
+            return true;
+    }
+    return false;
+}
+
+std::string CVar::toString() const {
+    switch (type) {
+        case CVarType::Bool:   return intValue ? "1" : "0";
+        case CVarType::Int:    return std::to_string(intValue);
+        case CVarType::Float: {
+            std::ostringstream out;
+            out << floatValue;
+            return out.str();
+        }
+        case CVarType::String: return stringValue;
+    }
+    return "";
+}
+
+void CVar::setRange(float minV, float maxV) {
+    minValue = minV;
+    maxValue = maxV;
+}
+
+void CVar::setDefaultFromCurrent() {
+    defaultInt = intValue;
+    defaultFloat = floatValue;
+    defaultString = stringValue;
+}
+
+void CVar::reset() {
+    switch (type) {
+        case CVarType::Bool:   setBool(defaultInt != 0); break;
+        case CVarType::Int:    setInt(defaultInt); break;
+        case CVarType::Float:  setFloat(defaultFloat); break;
+        case CVarType::String: setString(defaultString); break;
+    }
+}
+
+bool CVar::isDefault() const {
+    switch (type) {
+        case CVarType::Bool:
+        case CVarType::Int:    return intValue == defaultInt;
+        case CVarType::Float:  return floatValue == defaultFloat;
+        case CVarType::String: return stringValue == defaultString;
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// CVarRegistry Implementation
+
+CVar* CVarRegistry::registerCVar(const std::string& name, const std::string& description,
+                                 CVarType type, uint32_t flags) {
+    auto& cvars = registry();
+    auto it = cvars.find(name);
+    if (it != cvars.end()) {
+        if (it->second->getType() != type) {
+            FROGGI_LOG_WARN(Engine, "[CVar] %s registered twice with different types", name.c_str());
+        }
+        return it->second.get();
+    }
+    auto cvar = std::make_unique<CVar>(name, description, type, flags);
+    CVar* result = cvar.get();
+    cvars.emplace(name, std::move(cvar));
+    return result;
+}
+
+CVar* CVarRegistry::find(const std::string& name) {
+    auto& cvars = registry();
+    auto it = cvars.find(name);
+    return it != cvars.end() ? it->second.get() : nullptr;
+}
+
+bool CVarRegistry::set(const std::string& name, const std::string& value) {
+    CVar* cvar = find(name);
+    if (!cvar) {
+        consolePrint("unknown cvar '" + name + "'");
+        return false;
+    }
+    return setInternal(cvar, value, false);
+}
+
+std::vector<CVar*> CVarRegistry::getAll() {
+    std::vector<CVar*> result;
+    for (auto& entry : registry()) {
+        result.push_back(entry.second.get());
+    }
+    return result;
+}
+
+void CVarRegistry::init(int argc, char** argv, const std::string& configPath) {
+    std::string config = configPath;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--config=", 0) == 0) {
+            config = arg.substr(9);
+        }
+    }
+    loadConfig(config);
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--config=", 0) == 0) continue;
+
+        if (arg.rfind("--", 0) == 0) {
+            size_t equals = arg.find('=');
+            if (equals == std::string::npos) {
+                // Bare "--flag" turns a bool on
+                CVar* cvar = find(arg.substr(2));
+                if (cvar && cvar->getType() == CVarType::Bool) {
+                    setInternal(cvar, "1", true);
+                } else {
+                    consolePrint("ignoring argument '" + arg + "'");
+                }
+                continue;
+            }
+            CVar* cvar = find(arg.substr(2, equals - 2));
+            if (cvar) {
+                setInternal(cvar, arg.substr(equals + 1), true);
+            } else {
+                consolePrint("unknown cvar '" + arg.substr(2, equals - 2) + "'");
+            }
+        } else if (arg.size() > 1 && arg[0] == '+' && i + 1 < argc) {
+            CVar* cvar = find(arg.substr(1));
+            if (cvar) {
+                setInternal(cvar, argv[++i], true);
+            } else {
+                consolePrint("unknown cvar '" + arg.substr(1) + "'");
+                ++i;
+            }
+        }
+    }
+}
+
+bool CVarRegistry::loadConfig(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) return false;
+
+    std::string line;
+    int applied = 0;
+    while (std::getline(file, line)) {
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) line = line.substr(0, comment);
+
+        std::string name, value;
+        splitFirst(line, name, value);
+        if (name.empty()) continue;
+
+        CVar* cvar = find(name);
+        if (!cvar) {
+            consolePrint(path + ": unknown cvar '" + name + "'");
+            continue;
+        }
+        if (setInternal(cvar, value, true)) applied++;
+    }
+
+    consolePrint("loaded " + std::to_string(applied) + " values from " + path);
+    return true;
+}
+
+bool CVarRegistry::saveConfig(const std::string& path) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        consolePrint("could not write " + path);
+        return false;
+    }
+
+    file << "# _froggi config - name value\n";
+    for (auto& entry : registry()) {
+        const CVar& cvar = *entry.second;
+        if (cvar.getFlags() & CVarFlag_NoSave) continue;
+        file << "\n# " << cvar.getDescription() << "\n";
+        if (cvar.getType() == CVarType::String) {
+            file << cvar.getName() << " \"" << cvar.toString() << "\"\n";
+        } else {
+            file << cvar.getName() << " " << cvar.toString() << "\n";
+        }
+    }
+
+    consolePrint("saved config to " + path);
+    return true;
+}
+
+void CVarRegistry::execute(const std::string& line) {
+    std::string command, args;
+    splitFirst(line, command, args);
+    if (command.empty()) return;
+
+    consolePrint("> " + trim(line));
+
+    if (command == "list") {
+        for (auto& entry : registry()) {
+            const CVar& cvar = *entry.second;
+            if (!args.empty() && cvar.getName().rfind(args, 0) != 0) continue;
+            consolePrint("  " + cvar.getName() + " = " + cvar.toString() + "  (" +
+                         typeName(cvar.getType()) + ") " + cvar.getDescription());
+        }
+        return;
+    }
+    if (command == "save") {
+        saveConfig(args.empty() ? "froggi.cfg" : args);
+        return;
+    }
+    if (command == "load") {
+        if (!loadConfig(args.empty() ? "froggi.cfg" : args)) {
+            consolePrint("could not read " + (args.empty() ? std::string("froggi.cfg") : args));
+        }
+        return;
+    }
+    if (command == "reset") {
+        CVar* cvar = find(args);
+        if (!cvar) {
+            consolePrint("unknown cvar '" + args + "'");
+            return;
+        }
+        cvar->reset();
+        consolePrint(cvar->getName() + " = " + cvar->toString());
+        return;
+    }
+    if (command == "help") {
+        consolePrint("name [value] | reset name | list [prefix] | save [path] | load [path]");
+        return;
+    }
+
+    CVar* cvar = find(command);
+    if (!cvar) {
+        consolePrint("unknown command or cvar '" + command + "'");
+        return;
+    }
+    if (!args.empty()) {
+        if (!setInternal(cvar, args, false)) return;
+    }
+    consolePrint(cvar->getName() + " = " + cvar->toString());
+}
+
+void CVarRegistry::setConsoleVisible(bool visible) {
+    g_consoleVisible = visible;
+}
+
+void CVarRegistry::toggleConsole() {
+    g_consoleVisible = !g_consoleVisible;
+}
+
+void CVarRegistry::drawConsole() {
+    if (!g_consoleVisible) return;
+
+    if (!ImGui::Begin("Console", &g_consoleVisible)) {
+        ImGui::End();
+        return;
+    }
+
+    // Editable variable list
+    ImGui::InputText("Filter", g_consoleFilter, sizeof(g_consoleFilter));
+    if (ImGui::BeginChild("cvars", ImVec2(0, 160), true)) {
+        for (auto& entry : registry()) {
+            CVar& cvar = *entry.second;
+            if (g_consoleFilter[0] && cvar.getName().find(g_consoleFilter) == std::string::npos) continue;
+
+            ImGui::PushID(&cvar);
+            bool readOnly = (cvar.getFlags() & CVarFlag_ReadOnly) != 0;
+            ImGui::BeginDisabled(readOnly);
+            switch (cvar.getType()) {
+                case CVarType::Bool: {
+                    bool value = cvar.getBool();
+                    if (ImGui::Checkbox(cvar.getName().c_str(), &value)) cvar.setBool(value);
+                    break;
+                }
+                case CVarType::Int: {
+                    int value = cvar.getInt();
+                    bool changed = cvar.getMin() != cvar.getMax()
+                        ? ImGui::SliderInt(cvar.getName().c_str(), &value,
+                                           static_cast<int>(cvar.getMin()), static_cast<int>(cvar.getMax()))
+                        : ImGui::InputInt(cvar.getName().c_str(), &value);
+                    if (changed) cvar.setInt(value);
+                    break;
+                }
+                case CVarType::Float: {
+                    float value = cvar.getFloat();
+                    bool changed = cvar.getMin() != cvar.getMax()
+                        ? ImGui::SliderFloat(cvar.getName().c_str(), &value, cvar.getMin(), cvar.getMax())
+                        : ImGui::InputFloat(cvar.getName().c_str(), &value);
+                    if (changed) cvar.setFloat(value);
+                    break;
+                }
+                case CVarType::String:
+                    ImGui::Text("%s = \"%s\"", cvar.getName().c_str(), cvar.getString().c_str());
+                    break;
+            }
+            ImGui::EndDisabled();
+            if (ImGui::IsItemHovered()) {
+                ImGui::SetTooltip("%s%s", cvar.getDescription().c_str(),
+                                  (cvar.getFlags() & CVarFlag_Restart) ? " (applies on restart)" : "");
+            }
+            ImGui::PopID();
+        }
+    }
+    ImGui::EndChild();
+
+    // Log
+    float footer = ImGui::GetStyle().ItemSpacing.y + ImGui::GetFrameHeightWithSpacing();
+    if (ImGui::BeginChild("log", ImVec2(0, -footer), true)) {
+        for (const std::string& line : g_consoleLog) {
+            ImGui::TextUnformatted(line.c_str());
+        }
+        if (ImGui::GetScrollY() >= ImGui::GetScrollMaxY()) {
+            ImGui::SetScrollHereY(1.0f);
+        }
+    }
+    ImGui::EndChild();
+
+    // Command line
+    if (ImGui::InputText("##command", g_consoleInput, sizeof(g_consoleInput),
+                         ImGuiInputTextFlags_EnterReturnsTrue)) {
+        execute(g_consoleInput);
+        g_consoleInput[0] = '\0';
+        ImGui::SetKeyboardFocusHere(-1);
+    }
+
+    ImGui::End();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Typed Handles
+
+AutoCVarBool::AutoCVarBool(const char* name, const char* description, bool defaultValue, uint32_t flags) {
+    cvar = CVarRegistry::registerCVar(name, description, CVarType::Bool, flags);
+    cvar->setBool(defaultValue);
+    cvar->setDefaultFromCurrent();
+}
+
+AutoCVarInt::AutoCVarInt(const char* name, const char* description, int defaultValue,
+                         int minValue, int maxValue, uint32_t flags) {
+    cvar = CVarRegistry::registerCVar(name, description, CVarType::Int, flags);
+    cvar->setRange(static_cast<float>(minValue), static_cast<float>(maxValue));
+    cvar->setInt(defaultValue);
+    cvar->setDefaultFromCurrent();
+}
+
+AutoCVarFloat::AutoCVarFloat(const char* name, const char* description, float defaultValue,
+                             float minValue, float maxValue, uint32_t flags) {
+    cvar = CVarRegistry::registerCVar(name, description, CVarType::Float, flags);
+    cvar->setRange(minValue, maxValue);
+    cvar->setFloat(defaultValue);
+    cvar->setDefaultFromCurrent();
+}
+
+AutoCVarString::AutoCVarString(const char* name, const char* description, const char* defaultValue,
+                               uint32_t flags) {
+    cvar = CVarRegistry::registerCVar(name, description, CVarType::String, flags);
+    cvar->setString(defaultValue);
+    cvar->setDefaultFromCurrent();
+}
+
+} // namespace froggi
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace froggi {
+
+///////////////////////////////////////////////////////////////////////////////
+// CVar - Named, typed runtime setting
+
+enum class CVarType : uint8_t {
+    Bool,
+    Int,
+    Float,
+    String
+};
+
+enum CVarFlags : uint32_t {
+    CVarFlag_None = 0,
+    CVarFlag_ReadOnly = 1 << 0,     // only settable from config file / command line
+    CVarFlag_Restart = 1 << 1,      // read once at init or scene load
+    CVarFlag_NoSave = 1 << 2        // not written by CVarRegistry::saveConfig
+};
+
+class CVar {
+public:
+    CVar(const std::string& name, const std::string& description, CVarType type, uint32_t flags);
+
+    const std::string& getName() const { return name; }
+    const std::string& getDescription() const { return description; }
+    CVarType getType() const { return type; }
+    uint32_t getFlags() const { return flags; }
+
+    bool getBool() const { return intValue != 0; }
+    int getInt() const { return intValue; }
+    float getFloat() const { return floatValue; }
+    const std::string& getString() const { return stringValue; }
+
+    // Setters clamp numeric values to [min, max]
+    void setBool(bool value);
+    void setInt(int value);
+    void setFloat(float value);
+    void setString(const std::string& value);
+
+    /**
+     * Parse and assign a value given as text
+     * @return false if the text is not a valid value for this type
+     */
+    bool setFromString(const std::string& value);
+    std::string toString() const;
+
+    void setRange(float minValue, float maxValue);
+    float getMin() const { return minValue; }
+    float getMax() const { return maxValue; }
+
+    void setDefaultFromCurrent();
+    void reset();
+    bool isDefault() const;
+
+    /**
+     * Incremented on every change; consumers compare against the last
+     * version they applied to pick up runtime changes
+     */
+    uint32_t getVersion() const { return version; }
+
+private:
+    std::string name;
+    std::string description;
+    CVarType type;
+    uint32_t flags;
+
+    int intValue = 0;           // Bool and Int
+    float floatValue = 0.0f;
+    std::string stringValue;
+
+    int defaultInt = 0;
+    float defaultFloat = 0.0f;
+    std::string defaultString;
+
+    float minValue = 0.0f;
+    float maxValue = 0.0f;      // min == max: unbounded
+
+    uint32_t version = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// CVarRegistry - Global lookup, command line, config file and console
+
+class CVarRegistry {
+public:
+    /**
+     * Register a variable (or return the existing one with that name)
+     */
+    static CVar* registerCVar(const std::string& name, const std::string& description,
+                              CVarType type, uint32_t flags = CVarFlag_None);
+
+    static CVar* find(const std::string& name);
+
+    /**
+     * Set a variable by name from text
+     * @return false if it does not exist, is read-only or the value is invalid
+     */
+    static bool set(const std::string& name, const std::string& value);
+
+    /**
+     * All variables sorted by name
+     */
+    static std::vector<CVar*> getAll();
+
+    /**
+     * Load the config file (if present), then apply the command line.
+     * Accepts "--name=value", "+name value" and "--config=path"
+     */
+    static void init(int argc, char** argv, const std::string& configPath = "froggi.cfg");
+
+    /**
+     * Config file: one "name value" per line, '#' starts a comment
+     */
+    static bool loadConfig(const std::string& path);
+    static bool saveConfig(const std::string& path);
+
+    /**
+     * Run a console command: "name value", "name", "reset name",
+     * "list [prefix]", "save [path]", "load [path]"
+     */
+    static void execute(const std::string& line);
+
+    // ImGui console (drawn by the renderer inside the UI pass)
+    static void setConsoleVisible(bool visible);
+    static void toggleConsole();
+    static void drawConsole();
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Typed handles - declare at file scope next to the code that reads them
+
+class AutoCVarBool {
+public:
+    AutoCVarBool(const char* name, const char* description, bool defaultValue,
+                 uint32_t flags = CVarFlag_None);
+    bool get() const { return cvar->getBool(); }
+    void set(bool value) { cvar->setBool(value); }
+    uint32_t version() const { return cvar->getVersion(); }
+private:
+    CVar* cvar;
+};
+
+class AutoCVarInt {
+public:
+    AutoCVarInt(const char* name, const char* description, int defaultValue,
+                int minValue, int maxValue, uint32_t flags = CVarFlag_None);
+    int get() const { return cvar->getInt(); }
+    void set(int value) { cvar->setInt(value); }
+    uint32_t version() const { return cvar->getVersion(); }
+private:
+    CVar* cvar;
+};
+
+class AutoCVarFloat {
+public:
+    AutoCVarFloat(const char* name, const char* description, float defaultValue,
+                  float minValue, float maxValue, uint32_t flags = CVarFlag_None);
+    float get() const { return cvar->getFloat(); }
+    void set(float value) { cvar->setFloat(value); }
+    uint32_t version() const { return cvar->getVersion(); }
+private:
+    CVar* cvar;
+};
+
+class AutoCVarString {
+public:
+    AutoCVarString(const char* name, const char* description, const char* defaultValue,
+                   uint32_t flags = CVarFlag_None);
+    const std::string& get() const { return cvar->getString(); }
+    void set(const std::string& value) { cvar->setString(value); }
+    uint32_t version() const { return cvar->getVersion(); }
+private:
+    CVar* cvar;
+};
+
+} // namespace froggi
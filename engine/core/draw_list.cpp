@@ -0,0 +1,383 @@
+#include "draw_list.h"
+#include "occlusion_culler.h"
+#include "pond_interface.h"
+#include "cvar.h"
+#include "log.h"
+#include "metrics.h"
+#include "worker_pool.h"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define FROGGI_CULL_SSE 1
+#include <xmmintrin.h>
+#endif
+
+namespace froggi {
+
+static AutoCVarBool cv_frustumCull("r.frustumCull", "Skip objects outside the camera frustum", true);
+static AutoCVarInt cv_cullParallelMin("r.cullParallelMin",
+    "Draw items per culling thread (smaller lists cull on the render thread)", 16384, 1024, 1 << 24);
+static AutoCVarInt cv_cullThreads("r.cullThreads", "Most threads used for culling (0 = every render worker)", 0, 0, 64);
+
+static MetricGauge metric_drawItems("render.draw_items");
+static MetricGauge metric_transparentItems("render.transparent_items");
+static MetricGauge metric_visibleItems("render.visible");
+static MetricGauge metric_culledItems("render.culled");
+static MetricGauge metric_occludedItems("render.occluded");
+
+namespace {
+
+// Planes in structure-of-arrays form, padded to two groups of four with
+// planes that accept everything
+struct CullPlanes {
+    alignas(16) float nx[8], ny[8], nz[8], w[8];
+    alignas(16) float ax[8], ay[8], az[8];
+};
+
+CullPlanes toCullPlanes(const Frustum& frustum) {
+    CullPlanes p;
+    for (int i = 0; i < 8; ++i) {
+        glm::vec4 plane = i < 6 ? frustum.planes[i] : glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+        p.nx[i] = plane.x;
+        p.ny[i] = plane.y;
+        p.nz[i] = plane.z;
+        p.w[i] = plane.w;
+        p.ax[i] = std::abs(plane.x);
+        p.ay[i] = std::abs(plane.y);
+        p.az[i] = std::abs(plane.z);
+    }
+    return p;
+}
+
+// An item is outside when its center is further behind some plane than the
+// bounds reach: the box's support distance or the sphere radius, whichever
+// is tighter
+void cullRange(const DrawItem* items, uint8_t* visible, size_t begin, size_t end, const CullPlanes& p) {
+#ifdef FROGGI_CULL_SSE
+    const __m128 zero = _mm_setzero_ps();
+    for (size_t i = begin; i < end; ++i) {
+        const DrawItem& item = items[i];
+        __m128 cx = _mm_set1_ps(item.boundsCenter.x);
+        __m128 cy = _mm_set1_ps(item.boundsCenter.y);
+        __m128 cz = _mm_set1_ps(item.boundsCenter.z);
+        __m128 ex = _mm_set1_ps(item.boundsExtents.x);
+        __m128 ey = _mm_set1_ps(item.boundsExtents.y);
+        __m128 ez = _mm_set1_ps(item.boundsExtents.z);
+        __m128 radius = _mm_set1_ps(item.boundsRadius);
+
+        int outside = 0;
+        for (int group = 0; group < 8; group += 4) {
+            __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, _mm_load_ps(p.nx + group)),
+                                             _mm_mul_ps(cy, _mm_load_ps(p.ny + group))),
+                                  _mm_add_ps(_mm_mul_ps(cz, _mm_load_ps(p.nz + group)),
+                                             _mm_load_ps(p.w + group)));
+            __m128 reach = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ex, _mm_load_ps(p.ax + group)),
+                                                 _mm_mul_ps(ey, _mm_load_ps(p.ay + group))),
+                                      _mm_mul_ps(ez, _mm_load_ps(p.az + group)));
+            reach = _mm_min_ps(reach, radius);
+            outside |= _mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(d, reach), zero));
+        }
+        visible[i] = outside == 0;
+    }
+#else
+    for (size_t i = begin; i < end; ++i) {
+        const DrawItem& item = items[i];
+        bool inside = true;
+        for (int plane = 0; plane < 6 && inside; ++plane) {
+            float d = item.boundsCenter.x * p.nx[plane] + item.boundsCenter.y * p.ny[plane] +
+                      item.boundsCenter.z * p.nz[plane] + p.w[plane];
+            float reach = item.boundsExtents.x * p.ax[plane] + item.boundsExtents.y * p.ay[plane] +
+                          item.boundsExtents.z * p.az[plane];
+            inside = d + std::min(reach, item.boundsRadius) >= 0.0f;
+        }
+        visible[i] = inside;
+    }
+#endif
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// Frustum
+
+Frustum Frustum::fromViewProjection(const glm::mat4& m) {
+    glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+    Frustum frustum;
+    frustum.planes[0] = row3 + row0;    // left
+    frustum.planes[1] = row3 - row0;    // right
+    frustum.planes[2] = row3 + row1;    // bottom
+    frustum.planes[3] = row3 - row1;    // top
+    frustum.planes[4] = row3 + row2;    // near
+    frustum.planes[5] = row3 - row2;    // far
+
+    // Normalized so plane distances are in world units
+    for (glm::vec4& plane : frustum.planes) {
+        float length = glm::length(glm::vec3(plane));
+        if (length > 0.0f) plane /= length;
+    }
+    return frustum;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Draw Sort Keys
+
+uint64_t draw_key::make(DrawLayer layer, uint32_t pipeline, uint32_t material, uint32_t mesh, float depth) {
+    constexpr uint32_t kDepthMax = (1u << kDepthBits) - 1;
+    float clamped = std::min(std::max(depth, 0.0f), 1.0f);
+    uint64_t quantized = static_cast<uint64_t>(clamped * static_cast<float>(kDepthMax));
+
+    uint64_t state = (static_cast<uint64_t>(pipeline & (kMaxPipelines - 1)) << 26) |
+                     (static_cast<uint64_t>(material & (kMaxMaterials - 1)) << 16) |
+                     static_cast<uint64_t>(mesh & (kMaxMeshes - 1));   // 30 bits
+
+    uint64_t key = static_cast<uint64_t>(layer) << 62;
+    if (layer == DrawLayer::Opaque) {
+        key |= (state << 32) | (quantized << 8);
+    } else {
+        key |= ((kDepthMax - quantized) << 38) | (state << 8);
+    }
+    return key;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// MeshRegistry Implementation
+
+MeshHandle MeshRegistry::add(const std::string& name, const glm::vec3& boundsMin, const glm::vec3& boundsMax,
+                            float boundsRadius) {
+    MeshHandle known = find(name);
+    if (known.isValid()) return known;
+
+    uint32_t slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        // Sort keys only have room for draw_key::kMaxMeshes slots
+        if (meshes.size() >= draw_key::kMaxMeshes) {
+            FROGGI_LOG_ERROR(Assets, "Cannot register mesh %s: all %u mesh slots are in use", name.c_str(),
+                             draw_key::kMaxMeshes);
+            return {};
+        }
+        slot = static_cast<uint32_t>(meshes.size());
+        meshes.emplace_back();
+    }
+
+    Entry& entry = meshes[slot];
+    entry.boundsMin = boundsMin;
+    entry.boundsMax = boundsMax;
+    entry.boundsRadius = boundsRadius;
+    entry.pipeline = 0;
+    entry.name = name;
+    indices.emplace(name, slot);
+    return { slot, entry.generation };
+}
+
+bool MeshRegistry::remove(MeshHandle handle) {
+    if (!isValid(handle)) return false;
+
+    Entry& entry = meshes[handle.index];
+    indices.erase(entry.name);
+    entry.name.clear();
+    entry.occluder = {};
+    // Generation 0 marks invalid handles, skip it on wrap-around
+    if (++entry.generation == 0) entry.generation = 1;
+    freeSlots.push_back(handle.index);
+    return true;
+}
+
+MeshHandle MeshRegistry::find(const std::string& name) const {
+    auto it = indices.find(name);
+    if (it == indices.end()) return {};
+    return { it->second, meshes[it->second].generation };
+}
+
+void MeshRegistry::setOccluder(uint32_t mesh, std::vector<glm::vec3> triangles) {
+    meshes[mesh].occluder = std::move(triangles);
+}
+
+void MeshRegistry::clear() {
+    // Slots keep counting generations so handles from before stay stale
+    freeSlots.clear();
+    for (uint32_t slot = static_cast<uint32_t>(meshes.size()); slot-- > 0;) {
+        Entry& entry = meshes[slot];
+        if (!entry.name.empty() && ++entry.generation == 0) entry.generation = 1;
+        entry.name.clear();
+        entry.occluder = {};
+        freeSlots.push_back(slot);
+    }
+    indices.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// DrawList Implementation
+
+void DrawList::extract(const Scene* scene, const MeshRegistry& meshes, const glm::mat4& viewProjection) {
+    items.clear();
+    if (!scene) return;
+    items.reserve(scene->gameObjects.size());
+
+    size_t transparent = 0;
+    for (GameObject* gameObject : scene->gameObjects) {
+        if (!gameObject->active) continue;
+
+        MeshComponent* meshComp = gameObject->getComponent<MeshComponent>();
+        if (!meshComp || !meshComp->enabled) continue;
+
+        // Names are hashed only until the handle is cached (or goes stale)
+        MeshHandle handle = meshComp->getMeshHandle();
+        if (!meshes.isValid(handle)) {
+            handle = meshes.find(meshComp->getMeshName());
+            if (!handle.isValid()) continue;
+            meshComp->setMeshHandle(handle);
+        }
+        uint32_t mesh = handle.index;
+
+        DrawItem item;
+        item.worldMatrix = gameObject->getWorldTransform();
+        item.color = meshComp->color;
+        item.mesh = mesh;
+        item.objectId = static_cast<uint32_t>(items.size() + 1);
+
+        // Transformed local box, re-fitted around its rotated corners
+        glm::vec3 localCenter = (meshes.getBoundsMin(mesh) + meshes.getBoundsMax(mesh)) * 0.5f;
+        glm::vec3 localExtents = (meshes.getBoundsMax(mesh) - meshes.getBoundsMin(mesh)) * 0.5f;
+        item.boundsCenter = glm::vec3(item.worldMatrix * glm::vec4(localCenter, 1.0f));
+        glm::mat3 absolute(glm::abs(glm::vec3(item.worldMatrix[0])), glm::abs(glm::vec3(item.worldMatrix[1])),
+                           glm::abs(glm::vec3(item.worldMatrix[2])));
+        item.boundsExtents = absolute * localExtents;
+        float scale = std::max(glm::length(absolute[0]), std::max(glm::length(absolute[1]), glm::length(absolute[2])));
+        item.boundsRadius = meshes.getBoundsRadius(mesh) * scale;
+
+        glm::vec4 clip = viewProjection * glm::vec4(item.boundsCenter, 1.0f);
+        float depth = clip.w != 0.0f ? clip.z / clip.w : clip.z;
+        DrawLayer layer = item.color.a < 1.0f ? DrawLayer::Transparent : DrawLayer::Opaque;
+        if (layer == DrawLayer::Transparent) transparent++;
+        item.sortKey = draw_key::make(layer, meshes.getPipeline(mesh), 0, mesh, depth);
+
+        items.push_back(item);
+    }
+
+    metric_drawItems.set(static_cast<double>(items.size()));
+    metric_transparentItems.set(static_cast<double>(transparent));
+}
+
+void DrawList::cull(const Frustum& frustum, WorkerPool* pool) {
+    size_t count = items.size();
+    cullStats = CullStats();
+    cullStats.tested = static_cast<uint32_t>(count);
+
+    if (cv_frustumCull.get() && count > 0) {
+        CullPlanes planes = toCullPlanes(frustum);
+        visibility.resize(count);
+
+        // Large lists are split into contiguous chunks, one per pool thread
+        size_t maxWorkers = pool ? pool->getWorkerCount() : 1;
+        if (cv_cullThreads.get() > 0) maxWorkers = std::min(maxWorkers, static_cast<size_t>(cv_cullThreads.get()));
+        size_t workers = std::min(maxWorkers, std::max<size_t>(1, count / static_cast<size_t>(cv_cullParallelMin.get())));
+        size_t chunk = (count + workers - 1) / workers;
+
+        auto cullChunk = [&](uint32_t w) {
+            size_t begin = w * chunk;
+            cullRange(items.data(), visibility.data(), begin, std::min(count, begin + chunk), planes);
+        };
+        if (workers > 1) {
+            pool->run(static_cast<uint32_t>(workers), cullChunk);
+        } else {
+            cullChunk(0);
+        }
+        cullStats.workers = static_cast<uint32_t>(workers);
+
+        // Compact in place, keeping scene order
+        size_t kept = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (!visibility[i]) continue;
+            if (kept != i) items[kept] = items[i];
+            kept++;
+        }
+        items.resize(kept);
+    }
+
+    cullStats.visible = static_cast<uint32_t>(items.size());
+    cullStats.culled = cullStats.tested - cullStats.visible;
+    metric_visibleItems.set(cullStats.visible);
+    metric_culledItems.set(cullStats.culled);
+    metric_occludedItems.set(0.0);
+}
+
+void DrawList::cullOccluded(const OcclusionCuller& occlusion) {
+    if (!occlusion.hasOccluders()) return;
+
+    size_t kept = 0;
+    for (size_t i = 0; i < items.size(); ++i) {
+        if (occlusion.isOccluded(items[i].boundsCenter, items[i].boundsExtents)) continue;
+        if (kept != i) items[kept] = items[i];
+        kept++;
+    }
+
+    cullStats.occluded += static_cast<uint32_t>(items.size() - kept);
+    cullStats.visible = static_cast<uint32_t>(kept);
+    items.resize(kept);
+    metric_visibleItems.set(cullStats.visible);
+    metric_occludedItems.set(cullStats.occluded);
+}
+
+void DrawList::sort() {
+    size_t count = items.size();
+    if (count < 2) return;
+
+    entries.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        entries[i] = { items[i].sortKey, static_cast<uint32_t>(i) };
+    }
+
+    if (count < 64) {
+        std::sort(entries.begin(), entries.end(),
+                  [](const SortEntry& a, const SortEntry& b) { return a.key < b.key; });
+    } else {
+        // All eight byte histograms in one pass
+        uint32_t histograms[8][256];
+        std::memset(histograms, 0, sizeof(histograms));
+        for (const SortEntry& entry : entries) {
+            for (int digit = 0; digit < 8; ++digit) {
+                histograms[digit][(entry.key >> (digit * 8)) & 0xFF]++;
+            }
+        }
+
+        entryScratch.resize(count);
+        SortEntry* source = entries.data();
+        SortEntry* target = entryScratch.data();
+        for (int digit = 0; digit < 8; ++digit) {
+            uint32_t* histogram = histograms[digit];
+
+            // Every key has the same byte here (unused bits, one pipeline...)
+            if (histogram[(source[0].key >> (digit * 8)) & 0xFF] == count) continue;
+
+            uint32_t offset = 0;
+            for (int bucket = 0; bucket < 256; ++bucket) {
+                uint32_t bucketCount = histogram[bucket];
+                histogram[bucket] = offset;
+                offset += bucketCount;
+            }
+            for (size_t i = 0; i < count; ++i) {
+                target[histogram[(source[i].key >> (digit * 8)) & 0xFF]++] = source[i];
+            }
+            std::swap(source, target);
+        }
+        if (source != entries.data()) entries.swap(entryScratch);
+    }
+
+    // Gather once into sorted order
+    sorted.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        sorted[i] = items[entries[i].index];
+    }
+    items.swap(sorted);
+}
+
+} // namespace froggi
@@ -0,0 +1,212 @@
+#pragma once
+
+#include "mesh_handle.h"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace froggi {
+
+class Scene;
+class OcclusionCuller;
+class WorkerPool;
+
+///////////////////////////////////////////////////////////////////////////////
+// MeshRegistry - Mesh names to handles plus local bounds
+//
+// The renderer registers every mesh it creates; slot i is its mesh i, and
+// slots of removed meshes are reused. Names are only hashed to resolve a
+// handle (MeshComponents cache theirs), per-slot data is a plain array.
+// Anything that extracts draws without a GPU (benchmarks, tools) can fill
+// its own registry with the same names.
+
+class MeshRegistry {
+public:
+    /**
+     * Register a mesh; a name that is already known keeps its first slot
+     * @return the mesh's handle, or an invalid one when all
+     *         draw_key::kMaxMeshes slots are taken
+     */
+    MeshHandle add(const std::string& name, const glm::vec3& boundsMin, const glm::vec3& boundsMax,
+                   float boundsRadius);
+
+    /**
+     * Unregister a mesh; its handles go stale and its slot is reused
+     * @return false if the handle was already stale
+     */
+    bool remove(MeshHandle handle);
+
+    /**
+     * @return an invalid handle if no mesh has that name
+     */
+    MeshHandle find(const std::string& name) const;
+
+    bool isValid(MeshHandle handle) const {
+        return handle.index < meshes.size() && meshes[handle.index].generation == handle.generation;
+    }
+
+    const std::string& getName(uint32_t mesh) const { return meshes[mesh].name; }
+    const glm::vec3& getBoundsMin(uint32_t mesh) const { return meshes[mesh].boundsMin; }
+    const glm::vec3& getBoundsMax(uint32_t mesh) const { return meshes[mesh].boundsMax; }
+    float getBoundsRadius(uint32_t mesh) const { return meshes[mesh].boundsRadius; }
+
+    /**
+     * Local-space triangle list (3 positions each) the occlusion culler
+     * rasterizes when the mesh is picked as an occluder; empty = never
+     */
+    void setOccluder(uint32_t mesh, std::vector<glm::vec3> triangles);
+    const std::vector<glm::vec3>& getOccluder(uint32_t mesh) const { return meshes[mesh].occluder; }
+
+    /**
+     * Pipeline the mesh draws with (< draw_key::kMaxPipelines); part of the
+     * sort key so draws needing the same pipeline are adjacent
+     */
+    void setPipeline(uint32_t mesh, uint32_t pipeline) { meshes[mesh].pipeline = pipeline; }
+    uint32_t getPipeline(uint32_t mesh) const { return meshes[mesh].pipeline; }
+
+    size_t size() const { return indices.size(); }          // registered meshes
+    size_t getSlotCount() const { return meshes.size(); }   // highest slot + 1
+    void clear();
+
+private:
+    struct Entry {
+        glm::vec3 boundsMin;
+        glm::vec3 boundsMax;
+        float boundsRadius;     // sphere around the box center holding every vertex
+        std::vector<glm::vec3> occluder;
+        uint32_t pipeline = 0;
+        uint32_t generation = 1;
+        std::string name;       // empty while the slot is free
+    };
+
+    std::vector<Entry> meshes;
+    std::vector<uint32_t> freeSlots;
+    std::unordered_map<std::string, uint32_t> indices;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Draw Sort Keys
+//
+// 64-bit keys, most significant field first:
+//
+//   opaque:       layer:2 | pipeline:4 | material:10 | mesh:16 | depth:24 | 0:8
+//   transparent:  layer:2 | far-depth:24 | pipeline:4 | material:10 | mesh:16 | 0:8
+//
+// Sorting ascending groups opaque draws by state (so instances of a mesh
+// are contiguous) and then front to back, and draws transparent ones after
+// them back to front. Depth is the quantized [0, 1] clip depth of the
+// object's bounds center; far-depth is its complement.
+
+enum class DrawLayer : uint8_t {
+    Opaque = 0,
+    Transparent = 1
+};
+
+namespace draw_key {
+
+constexpr uint32_t kDepthBits = 24;
+constexpr uint32_t kMaxPipelines = 1u << 4;
+constexpr uint32_t kMaxMaterials = 1u << 10;
+constexpr uint32_t kMaxMeshes = 1u << 16;
+
+uint64_t make(DrawLayer layer, uint32_t pipeline, uint32_t material, uint32_t mesh, float depth);
+
+inline DrawLayer layer(uint64_t key) { return static_cast<DrawLayer>(key >> 62); }
+
+} // namespace draw_key
+
+///////////////////////////////////////////////////////////////////////////////
+// Frustum - Clip planes of a view-projection matrix
+
+struct Frustum {
+    glm::vec4 planes[6];        // xyz = normal, w = distance; inside where dot >= 0
+
+    /**
+     * Gribb/Hartmann plane extraction. The near plane assumes a [-1, 1]
+     * depth range, which is conservative for [0, 1] projections too.
+     */
+    static Frustum fromViewProjection(const glm::mat4& viewProjection);
+};
+
+struct CullStats {
+    uint32_t tested = 0;
+    uint32_t visible = 0;
+    uint32_t culled = 0;        // outside the frustum
+    uint32_t occluded = 0;      // hidden behind occluders
+    uint32_t workers = 0;       // threads the last cull() ran on
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// DrawList - Everything a render pass needs per visible object
+//
+// Extracted once per frame from the scene, then read by every pass, so the
+// component lookups, mesh lookups and hierarchy walks are paid once no
+// matter how many passes draw the scene. sort() orders it by sortKey.
+
+struct DrawItem {
+    glm::mat4 worldMatrix;
+    glm::vec4 color;
+    glm::vec3 boundsCenter;     // world-space AABB
+    glm::vec3 boundsExtents;
+    float boundsRadius;         // world-space sphere around boundsCenter
+    uint64_t sortKey;           // see Draw Sort Keys
+    uint32_t mesh;              // MeshRegistry slot, valid for the frame
+    uint32_t objectId;          // 1-based, in scene order (silhouette ID)
+};
+
+class DrawList {
+public:
+    /**
+     * Rebuild from the active, enabled MeshComponents of a scene whose mesh
+     * is registered (others are skipped). A component's mesh name is looked
+     * up once and the handle cached on it; later frames only check the
+     * handle's generation. Objects with color alpha below 1 go in the
+     * transparent layer; depth comes from viewProjection.
+     */
+    void extract(const Scene* scene, const MeshRegistry& meshes, const glm::mat4& viewProjection);
+
+    /**
+     * Drop items whose bounds are outside the frustum (SIMD plane tests,
+     * split across the pool's threads for large lists); keeps the order
+     * @param workers nullptr culls on the calling thread
+     */
+    void cull(const Frustum& frustum, WorkerPool* workers = nullptr);
+
+    /**
+     * Drop items the culler's depth buffer hides (run after cull() and
+     * OcclusionCuller::render() on the same items); keeps the order
+     */
+    void cullOccluded(const OcclusionCuller& occlusion);
+
+    /**
+     * Order the items by sortKey (LSD radix sort; digits every key shares
+     * are skipped)
+     */
+    void sort();
+
+    const std::vector<DrawItem>& getItems() const { return items; }
+    const CullStats& getCullStats() const { return cullStats; }
+    size_t size() const { return items.size(); }
+    bool empty() const { return items.empty(); }
+    void clear() { items.clear(); }
+
+private:
+    struct SortEntry {
+        uint64_t key;
+        uint32_t index;
+    };
+
+    std::vector<DrawItem> items;
+    CullStats cullStats;
+    std::vector<uint8_t> visibility;
+
+    // Sort scratch, kept between frames
+    std::vector<SortEntry> entries;
+    std::vector<SortEntry> entryScratch;
+    std::vector<DrawItem> sorted;
+};
+
+} // namespace froggi
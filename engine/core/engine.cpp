@@ -1,173 +1,482 @@
 #include "pond_interface.h"
 #include "renderer.h"
 #include "collision_system.h"
-#include <iostream>
+#include "draw_list.h"
+#include "memory_tracker.h"
+#include "frame_profiler.h"
+#include "latency_tracker.h"
+#include "metrics.h"
+#include <imgui.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 
 namespace froggi {
 
+static AutoCVarBool cv_lodEnabled("lod.enabled",
+    "Reduce the update rate of distant / off-screen components that opt in", true);
+static AutoCVarFloat cv_lodDistanceScale("lod.distanceScale",
+    "Multiplier on update LOD distances", 1.0f, 0.01f, 100.0f);
+static AutoCVarFloat cv_taskBudgetMs("tasks.budgetMs",
+    "Milliseconds per frame given to the task queue", 2.0f, 0.0f, 100.0f);
+static AutoCVarFloat cv_physicsBudgetMs("p.budgetMs",
+    "Physics milliseconds per frame the collision step governor aims for (0 = unlimited)", 6.0f, 0.0f, 100.0f);
+
+static AutoCVarInt cv_memFrameAllocs("mem.frameAllocs",
+    "Allocations a steady-state frame may make (0 = unlimited)", 0, 0, 1 << 30, CVarFlag_Restart);
+static AutoCVarInt cv_memFrameBytes("mem.frameBytes",
+    "Bytes a steady-state frame may allocate (0 = unlimited)", 0, 0, 1 << 30, CVarFlag_Restart);
+static AutoCVarInt cv_memWarmupFrames("mem.warmupFrames",
+    "Frames after startup / scene load that don't count against the allocation budget", 120, 0, 1 << 20,
+    CVarFlag_Restart);
+static AutoCVarBool cv_memBudgetTest("mem.budgetTest",
+    "Exit with code 1 once a steady-state frame goes over the allocation budget", false, CVarFlag_NoSave);
+
+static MetricHistogram metric_frameTime("frame.time_ms", 1.0, 250.0);
+static MetricCounter metric_frames("frame.count");
+static MetricCounter metric_headlessFrames("frame.headless_count");     // steps of all headless engines
+static MetricGauge metric_taskBacklog("tasks.backlog");
+static MetricCounter metric_lodSkipped("lod.skipped_updates");
+
+namespace {
+
+thread_local Engine* t_currentEngine = nullptr;
+
+// Budget CVars take effect at startup and on scene load (restarts the warm-up)
+void applyMemoryBudget() {
+    MemoryTracker::setFrameBudget(static_cast<uint64_t>(cv_memFrameAllocs.get()),
+                                  static_cast<uint64_t>(cv_memFrameBytes.get()),
+                                  static_cast<uint32_t>(cv_memWarmupFrames.get()));
+    MemoryTracker::setBudgetTestMode(cv_memBudgetTest.get());
+    if (cv_memBudgetTest.get() && !MemoryTracker::isEnabled()) {
+        FROGGI_LOG_WARN(Engine, "mem.budgetTest needs a FROGGI_TRACK_ALLOCATIONS build, nothing is checked");
+    }
+}
+
+// Makes an engine (and its input context) current on this thread
+class CurrentEngineScope {
+public:
+    explicit CurrentEngineScope(Engine* engine)
+        : previousEngine(t_currentEngine), previousInput(Input::getThreadContext()) {
+        t_currentEngine = engine;
+        Input::setThreadContext(engine->getInputContext());
+    }
+    
+    ~CurrentEngineScope() {
+        t_currentEngine = previousEngine;
+        Input::setThreadContext(previousInput);
+    }
+    
+    CurrentEngineScope(const CurrentEngineScope&) = delete;
+    CurrentEngineScope& operator=(const CurrentEngineScope&) = delete;
+    
+private:
+    Engine* previousEngine;
+    InputContext* previousInput;
+};
+
+// Main camera as seen by the update LOD: position plus frustum
+struct LodCamera {
+    bool valid = false;
+    glm::vec3 position = glm::vec3(0.0f);
+    Frustum frustum;
+    
+    LodCamera(const CameraComponent* camera, float aspect) {
+        if (!camera || !camera->owner) return;
+        valid = true;
+        position = glm::vec3(camera->owner->getWorldTransform()[3]);
+        frustum = Frustum::fromViewProjection(camera->getProjectionMatrix(aspect) * camera->getViewMatrix());
+    }
+    
+    bool isVisible(const glm::vec3& center, float radius) const {
+        for (const glm::vec4& plane : frustum.planes) {
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) return false;
+        }
+        return true;
+    }
+    
+    // Frames between updates (0 = skip until visible)
+    uint32_t interval(const Component* component) const {
+        const UpdateLod& lod = component->updateLod;
+        glm::vec3 center = glm::vec3(component->owner->getWorldTransform()[3]);
+        if (!isVisible(center, lod.boundsRadius)) return lod.offscreenInterval;
+        
+        float scale = cv_lodDistanceScale.get();
+        float nearDistance = lod.nearDistance * scale;
+        float farDistance = std::max(lod.farDistance * scale, nearDistance + 0.001f);
+        float t = (glm::distance(center, position) - nearDistance) / (farDistance - nearDistance);
+        if (t <= 0.0f) return 1;
+        uint32_t farInterval = std::max<uint32_t>(lod.farInterval, 1);
+        return 1 + static_cast<uint32_t>(std::min(t, 1.0f) * static_cast<float>(farInterval - 1) + 0.5f);
+    }
+};
+
+} // namespace
+
 ///////////////////////////////////////////////////////////////////////////////
 // Engine Implementation
 
+Engine& Engine::getInstance() {
+    static Engine defaultInstance;
+    return t_currentEngine ? *t_currentEngine : defaultInstance;
+}
+
 bool Engine::init(Game* gameInstance, int width, int height) {
+    EngineConfig engineConfig;
+    engineConfig.width = width;
+    engineConfig.height = height;
+    return init(gameInstance, engineConfig);
+}
+
+bool Engine::init(Game* gameInstance, const EngineConfig& engineConfig) {
     if (!gameInstance) {
-        std::cerr << "no_game_instance_provided₍!.!₎" << std::endl;
+        FROGGI_LOG_ERROR(Engine, "no_game_instance_provided₍!.!₎");
         return false;
     }
     
-    std::cout << "_froggi_initializing...₍ᵔ~ᵔ₎" << std::endl;
+    Log::init();
+    config = engineConfig;
+    if (config.headless) {
+        inputContext = Input::createContext();
+    }
+    CurrentEngineScope scope(this);
+    FROGGI_LOG_INFO(Engine, config.headless ? "_froggi_initializing_headless...₍ᵔ~ᵔ₎"
+                                            : "_froggi_initializing...₍ᵔ~ᵔ₎");
+    
+    FROGGI_MEMORY_SCOPE(Engine);
+    if (!config.headless) {
+        applyMemoryBudget();
+    }
     
     game = gameInstance;
     
-    renderer = new Renderer();
-    if (!renderer->init(width, height)) {
-        std::cerr << "_failed_to_initialize_renderer₍!.!₎" << std::endl;
-        return false;
+    if (!config.headless) {
+        renderer = new Renderer();
+        if (!renderer->init(config.width, config.height)) {
+            FROGGI_LOG_ERROR(Engine, "_failed_to_initialize_renderer₍!.!₎");
+            delete renderer;
+            renderer = nullptr;
+            Log::shutdown();
+            return false;
+        }
+        
+        Input::init(renderer->getWindow());
     }
     
-    Input::init(renderer->getWindow());
+    scheduler.reset(config.headless ? 0.0 : glfwGetTime());
     
-    std::cout << "_initializing_game...₍ᵔ~ᵔ₎" << std::endl;
+    FROGGI_LOG_INFO(Engine, "_initializing_game...₍ᵔ~ᵔ₎");
     game->onInit();
     
-    std::cout << "_engine_initialized_successfully₍ᵔ.ᵔ₎" << std::endl;
+    FROGGI_LOG_INFO(Engine, "_engine_initialized_successfully₍ᵔ.ᵔ₎");
     return true;
 }
 
 void Engine::run() {
-    std::cout << "_starting_game_loop...₍ᵔ~ᵔ₎" << std::endl;
+    CurrentEngineScope scope(this);
+    FROGGI_LOG_INFO(Engine, "_starting_game_loop...₍ᵔ~ᵔ₎");
+    
+    if (config.headless) {
+        while (step()) {}
+        FROGGI_LOG_INFO(Engine, "_game_loop_ended₍ᵔ!ᵔ₎");
+        return;
+    }
     
     float lastTime = glfwGetTime();
     
-    while (renderer->isRunning()) {
+    while (renderer->isRunning() && !quitRequested) {
+        FrameProfiler::beginFrame();
+        
         float currentTime = glfwGetTime();
         deltaTime = currentTime - lastTime;
         if (deltaTime <= 0.0f) deltaTime = 1.0f / 60.0f;
         lastTime = currentTime;
         totalTime = currentTime;
         
-        glfwPollEvents();
-        Input::update();
+        {
+            FROGGI_PROFILE_ZONE(Events);
+            glfwPollEvents();
+            Input::update(glfwGetTime());
+            LatencyTracker::beginFrame(Input::getFrameEventTime());
+            
+            // A grave typed into a text field (e.g. the console's) is text
+            if (Input::isKeyPressed(GLFW_KEY_GRAVE_ACCENT) && !ImGui::GetIO().WantTextInput) {
+                CVarRegistry::toggleConsole();
+            }
+            if (Input::isKeyPressed(GLFW_KEY_F3)) {
+                FrameProfiler::setWindowVisible(!FrameProfiler::isWindowVisible());
+            }
+            if (Input::isKeyPressed(GLFW_KEY_F4)) {
+                LatencyTracker::setWindowVisible(!LatencyTracker::isWindowVisible());
+            }
+        }
+        
+        tick();
+       
+// ═══════════════════════════════════════════════════════════════
+// RENDER
+// ═══════════════════════════════════════════════════════════════
+
+if (game->currentScene && game->mainCamera) {
+    FROGGI_MEMORY_SCOPE(Renderer);
+    glm::mat4 viewMatrix = game->mainCamera->getViewMatrix();
+    glm::mat4 projectionMatrix = game->mainCamera->getProjectionMatrix(
+        renderer->getAspectRatio()
+    );
+    
+    // Pass UI callback to renderer
+    renderer->renderScene(
+        game->currentScene,
+        viewMatrix,
+        projectionMatrix,
+        [this]() { game->onRenderUI(); }
+    );
+}
         
         // ═══════════════════════════════════════════════════════════════
-        // GAME UPDATE
+        // FRAME END
         // ═══════════════════════════════════════════════════════════════
         
+        MemoryTracker::endFrame();
+        FrameProfiler::endFrame();
+        metric_frameTime.record(deltaTime * 1000.0);
+        metric_frames.add();
+        Metrics::publish(++frameIndex, glfwGetTime());
+        Log::update();
+        if (MemoryTracker::isBudgetTestMode() && MemoryTracker::hasBudgetViolation()) {
+            FROGGI_LOG_ERROR(Engine, "_allocation_budget_exceeded₍!.!₎");
+            quit(1);
+        }
+    }
+    
+    FROGGI_LOG_INFO(Engine, "_game_loop_ended₍ᵔ!ᵔ₎");
+}
+
+bool Engine::step(uint32_t frames) {
+    if (!config.headless) {
+        FROGGI_LOG_WARN(Engine, "_step()_is_for_headless_engines₍!.!₎");
+        return false;
+    }
+    
+    CurrentEngineScope scope(this);
+    for (uint32_t i = 0; i < frames && !quitRequested; ++i) {
+        deltaTime = config.frameTime;
+        totalTime += deltaTime;
+        Input::update(totalTime);
+        tick();
+        frameIndex++;
+        metric_headlessFrames.add();
+    }
+    return !quitRequested;
+}
+
+void Engine::tick() {
+    // Process-wide tools follow the windowed engine only
+    const bool tools = !config.headless;
+    
+    // ═══════════════════════════════════════════════════════════════
+    // GAME UPDATE
+    // ═══════════════════════════════════════════════════════════════
+    
+    {
+        FROGGI_MEMORY_SCOPE(Game);
+        FROGGI_PROFILE_ZONE(GameUpdate);
+        scheduler.advance(totalTime);
+#ifdef FROGGI_COROUTINES
+        scripts.resumeFrame();
+#endif
         game->onUpdate(deltaTime);
         
         if (game->currentScene) {
             updateScene(game->currentScene, deltaTime);
         }
+    }
+    
+    // ═══════════════════════════════════════════════════════════════
+    // FIXED UPDATE (Physics & Collision)
+    // ═══════════════════════════════════════════════════════════════
+    
+    accumulator += deltaTime;
+    auto fixedStart = std::chrono::steady_clock::now();
+    float physicsMs = 0.0f;
+    while (accumulator >= fixedTimeStep) {
+        FROGGI_MEMORY_SCOPE(Physics);
+        if (tools) {
+            FrameProfiler::addFixedStep();
+            LatencyTracker::mark(LatencyStage::FixedStep);
+        }
+        Input::beginFixedStep(accumulator - fixedTimeStep);
+#ifdef FROGGI_COROUTINES
+        scripts.resumeFixedStep();
+#endif
         
-        // ═══════════════════════════════════════════════════════════════
-        // FIXED UPDATE (Physics & Collision)
-        // ═══════════════════════════════════════════════════════════════
-        
-        accumulator += deltaTime;
-        while (accumulator >= fixedTimeStep) {
-            // STORE PREVIOUS POSITIONS BEFORE PHYSICS UPDATE
-            if (game->currentScene) {
-                for (auto* component : game->currentScene->components) {
-                    froggi::Rigidbody* rb = dynamic_cast<froggi::Rigidbody*>(component);
-                    if (rb && rb->enabled && rb->owner && !rb->isKinematic) {
-                        rb->previousPosition = rb->owner->position;
-                    }
+        // STORE PREVIOUS POSITIONS BEFORE PHYSICS UPDATE
+        if (game->currentScene) {
+            for (auto* component : game->currentScene->components) {
+                froggi::Rigidbody* rb = dynamic_cast<froggi::Rigidbody*>(component);
+                if (rb && rb->enabled && rb->owner && !rb->isKinematic) {
+                    rb->previousPosition = rb->owner->position;
                 }
             }
+        }
+        
+        if (game->currentScene) {
+            updateSceneFixed(game->currentScene, fixedTimeStep);
             
-            if (game->currentScene) {
-                updateSceneFixed(game->currentScene, fixedTimeStep);
-                
-                // Update collision system
-                if (game->currentScene->collisionSystem) {
-                    game->currentScene->collisionSystem->update(
-                        game->currentScene, fixedTimeStep);
+            // Update collision system
+            CollisionSystem* collisionSystem = game->currentScene->collisionSystem;
+            if (collisionSystem) {
+                FROGGI_PROFILE_ZONE(Physics);
+                // Split what is left of the physics budget between the steps still due
+                float budgetMs = cv_physicsBudgetMs.get();
+                if (budgetMs > 0.0f) {
+                    float stepsDue = std::floor(accumulator / fixedTimeStep);
+                    collisionSystem->setStepBudget(std::max(budgetMs - physicsMs, 0.0f) / stepsDue);
+                } else {
+                    collisionSystem->setStepBudget(-1.0f);
                 }
-            }
-            
-            // STORE CURRENT POSITIONS AFTER PHYSICS UPDATE
-            if (game->currentScene) {
-                for (auto* component : game->currentScene->components) {
-                    froggi::Rigidbody* rb = dynamic_cast<froggi::Rigidbody*>(component);
-                    if (rb && rb->enabled && rb->owner && !rb->isKinematic) {
-                        rb->currentPosition = rb->owner->position;
-                    }
+                
+                auto physicsStart = std::chrono::steady_clock::now();
+                collisionSystem->update(game->currentScene, fixedTimeStep);
+                physicsMs += std::chrono::duration<float, std::milli>(
+                    std::chrono::steady_clock::now() - physicsStart).count();
+                if (tools) {
+                    FrameProfiler::setPhysicsCounts(collisionSystem->getBodyCount(),
+                                                    collisionSystem->getActiveBodyCount(),
+                                                    collisionSystem->getContactCount());
+                    FrameProfiler::addCollisionSteps(static_cast<uint32_t>(
+                        collisionSystem->getStepDecision().steps));
                 }
             }
-            
-            accumulator -= fixedTimeStep;
         }
         
-        // ═══════════════════════════════════════════════════════════════
-        // INTERPOLATE VISUAL POSITIONS
-        // ═══════════════════════════════════════════════════════════════
-        
-        float alpha = accumulator / fixedTimeStep;
-        
+        // STORE CURRENT POSITIONS AFTER PHYSICS UPDATE
         if (game->currentScene) {
             for (auto* component : game->currentScene->components) {
                 froggi::Rigidbody* rb = dynamic_cast<froggi::Rigidbody*>(component);
                 if (rb && rb->enabled && rb->owner && !rb->isKinematic) {
-                    // Interpolate visual position between previous and current physics positions
-                    glm::vec3 renderPosition = glm::mix(rb->previousPosition, rb->currentPosition, alpha);
-                    rb->owner->position = renderPosition;
+                    rb->currentPosition = rb->owner->position;
                 }
             }
         }
-       
-// ═══════════════════════════════════════════════════════════════
-// RENDER
-// ═══════════════════════════════════════════════════════════════
-
-if (game->currentScene && game->mainCamera) {
-    glm::mat4 viewMatrix = game->mainCamera->getViewMatrix();
-    glm::mat4 projectionMatrix = game->mainCamera->getProjectionMatrix(
-        renderer->getAspectRatio()
-    );
+        
+        Input::endFixedStep();
+        accumulator -= fixedTimeStep;
+    }
+    FrameProfiler::addZoneTime(ProfileZone::FixedUpdate, std::chrono::duration<float, std::milli>(
+        std::chrono::steady_clock::now() - fixedStart).count());
     
-    // Pass UI callback to renderer
-    renderer->renderScene(
-        game->currentScene,
-        viewMatrix,
-        projectionMatrix,
-        [this]() { game->onRenderUI(); }
-    );
-}
+    // ═══════════════════════════════════════════════════════════════
+    // INTERPOLATE VISUAL POSITIONS
+    // ═══════════════════════════════════════════════════════════════
+    
+    float alpha = accumulator / fixedTimeStep;
+    
+    if (game->currentScene) {
+        FROGGI_PROFILE_ZONE(Interpolate);
+        for (auto* component : game->currentScene->components) {
+            froggi::Rigidbody* rb = dynamic_cast<froggi::Rigidbody*>(component);
+            if (rb && rb->enabled && rb->owner && !rb->isKinematic) {
+                // Interpolate visual position between previous and current physics positions
+                glm::vec3 renderPosition = glm::mix(rb->previousPosition, rb->currentPosition, alpha);
+                rb->owner->position = renderPosition;
+            }
+        }
     }
     
-    std::cout << "_game_loop_ended₍ᵔ!ᵔ₎" << std::endl;
+    // ═══════════════════════════════════════════════════════════════
+    // AMORTIZED TASKS (whatever fits the frame budget, rest carries over)
+    // ═══════════════════════════════════════════════════════════════
+    
+    {
+        FROGGI_PROFILE_ZONE(Tasks);
+        tasks.process(cv_taskBudgetMs.get());
+        if (tools) {
+            const TaskQueueStats& taskStats = tasks.getLastStats();
+            FrameProfiler::setTaskCounts(taskStats.slicesRun, taskStats.backlog);
+            metric_taskBacklog.set(taskStats.backlog);
+        }
+    }
 }
+
 void Engine::updateScene(Scene* scene, float deltaTime) {
-    for (auto* component : scene->components) {
-        if (component->enabled) {
-            component->onUpdate(deltaTime);
+    const bool lodEnabled = cv_lodEnabled.get();
+    const LodCamera camera(lodEnabled ? game->mainCamera : nullptr, getAspectRatio());
+    uint64_t skipped = 0;
+    
+    // Sleeping components are not in the list; ones woken during the loop
+    // are appended and start updating next frame
+    const std::vector<Component*>& active = scene->getUpdateList();
+    for (size_t i = 0, count = active.size(); i < count; ++i) {
+        Component* component = active[i];
+        if (!component->enabled || component->isSleeping()) continue;
+        
+        if (!component->updateLod.enabled || !camera.valid || !component->owner) {
+            // Time held back while LOD applied isn't lost when it stops
+            float elapsed = deltaTime + component->lodElapsed;
+            component->lodElapsed = 0.0f;
+            component->onUpdate(elapsed);
+            continue;
         }
+        
+        component->lodElapsed += deltaTime;
+        uint32_t interval = camera.interval(component);
+        if (interval == 0 || (frameIndex + component->lodPhase) % interval != 0) {
+            skipped++;
+            continue;
+        }
+        float elapsed = component->lodElapsed;
+        component->lodElapsed = 0.0f;
+        component->onUpdate(elapsed);
     }
+    
+    if (skipped > 0) metric_lodSkipped.add(skipped);
 }
 
 void Engine::updateSceneFixed(Scene* scene, float fixedDeltaTime) {
-    for (auto* component : scene->components) {
-        if (component->enabled) {
+    const std::vector<Component*>& active = scene->getUpdateList();
+    for (size_t i = 0, count = active.size(); i < count; ++i) {
+        Component* component = active[i];
+        if (component->enabled && !component->isSleeping()) {
             component->onFixedUpdate(fixedDeltaTime);
         }
     }
 }
 
 void Engine::shutdown() {
-    std::cout << "_shutting_down...₍ᵔ~ᵔ₎" << std::endl;
-    
-    if (game) {
-        game->onShutdown();
+    {
+        CurrentEngineScope scope(this);
+        FROGGI_LOG_INFO(Engine, "_shutting_down...₍ᵔ~ᵔ₎");
+        
+        if (game) {
+            game->onShutdown();
+            // Release the scene's collision system (and with the last one the
+            // shared Jolt runtime) if the game didn't unload the scene itself
+            if (game->currentScene) {
+                game->loadScene(nullptr);
+            }
+            game = nullptr;
+        }
+        
+        if (renderer) {
+            renderer->shutdown();
+            delete renderer;
+            renderer = nullptr;
+        }
+        
+        if (!config.headless) {
+            Input::shutdown();
+            Metrics::shutdown();
+        }
+        
+        FROGGI_LOG_INFO(Engine, "_engine_shutdown_complete₍ᵔ!ᵔ₎");
     }
     
-    if (renderer) {
-        renderer->shutdown();
-        delete renderer;
-        renderer = nullptr;
+    if (inputContext) {
+        Input::destroyContext(inputContext);
+        inputContext = nullptr;
     }
-    
-    Input::shutdown();
-    
-    std::cout << "_engine_shutdown_complete₍ᵔ!ᵔ₎" << std::endl;
+    Log::shutdown();
 }
 
 void Engine::setZoom(float zoom) {
@@ -196,11 +505,74 @@ float Engine::getAspectRatio() const {
     return 16.0f / 9.0f;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Component Implementation
+
+void Component::sleep() {
+    if (sleeping) return;
+    sleeping = true;
+    if (scene) scene->updateListDirty = true;
+}
+
+void Component::sleepFor(float seconds) {
+    sleep();
+    Scheduler& scheduler = Engine::getInstance().getScheduler();
+    scheduler.cancel(wakeTimer);
+    wakeTimer = scheduler.scheduleAfter(seconds, [this]() {
+        wakeTimer = Scheduler::kInvalidTimer;
+        wake();
+    }, scene);
+}
+
+void Component::wake() {
+    if (wakeTimer != Scheduler::kInvalidTimer) {
+        Engine::getInstance().getScheduler().cancel(wakeTimer);
+        wakeTimer = Scheduler::kInvalidTimer;
+    }
+    if (!sleeping) return;
+    sleeping = false;
+    if (scene && !inUpdateList) {
+        scene->updateList.push_back(this);
+        inUpdateList = true;
+    }
+}
+
+TimerId Component::scheduleAfter(float delay, Scheduler::Callback callback) {
+    return Engine::getInstance().getScheduler().scheduleAfter(delay, std::move(callback), scene);
+}
+
+TimerId Component::scheduleEvery(float interval, Scheduler::Callback callback) {
+    return Engine::getInstance().getScheduler().scheduleEvery(interval, std::move(callback), scene);
+}
+
+void Component::cancelTimer(TimerId id) {
+    Engine::getInstance().getScheduler().cancel(id);
+}
+
+#ifdef FROGGI_COROUTINES
+void Component::startScript(Script script) {
+    scripts.erase(std::remove_if(scripts.begin(), scripts.end(),
+                                 [](const Script& s) { return s.done(); }),
+                  scripts.end());
+    scripts.push_back(std::move(script));
+    scripts.back().start();
+}
+
+void Component::stopScripts() {
+    // Move out first: a destroyed script may not touch the list mid-clear
+    std::vector<Script> stopped;
+    stopped.swap(scripts);
+}
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 // Game Implementation
 
 void Game::loadScene(Scene* scene) {
     if (currentScene) {
+        // Timers and tasks of the old scene must not outlive it
+        Engine::getInstance().getScheduler().cancelOwner(currentScene);
+        Engine::getInstance().getTaskQueue().cancelOwner(currentScene);
         if (currentScene->collisionSystem) {
             delete currentScene->collisionSystem;
             currentScene->collisionSystem = nullptr;
@@ -210,14 +582,25 @@ void Game::loadScene(Scene* scene) {
     }
     currentScene = scene;
     if (currentScene) {
-        currentScene->onLoad();
+        {
+            FROGGI_MEMORY_SCOPE(Game);
+            currentScene->onLoad();
+        }
 
-        currentScene->collisionSystem = new CollisionSystem();
+        FROGGI_MEMORY_SCOPE(Physics);
+        currentScene->collisionSystem = new CollisionSystem(Engine::getInstance().getConfig().physicsThreads);
         currentScene->collisionSystem->initialize(currentScene);
     }
+    
+    // Loading allocates heavily; only steady-state frames count against the budget
+    if (!Engine::getInstance().isHeadless()) {
+        applyMemoryBudget();
+    }
 }
 
 void Game::loadModel(const std::string& name, const std::string& path) {
+    FROGGI_MEMORY_SCOPE(Assets);
+    // Headless engines have no renderer; visual meshes are skipped
     Engine& engine = Engine::getInstance();
     if (engine.getRenderer()) {
         engine.getRenderer()->loadMesh(name, path);
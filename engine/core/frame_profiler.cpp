@@ -0,0 +1,310 @@
+#include "frame_profiler.h"
+#include "cvar.h"
+#include "log.h"
+#include "memory_tracker.h"
+#include <imgui.h>
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace froggi {
+
+static AutoCVarBool cv_profilerWindow("profiler.window",
+    "Show the frame profiler window (zone timings, CSV export)", false, CVarFlag_NoSave);
+
+namespace {
+
+constexpr size_t kZoneCount = static_cast<size_t>(ProfileZone::Count);
+constexpr size_t kHistorySize = FrameProfiler::kMaxHistory;
+
+const char* kZoneNames[kZoneCount] = {
+    "Events", "GameUpdate", "FixedUpdate", "Physics", "Interpolate", "Tasks",
+    "Render", "Silhouette", "MainPass", "Outline", "Debug", "UI", "Blit", "Submit"
+};
+
+// All state is main-thread only: zones are timed around calls made from
+// the game loop, never from physics worker threads. Zones timed on other
+// threads (headless engines stepping in parallel) are ignored.
+std::atomic<std::thread::id> g_ownerThread;
+FrameRecord g_history[kHistorySize];
+size_t g_historyHead = 0;       // slot the next completed frame goes into
+size_t g_historyCount = 0;
+FrameRecord g_current;
+FrameRecord g_lastFrame;
+uint64_t g_frameIndex = 0;
+std::chrono::steady_clock::time_point g_frameStart;
+bool g_inFrame = false;
+
+bool g_enabled = true;
+float g_spikeThresholdMs = 50.0f;
+uint32_t g_framesBefore = 60;
+uint32_t g_framesAfter = 30;
+std::string g_captureDirectory = "profiler_captures";
+
+// Pending capture: waits until the frames after the spike are recorded
+bool g_capturePending = false;
+uint64_t g_captureSpikeFrame = 0;
+float g_captureSpikeMs = 0.0f;
+uint32_t g_captureFramesLeft = 0;
+bool g_skipNextSpikeCheck = false;
+uint32_t g_spikeCount = 0;
+
+// n-th oldest frame still in the history
+const FrameRecord& historyAt(size_t n) {
+    size_t start = (g_historyHead + kHistorySize - g_historyCount) % kHistorySize;
+    return g_history[(start + n) % kHistorySize];
+}
+
+void writeCsvHeader(std::ofstream& file) {
+    file << "frame,frame_ms";
+    for (size_t i = 0; i < kZoneCount; ++i) {
+        file << "," << kZoneNames[i] << "_ms";
+    }
+    file << ",fixed_steps,collision_steps,draw_calls,vertices,visible_objects,culled_objects,occluded_objects,bodies,active_bodies,contacts,tasks_run,task_backlog,"
+            "allocs,alloc_bytes,spike\n";
+}
+
+void writeCsvRow(std::ofstream& file, const FrameRecord& r) {
+    file << r.frame << "," << r.frameMs;
+    for (size_t i = 0; i < kZoneCount; ++i) {
+        file << "," << r.zoneMs[i];
+    }
+    file << "," << r.fixedSteps << "," << r.collisionSteps << "," << r.drawCalls << "," << r.vertices
+         << "," << r.visibleObjects << "," << r.culledObjects << "," << r.occludedObjects
+         << "," << r.bodies << "," << r.activeBodies << "," << r.contacts
+         << "," << r.tasksRun << "," << r.taskBacklog
+         << "," << r.allocs << "," << r.allocBytes << "," << (r.spike ? 1 : 0) << "\n";
+}
+
+void writeCapture() {
+    std::error_code ec;
+    std::filesystem::create_directories(g_captureDirectory, ec);
+
+    char filename[96];
+    std::snprintf(filename, sizeof(filename), "spike_frame%llu_%.1fms.csv",
+                  static_cast<unsigned long long>(g_captureSpikeFrame), g_captureSpikeMs);
+    std::filesystem::path path = std::filesystem::path(g_captureDirectory) / filename;
+
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        FROGGI_LOG_ERROR(Engine, "[FrameProfiler] Could not write %s", path.string().c_str());
+        return;
+    }
+
+    uint64_t first = g_captureSpikeFrame >= g_framesBefore ? g_captureSpikeFrame - g_framesBefore : 0;
+    size_t written = 0;
+    writeCsvHeader(file);
+    for (size_t n = 0; n < g_historyCount; ++n) {
+        const FrameRecord& r = historyAt(n);
+        if (r.frame < first) continue;
+        writeCsvRow(file, r);
+        written++;
+    }
+
+    FROGGI_LOG_INFO(Engine, "[FrameProfiler] Frame %llu took %gms (threshold %gms), wrote %zu frames to %s",
+                    static_cast<unsigned long long>(g_captureSpikeFrame), g_captureSpikeMs, g_spikeThresholdMs,
+                    written, path.string().c_str());
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// FrameProfiler Implementation
+
+const char* profileZoneName(ProfileZone zone) {
+    size_t index = static_cast<size_t>(zone);
+    return index < kZoneCount ? kZoneNames[index] : "Unknown";
+}
+
+void FrameProfiler::beginFrame() {
+    if (!g_enabled) return;
+    g_current = FrameRecord{};
+    g_current.frame = g_frameIndex;
+    g_frameStart = std::chrono::steady_clock::now();
+    g_ownerThread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    g_inFrame = true;
+}
+
+void FrameProfiler::endFrame() {
+    if (!g_enabled || !g_inFrame) return;
+    g_inFrame = false;
+
+    auto now = std::chrono::steady_clock::now();
+    g_current.frameMs = std::chrono::duration<float, std::milli>(now - g_frameStart).count();
+
+    const MemoryFrameStats& memory = MemoryTracker::getLastFrame();
+    g_current.allocs = memory.allocs;
+    g_current.allocBytes = memory.bytes;
+
+    // The frame after a capture pays for the file write; don't let it trigger another
+    bool checkSpike = g_spikeThresholdMs > 0.0f && !g_skipNextSpikeCheck;
+    g_skipNextSpikeCheck = false;
+    g_current.spike = checkSpike && g_current.frameMs > g_spikeThresholdMs;
+
+    g_history[g_historyHead] = g_current;
+    g_historyHead = (g_historyHead + 1) % kHistorySize;
+    if (g_historyCount < kHistorySize) g_historyCount++;
+    g_lastFrame = g_current;
+    g_frameIndex++;
+
+    if (g_capturePending) {
+        // A spike inside an open capture window is already part of that capture
+        if (g_captureFramesLeft > 0) g_captureFramesLeft--;
+    } else if (g_current.spike) {
+        g_capturePending = true;
+        g_captureSpikeFrame = g_current.frame;
+        g_captureSpikeMs = g_current.frameMs;
+        g_captureFramesLeft = g_framesAfter;
+        g_spikeCount++;
+    }
+
+    if (g_capturePending && g_captureFramesLeft == 0) {
+        writeCapture();
+        g_capturePending = false;
+        g_skipNextSpikeCheck = true;
+    }
+}
+
+void FrameProfiler::setEnabled(bool enabled) {
+    g_enabled = enabled;
+    g_inFrame = false;
+}
+
+bool FrameProfiler::isEnabled() {
+    return g_enabled;
+}
+
+void FrameProfiler::setSpikeThreshold(float milliseconds) {
+    g_spikeThresholdMs = std::max(0.0f, milliseconds);
+}
+
+float FrameProfiler::getSpikeThreshold() {
+    return g_spikeThresholdMs;
+}
+
+void FrameProfiler::setCaptureWindow(uint32_t framesBefore, uint32_t framesAfter) {
+    // Spike frame plus both sides must fit in the history
+    uint32_t maxSide = static_cast<uint32_t>(kHistorySize - 1) / 2;
+    g_framesBefore = std::min(framesBefore, maxSide);
+    g_framesAfter = std::min(framesAfter, maxSide);
+}
+
+void FrameProfiler::setCaptureDirectory(const std::string& path) {
+    g_captureDirectory = path;
+}
+
+void FrameProfiler::addZoneTime(ProfileZone zone, float milliseconds) {
+    if (g_ownerThread.load(std::memory_order_relaxed) != std::this_thread::get_id() || !g_inFrame) return;
+    g_current.zoneMs[static_cast<size_t>(zone)] += milliseconds;
+}
+
+void FrameProfiler::addDraws(uint32_t drawCalls, uint64_t vertices) {
+    g_current.drawCalls += drawCalls;
+    g_current.vertices += vertices;
+}
+
+void FrameProfiler::setCullCounts(uint32_t visible, uint32_t culled, uint32_t occluded) {
+    g_current.visibleObjects = visible;
+    g_current.culledObjects = culled;
+    g_current.occludedObjects = occluded;
+}
+
+void FrameProfiler::addFixedStep() {
+    g_current.fixedSteps++;
+}
+
+void FrameProfiler::addCollisionSteps(uint32_t steps) {
+    g_current.collisionSteps += steps;
+}
+
+void FrameProfiler::setPhysicsCounts(uint32_t bodies, uint32_t activeBodies, uint32_t contacts) {
+    g_current.bodies = bodies;
+    g_current.activeBodies = activeBodies;
+    g_current.contacts = contacts;
+}
+
+void FrameProfiler::setTaskCounts(uint32_t tasksRun, uint32_t backlog) {
+    g_current.tasksRun = tasksRun;
+    g_current.taskBacklog = backlog;
+}
+
+const FrameRecord& FrameProfiler::getLastFrame() {
+    return g_lastFrame;
+}
+
+uint32_t FrameProfiler::getSpikeCount() {
+    return g_spikeCount;
+}
+
+bool FrameProfiler::exportCsv(const std::string& path) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        FROGGI_LOG_ERROR(Engine, "[FrameProfiler] Could not write %s", path.c_str());
+        return false;
+    }
+
+    writeCsvHeader(file);
+    for (size_t n = 0; n < g_historyCount; ++n) {
+        writeCsvRow(file, historyAt(n));
+    }
+
+    FROGGI_LOG_INFO(Engine, "[FrameProfiler] Exported %zu frames to %s", g_historyCount, path.c_str());
+    return true;
+}
+
+void FrameProfiler::setWindowVisible(bool visible) {
+    cv_profilerWindow.set(visible);
+}
+
+bool FrameProfiler::isWindowVisible() {
+    return cv_profilerWindow.get();
+}
+
+void FrameProfiler::drawDebugWindow() {
+    if (!cv_profilerWindow.get()) return;
+
+    bool open = true;
+    bool expanded = ImGui::Begin("Frame Profiler", &open);
+    if (!open) cv_profilerWindow.set(false);
+    if (!expanded) {
+        ImGui::End();
+        return;
+    }
+
+    const FrameRecord& r = g_lastFrame;
+    ImGui::Text("Frame %llu: %.2f ms", static_cast<unsigned long long>(r.frame), r.frameMs);
+    ImGui::Text("Draws: %u (%llu verts)  Fixed steps: %u", r.drawCalls,
+                static_cast<unsigned long long>(r.vertices), r.fixedSteps);
+    ImGui::Text("Objects: %u visible, %u culled, %u occluded", r.visibleObjects, r.culledObjects,
+                r.occludedObjects);
+    ImGui::Text("Bodies: %u (%u active)  Contacts: %u  Collision steps: %u", r.bodies, r.activeBodies,
+                r.contacts, r.collisionSteps);
+    ImGui::Text("Tasks: %u run, %u queued", r.tasksRun, r.taskBacklog);
+    if (MemoryTracker::isEnabled()) {
+        ImGui::Text("Allocs: %llu (%llu bytes)", static_cast<unsigned long long>(r.allocs),
+                    static_cast<unsigned long long>(r.allocBytes));
+    }
+
+    ImGui::PlotLines("##frameMs",
+        [](void*, int idx) -> float { return historyAt(static_cast<size_t>(idx)).frameMs; },
+        nullptr, static_cast<int>(g_historyCount), 0, "ms/frame", 0.0f, FLT_MAX, ImVec2(0, 40));
+
+    for (size_t i = 0; i < kZoneCount; ++i) {
+        ImGui::Text("%-12s %6.2f ms", kZoneNames[i], r.zoneMs[i]);
+    }
+
+    ImGui::Separator();
+    ImGui::SliderFloat("Spike ms", &g_spikeThresholdMs, 0.0f, 200.0f, "%.1f");
+    ImGui::Text("Spikes captured: %u%s", g_spikeCount, g_capturePending ? " (capturing...)" : "");
+    if (ImGui::Button("Export CSV")) {
+        exportCsv("frame_profile.csv");
+    }
+
+    ImGui::End();
+}
+
+} // namespace froggi
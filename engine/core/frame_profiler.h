@@ -0,0 +1,168 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace froggi {
+
+///////////////////////////////////////////////////////////////////////////////
+// Profile Zones - Fixed set of timed sections per frame
+
+enum class ProfileZone : uint8_t {
+    Events = 0,         // glfwPollEvents + Input::update
+    GameUpdate,         // Game::onUpdate + component updates
+    FixedUpdate,        // whole fixed-step loop
+    Physics,            // CollisionSystem::update (inside FixedUpdate)
+    Interpolate,        // rigidbody visual interpolation
+    Tasks,              // TaskQueue::process (frame-budgeted work)
+    Render,             // Renderer::renderScene
+    Silhouette,         // render sub-zones (inside Render)
+    MainPass,
+    Outline,
+    Debug,
+    UI,
+    Blit,
+    Submit,
+    Count
+};
+
+const char* profileZoneName(ProfileZone zone);
+
+///////////////////////////////////////////////////////////////////////////////
+// Frame Record - Everything we know about one frame
+
+struct FrameRecord {
+    uint64_t frame = 0;
+    float frameMs = 0.0f;
+    float zoneMs[static_cast<size_t>(ProfileZone::Count)] = {};
+
+    uint32_t fixedSteps = 0;
+    uint32_t collisionSteps = 0;    // summed over the frame's fixed steps
+    uint32_t drawCalls = 0;
+    uint64_t vertices = 0;
+    uint32_t visibleObjects = 0;    // draw items left after frustum culling
+    uint32_t culledObjects = 0;     // outside the frustum
+    uint32_t occludedObjects = 0;   // hidden by the occlusion culler
+
+    uint32_t bodies = 0;
+    uint32_t activeBodies = 0;
+    uint32_t contacts = 0;
+
+    uint32_t tasksRun = 0;      // task slices run this frame
+    uint32_t taskBacklog = 0;   // tasks still queued at the end of it
+
+    uint64_t allocs = 0;        // from MemoryTracker (0 unless tracking is compiled in)
+    uint64_t allocBytes = 0;
+
+    bool spike = false;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// FrameProfiler - Rolling frame history with automatic spike capture
+//
+// Keeps the last frames in a fixed ring buffer. When a frame takes longer
+// than the spike threshold, the frames around it are written to a CSV file
+// in the capture directory once the frames after it have been recorded.
+// Recording is a handful of clock reads and array writes per frame; disk
+// I/O only happens when a spike is captured.
+
+class FrameProfiler {
+public:
+    static constexpr size_t kMaxHistory = 512;
+
+    /**
+     * Mark the start of a frame (called by Engine at the top of the loop)
+     */
+    static void beginFrame();
+
+    /**
+     * Close the frame: store it in the history and check for spikes
+     * (called by Engine after MemoryTracker::endFrame)
+     */
+    static void endFrame();
+
+    /**
+     * Enable or disable recording entirely
+     */
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    /**
+     * Frames slower than this are captured (0 = never capture)
+     */
+    static void setSpikeThreshold(float milliseconds);
+    static float getSpikeThreshold();
+
+    /**
+     * How many frames before and after a spike go into the capture
+     */
+    static void setCaptureWindow(uint32_t framesBefore, uint32_t framesAfter);
+
+    /**
+     * Directory capture files are written to (created on demand)
+     */
+    static void setCaptureDirectory(const std::string& path);
+
+    // Counters - accumulate into the frame being recorded
+    static void addZoneTime(ProfileZone zone, float milliseconds);
+    static void addDraws(uint32_t drawCalls, uint64_t vertices);
+    static void setCullCounts(uint32_t visible, uint32_t culled, uint32_t occluded);
+    static void addFixedStep();
+    static void addCollisionSteps(uint32_t steps);
+    static void setPhysicsCounts(uint32_t bodies, uint32_t activeBodies, uint32_t contacts);
+    static void setTaskCounts(uint32_t tasksRun, uint32_t backlog);
+
+    /**
+     * Last completed frame
+     */
+    static const FrameRecord& getLastFrame();
+
+    /**
+     * Number of spikes captured since startup
+     */
+    static uint32_t getSpikeCount();
+
+    /**
+     * Write the whole history now, regardless of spikes
+     * @return true if the file was written
+     */
+    static bool exportCsv(const std::string& path);
+
+    // ImGui window (drawn by the renderer inside the UI pass), shown while
+    // the profiler.window CVar is set; F3 toggles it
+    static void setWindowVisible(bool visible);
+    static bool isWindowVisible();
+    static void drawDebugWindow();
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ProfileScope - Adds the lifetime of the scope to a zone
+
+class ProfileScope {
+public:
+    explicit ProfileScope(ProfileZone z)
+        : zone(z), start(std::chrono::steady_clock::now()) {}
+
+    ~ProfileScope() {
+        auto end = std::chrono::steady_clock::now();
+        FrameProfiler::addZoneTime(zone,
+            std::chrono::duration<float, std::milli>(end - start).count());
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    ProfileZone zone;
+    std::chrono::steady_clock::time_point start;
+};
+
+} // namespace froggi
+
+#define FROGGI_PROFILE_CONCAT_INNER(a, b) a##b
+#define FROGGI_PROFILE_CONCAT(a, b) FROGGI_PROFILE_CONCAT_INNER(a, b)
+
+#define FROGGI_PROFILE_ZONE(zone) \
+    ::froggi::ProfileScope FROGGI_PROFILE_CONCAT(_froggiProfileScope, __LINE__)(::froggi::ProfileZone::zone)
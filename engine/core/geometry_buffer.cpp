@@ -0,0 +1,176 @@
+#include "geometry_buffer.h"
+#include "log.h"
+#include <algorithm>
+#include <numeric>
+
+namespace froggi {
+
+namespace {
+
+constexpr uint64_t kInitialBytes = 4 * 1024 * 1024;
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// Setup
+
+void GeometryBuffer::init(wgpu::Device gpuDevice, wgpu::Queue gpuQueue, wgpu::BufferUsage bufferUsage,
+                          uint32_t bytesPerElement, uint64_t maxBytes, const char* name) {
+    device = gpuDevice;
+    queue = gpuQueue;
+    usage = bufferUsage;
+    label = name;
+    elementSize = bytesPerElement;
+    alignment = 4 / std::gcd(elementSize, 4u);
+    maxElements = std::min<uint64_t>(maxBytes / elementSize, OffsetAllocator::kNoSpace - 1);
+    maxElements -= maxElements % alignment;
+    rebuilds = 0;
+
+    // The GPU buffer is created with the first range
+    allocator.reset(0);
+    ranges.clear();
+    freeRanges.clear();
+}
+
+void GeometryBuffer::terminate() {
+    if (buffer) {
+        buffer.destroy();
+        buffer.release();
+        buffer = nullptr;
+    }
+    allocator.reset(0);
+    ranges.clear();
+    freeRanges.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Ranges
+
+uint32_t GeometryBuffer::allocate(uint32_t count) {
+    if (count == 0) return kInvalidRange;
+    uint32_t units = (count + alignment - 1) / alignment * alignment;
+
+    OffsetAllocator::Allocation allocation = allocator.allocate(units);
+    if (allocation.offset == OffsetAllocator::kNoSpace) {
+        // Packing the live ranges is enough when the free space adds up,
+        // otherwise the buffer grows (at least doubling). The allocator only
+        // hands out a range from a size bin wholly above the request, so
+        // packing needs some slack over the exact size.
+        OffsetAllocator::StorageReport report = allocator.getStorageReport();
+        uint64_t capacity = allocator.getSize();
+        uint64_t needed = capacity - report.totalFree + units + units / 4;
+        if (report.totalFree < units + units / 4) {
+            capacity = std::max<uint64_t>({ capacity * 2, needed, kInitialBytes / elementSize });
+            capacity = std::min(capacity, maxElements);
+        }
+        if (capacity < needed || !rebuild(capacity)) {
+            FROGGI_LOG_ERROR(Renderer, "%s is out of space for %u elements", label.c_str(), count);
+            return kInvalidRange;
+        }
+        allocation = allocator.allocate(units);
+        if (allocation.offset == OffsetAllocator::kNoSpace) {
+            FROGGI_LOG_ERROR(Renderer, "%s has no range for %u elements after rebuilding", label.c_str(), count);
+            return kInvalidRange;
+        }
+    }
+
+    uint32_t range;
+    if (!freeRanges.empty()) {
+        range = freeRanges.back();
+        freeRanges.pop_back();
+    } else {
+        range = static_cast<uint32_t>(ranges.size());
+        ranges.emplace_back();
+    }
+    ranges[range].allocation = allocation;
+    ranges[range].live = true;
+    return range;
+}
+
+void GeometryBuffer::free(uint32_t range) {
+    if (range >= ranges.size() || !ranges[range].live) return;
+    allocator.free(ranges[range].allocation);
+    ranges[range] = Range{};
+    freeRanges.push_back(range);
+}
+
+bool GeometryBuffer::defragment() {
+    OffsetAllocator::StorageReport report = allocator.getStorageReport();
+    if (!buffer || report.largestFree == report.totalFree) return true;
+    return rebuild(allocator.getSize());
+}
+
+GeometryBufferStats GeometryBuffer::getStats() const {
+    OffsetAllocator::StorageReport report = allocator.getStorageReport();
+    GeometryBufferStats stats;
+    stats.capacityBytes = getByteSize();
+    stats.usedBytes = static_cast<uint64_t>(allocator.getSize() - report.totalFree) * elementSize;
+    stats.largestFreeBytes = static_cast<uint64_t>(report.largestFree) * elementSize;
+    stats.ranges = allocator.getAllocationCount();
+    stats.rebuilds = rebuilds;
+    stats.fragmentation = report.totalFree > 0
+        ? 1.0f - static_cast<float>(report.largestFree) / static_cast<float>(report.totalFree) : 0.0f;
+    return stats;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Rebuild
+
+bool GeometryBuffer::rebuild(uint64_t capacity) {
+    // Live ranges in offset order land back to back from the start; the
+    // layout is settled before any GPU work so a misfit records nothing
+    std::vector<uint32_t> order;
+    for (uint32_t i = 0; i < ranges.size(); ++i) {
+        if (ranges[i].live) order.push_back(i);
+    }
+    std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+        return ranges[a].allocation.offset < ranges[b].allocation.offset;
+    });
+
+    std::vector<uint32_t> sizes;
+    sizes.reserve(order.size());
+    for (uint32_t range : order) sizes.push_back(allocator.getAllocationSize(ranges[range].allocation));
+
+    OffsetAllocator packed;
+    std::vector<OffsetAllocator::Allocation> moved;
+    if (!packed.resetPacked(static_cast<uint32_t>(capacity), sizes, moved)) return false;
+
+    wgpu::BufferDescriptor bufferDesc{};
+    bufferDesc.label = label.c_str();
+    bufferDesc.size = capacity * elementSize;
+    bufferDesc.usage = usage | wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::CopySrc;
+    bufferDesc.mappedAtCreation = false;
+    wgpu::Buffer rebuilt = device.createBuffer(bufferDesc);
+    if (!rebuilt) return false;
+
+    if (!order.empty()) {
+        wgpu::CommandEncoderDescriptor encoderDesc{};
+        encoderDesc.label = "Geometry Rebuild";
+        wgpu::CommandEncoder encoder = device.createCommandEncoder(encoderDesc);
+        for (size_t i = 0; i < order.size(); ++i) {
+            OffsetAllocator::Allocation& allocation = ranges[order[i]].allocation;
+            encoder.copyBufferToBuffer(buffer, static_cast<uint64_t>(allocation.offset) * elementSize, rebuilt,
+                                       static_cast<uint64_t>(moved[i].offset) * elementSize,
+                                       static_cast<uint64_t>(sizes[i]) * elementSize);
+            allocation = moved[i];
+        }
+        wgpu::CommandBufferDescriptor commandDesc{};
+        commandDesc.label = "Geometry Rebuild";
+        wgpu::CommandBuffer commands = encoder.finish(commandDesc);
+        queue.submit(commands);
+        commands.release();
+        encoder.release();
+    }
+
+    FROGGI_LOG_DEBUG(Renderer, "%s rebuilt: %u -> %llu elements, %zu ranges moved", label.c_str(),
+                     allocator.getSize(), static_cast<unsigned long long>(capacity), order.size());
+
+    // Frames still in flight keep the old buffer alive until they finish
+    if (buffer) buffer.release();
+    buffer = rebuilt;
+    allocator = std::move(packed);
+    rebuilds++;
+    return true;
+}
+
+} // namespace froggi
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "offset_allocator.h"
+#include <webgpu/webgpu.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace froggi {
+
+struct GeometryBufferStats {
+    uint64_t capacityBytes = 0;
+    uint64_t usedBytes = 0;
+    uint64_t largestFreeBytes = 0;
+    uint32_t ranges = 0;
+    uint32_t rebuilds = 0;          // grows and defragmentations so far
+    float fragmentation = 0.0f;     // 1 - largest free range / total free space
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// GeometryBuffer - One large GPU buffer that meshes sub-allocate from
+//
+// Ranges are counted in elements (vertices of one layout, or indices), so a
+// range's offset is directly the baseVertex / firstIndex of its draws and
+// every mesh in the buffer draws from the same binding. Ranges come from an
+// OffsetAllocator; when no free range fits, the buffer is rebuilt: the live
+// ranges are copied on the GPU to the front of a new buffer (a larger one
+// if the free space wouldn't do), which also defragments it. Range ids stay
+// valid across rebuilds, only their offsets change.
+
+class GeometryBuffer {
+public:
+    static constexpr uint32_t kInvalidRange = UINT32_MAX;
+
+    /**
+     * @param elementSize Bytes per element; ranges are padded so byte
+     *        offsets stay 4-byte aligned for writeBuffer and copies
+     * @param maxBytes Largest buffer the device accepts
+     */
+    void init(wgpu::Device device, wgpu::Queue queue, wgpu::BufferUsage usage, uint32_t elementSize,
+              uint64_t maxBytes, const char* label);
+    void terminate();
+
+    /**
+     * Reserve count elements; the caller uploads them at getByteOffset()
+     * @return range id, kInvalidRange if the buffer can't grow to fit them
+     */
+    uint32_t allocate(uint32_t count);
+    void free(uint32_t range);
+
+    /**
+     * Pack every range at the front of a fresh buffer of the same size
+     */
+    bool defragment();
+
+    uint32_t getOffset(uint32_t range) const { return ranges[range].allocation.offset; }
+    uint64_t getByteOffset(uint32_t range) const { return static_cast<uint64_t>(getOffset(range)) * elementSize; }
+    const wgpu::Buffer& getBuffer() const { return buffer; }
+    uint64_t getByteSize() const { return static_cast<uint64_t>(allocator.getSize()) * elementSize; }
+    GeometryBufferStats getStats() const;
+
+private:
+    struct Range {
+        OffsetAllocator::Allocation allocation;
+        bool live = false;
+    };
+
+    bool rebuild(uint64_t capacity);
+
+    wgpu::Device device = nullptr;
+    wgpu::Queue queue = nullptr;
+    wgpu::Buffer buffer = nullptr;
+    wgpu::BufferUsage usage = wgpu::BufferUsage::None;
+    std::string label;
+    uint32_t elementSize = 1;
+    uint32_t alignment = 1;         // elements per 4-byte aligned step
+    uint64_t maxElements = 0;
+    uint32_t rebuilds = 0;
+
+    OffsetAllocator allocator;
+    std::vector<Range> ranges;
+    std::vector<uint32_t> freeRanges;
+};
+
+} // namespace froggi
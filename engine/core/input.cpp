@@ -1,22 +1,394 @@
+#include "pond_interface.h"
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <cstring>
+
 namespace froggi {
-    bool Input::isKeyDown(int keycode) {
-        return glfwGetKey(window, keycode) == GLFW_PRESS;
-    }
-    
-    bool Input::isKeyPressed(int keycode) {
-        // Track previous frame state
-        bool current = isKeyDown(keycode);
-        bool previous = prevKeyState[keycode];
-        prevKeyState[keycode] = current;
-        return current && !previous;
-    }
-    
-    glm::vec2 Input::getMovementInput() {
-        glm::vec2 input(0.0f);
-        if (isKeyDown(GLFW_KEY_W)) input.y -= 1.0f;
-        if (isKeyDown(GLFW_KEY_S)) input.y += 1.0f;
-        if (isKeyDown(GLFW_KEY_A)) input.x -= 1.0f;
-        if (isKeyDown(GLFW_KEY_D)) input.x += 1.0f;
-        return input;
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+// Input State
+
+enum class InputDevice : uint8_t {
+    Key,
+    MouseButton,
+    GamepadButton
+};
+
+struct InputEvent {
+    double time = 0.0;
+    uint16_t code = 0;
+    InputDevice device = InputDevice::Key;
+    bool down = false;
+};
+
+// Level + edges for one device. Edges are accumulated from events, so a
+// press and release inside the same frame/step reports both.
+template<size_t N>
+struct ButtonSet {
+    std::bitset<N> down;
+    std::bitset<N> pressed;
+    std::bitset<N> released;
+
+    void clearEdges() {
+        pressed.reset();
+        released.reset();
     }
+
+    void apply(size_t code, bool isDown) {
+        if (code >= N) return;
+        if (isDown && !down[code]) pressed.set(code);
+        if (!isDown && down[code]) released.set(code);
+        down[code] = isDown;
+    }
+};
+
+struct InputState {
+    ButtonSet<Input::kMaxKeys> keys;
+    ButtonSet<Input::kMaxMouseButtons> mouse;
+    ButtonSet<Input::kMaxGamepads * Input::kGamepadButtons> gamepad;
+
+    void clearEdges() {
+        keys.clearEdges();
+        mouse.clearEdges();
+        gamepad.clearEdges();
+    }
+
+    void apply(const InputEvent& event) {
+        switch (event.device) {
+            case InputDevice::Key:           keys.apply(event.code, event.down); break;
+            case InputDevice::MouseButton:   mouse.apply(event.code, event.down); break;
+            case InputDevice::GamepadButton: gamepad.apply(event.code, event.down); break;
+        }
+    }
+};
+
+// Event ring buffer with one writer (GLFW callbacks / gamepad polling /
+// injected events) and two readers: the frame cursor is drained every
+// update(), the fixed cursor only as far as the current fixed step reaches.
+constexpr uint32_t kEventCapacity = 1024;
+static_assert((kEventCapacity & (kEventCapacity - 1)) == 0, "capacity must be a power of two");
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// Input Context - all state of one input source (the window, or a headless
+// engine fed through inject*)
+
+struct InputContext {
+    std::array<InputEvent, kEventCapacity> events;
+    uint32_t writeIndex = 0;
+    uint32_t frameReadIndex = 0;
+    uint32_t fixedReadIndex = 0;
+
+    InputState frameState;
+    InputState fixedState;
+    bool inFixedStep = false;
+    double pollTime = 0.0;
+    double frameEventTime = 0.0;
+
+    glm::vec2 mousePosition = glm::vec2(0.0f);
+    glm::vec2 scrollAccum = glm::vec2(0.0f);
+    glm::vec2 frameScroll = glm::vec2(0.0f);
+
+    // Gamepads are polled for the window (GLFW has no button callbacks for
+    // them); headless contexts only see injected buttons
+    bool gamepadConnected[Input::kMaxGamepads] = {};
+    GLFWgamepadstate gamepadPolled[Input::kMaxGamepads] = {};
+};
+
+namespace {
+
+InputContext s_windowContext;
+thread_local InputContext* t_context = nullptr;
+
+GLFWwindow* s_window = nullptr;
+
+// Callbacks installed before ours (ImGui's), called first
+GLFWkeyfun s_prevKeyCallback = nullptr;
+GLFWmousebuttonfun s_prevMouseButtonCallback = nullptr;
+GLFWcursorposfun s_prevCursorPosCallback = nullptr;
+GLFWscrollfun s_prevScrollCallback = nullptr;
+
+InputContext& context() {
+    return t_context ? *t_context : s_windowContext;
+}
+
+const InputState& activeState() {
+    const InputContext& ctx = context();
+    return ctx.inFixedStep ? ctx.fixedState : ctx.frameState;
+}
+
+void pushEvent(InputContext& ctx, InputDevice device, int code, bool down, double time) {
+    if (code < 0) return;
+
+    // Fixed cursor fell a whole ring behind (no fixed steps for a long time):
+    // fold the oldest event into the fixed state instead of losing it
+    if (ctx.writeIndex - ctx.fixedReadIndex >= kEventCapacity) {
+        ctx.fixedState.apply(ctx.events[ctx.fixedReadIndex & (kEventCapacity - 1)]);
+        ctx.fixedReadIndex++;
+    }
+    if (ctx.writeIndex - ctx.frameReadIndex >= kEventCapacity) {
+        ctx.frameState.apply(ctx.events[ctx.frameReadIndex & (kEventCapacity - 1)]);
+        ctx.frameReadIndex++;
+    }
+
+    InputEvent& event = ctx.events[ctx.writeIndex & (kEventCapacity - 1)];
+    event.time = time;
+    event.code = static_cast<uint16_t>(code);
+    event.device = device;
+    event.down = down;
+    ctx.writeIndex++;
+}
+
+void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+    if (s_prevKeyCallback) s_prevKeyCallback(window, key, scancode, action, mods);
+    if (action == GLFW_REPEAT || key >= Input::kMaxKeys) return;
+    pushEvent(s_windowContext, InputDevice::Key, key, action == GLFW_PRESS, glfwGetTime());
+}
+
+void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods) {
+    if (s_prevMouseButtonCallback) s_prevMouseButtonCallback(window, button, action, mods);
+    if (button >= Input::kMaxMouseButtons) return;
+    pushEvent(s_windowContext, InputDevice::MouseButton, button, action == GLFW_PRESS, glfwGetTime());
+}
+
+void cursorPosCallback(GLFWwindow* window, double x, double y) {
+    if (s_prevCursorPosCallback) s_prevCursorPosCallback(window, x, y);
+    s_windowContext.mousePosition = glm::vec2(static_cast<float>(x), static_cast<float>(y));
+}
+
+void scrollCallback(GLFWwindow* window, double x, double y) {
+    if (s_prevScrollCallback) s_prevScrollCallback(window, x, y);
+    s_windowContext.scrollAccum += glm::vec2(static_cast<float>(x), static_cast<float>(y));
+}
+
+void pollGamepads(InputContext& ctx, double time) {
+    for (int pad = 0; pad < Input::kMaxGamepads; ++pad) {
+        GLFWgamepadstate state;
+        bool connected = glfwJoystickIsGamepad(pad) && glfwGetGamepadState(pad, &state);
+        if (!connected) {
+            // Release everything still held on a disconnected pad
+            std::memset(&state, 0, sizeof(state));
+        }
+
+        for (int button = 0; button < Input::kGamepadButtons; ++button) {
+            bool down = state.buttons[button] == GLFW_PRESS;
+            bool wasDown = ctx.gamepadPolled[pad].buttons[button] == GLFW_PRESS;
+            if (down != wasDown) {
+                pushEvent(ctx, InputDevice::GamepadButton, pad * Input::kGamepadButtons + button, down, time);
+            }
+        }
+
+        ctx.gamepadPolled[pad] = state;
+        ctx.gamepadConnected[pad] = connected;
+    }
+}
+
+bool validGamepad(int gamepad) {
+    return gamepad >= 0 && gamepad < Input::kMaxGamepads;
+}
+
+bool validGamepadButton(int button, int gamepad) {
+    return validGamepad(gamepad) && button >= 0 && button < Input::kGamepadButtons;
+}
+
+size_t gamepadBit(int button, int gamepad) {
+    return static_cast<size_t>(gamepad * Input::kGamepadButtons + button);
+}
+
+bool validKey(int keycode) {
+    return keycode >= 0 && keycode < Input::kMaxKeys;
+}
+
+bool validMouseButton(int button) {
+    return button >= 0 && button < Input::kMaxMouseButtons;
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// Input Implementation
+
+void Input::init(GLFWwindow* window) {
+    s_windowContext = InputContext{};
+    s_window = window;
+
+    if (!s_window) return;
+
+    // ImGui installs its callbacks during renderer init; keep them running
+    s_prevKeyCallback = glfwSetKeyCallback(s_window, keyCallback);
+    s_prevMouseButtonCallback = glfwSetMouseButtonCallback(s_window, mouseButtonCallback);
+    s_prevCursorPosCallback = glfwSetCursorPosCallback(s_window, cursorPosCallback);
+    s_prevScrollCallback = glfwSetScrollCallback(s_window, scrollCallback);
+
+    double x, y;
+    glfwGetCursorPos(s_window, &x, &y);
+    s_windowContext.mousePosition = glm::vec2(static_cast<float>(x), static_cast<float>(y));
+}
+
+void Input::update(double time) {
+    InputContext& ctx = context();
+    ctx.pollTime = time;
+    if (&ctx == &s_windowContext && s_window) {
+        pollGamepads(ctx, time);
+    }
+
+    ctx.frameState.clearEdges();
+    ctx.frameEventTime = ctx.frameReadIndex != ctx.writeIndex
+        ? ctx.events[ctx.frameReadIndex & (kEventCapacity - 1)].time
+        : 0.0;
+    while (ctx.frameReadIndex != ctx.writeIndex) {
+        ctx.frameState.apply(ctx.events[ctx.frameReadIndex & (kEventCapacity - 1)]);
+        ctx.frameReadIndex++;
+    }
+
+    ctx.frameScroll = ctx.scrollAccum;
+    ctx.scrollAccum = glm::vec2(0.0f);
+}
+
+void Input::shutdown() {
+    // The window is already destroyed by the renderer; just drop our references
+    s_window = nullptr;
+    s_prevKeyCallback = nullptr;
+    s_prevMouseButtonCallback = nullptr;
+    s_prevCursorPosCallback = nullptr;
+    s_prevScrollCallback = nullptr;
+    s_windowContext.inFixedStep = false;
+}
+
+InputContext* Input::createContext() {
+    return new InputContext();
+}
+
+void Input::destroyContext(InputContext* inputContext) {
+    if (t_context == inputContext) t_context = nullptr;
+    delete inputContext;
+}
+
+void Input::setThreadContext(InputContext* inputContext) {
+    t_context = inputContext;
+}
+
+InputContext* Input::getThreadContext() {
+    return t_context;
+}
+
+void Input::beginFixedStep(float timeRemaining) {
+    InputContext& ctx = context();
+    double stepEnd = ctx.pollTime - static_cast<double>(timeRemaining);
+
+    ctx.fixedState.clearEdges();
+    while (ctx.fixedReadIndex != ctx.writeIndex) {
+        const InputEvent& event = ctx.events[ctx.fixedReadIndex & (kEventCapacity - 1)];
+        if (event.time > stepEnd) break;
+        ctx.fixedState.apply(event);
+        ctx.fixedReadIndex++;
+    }
+
+    ctx.inFixedStep = true;
+}
+
+void Input::endFixedStep() {
+    context().inFixedStep = false;
+}
+
+double Input::getFrameEventTime() {
+    return context().frameEventTime;
+}
+
+// Injection (timestamped at the last update, so the next update and the
+// first fixed step after it see the event)
+
+void Input::injectKey(int keycode, bool down) {
+    if (!validKey(keycode)) return;
+    InputContext& ctx = context();
+    pushEvent(ctx, InputDevice::Key, keycode, down, ctx.pollTime);
+}
+
+void Input::injectMouseButton(int button, bool down) {
+    if (!validMouseButton(button)) return;
+    InputContext& ctx = context();
+    pushEvent(ctx, InputDevice::MouseButton, button, down, ctx.pollTime);
+}
+
+void Input::injectMousePosition(const glm::vec2& position) {
+    context().mousePosition = position;
+}
+
+void Input::injectGamepadButton(int button, bool down, int gamepad) {
+    if (!validGamepadButton(button, gamepad)) return;
+    InputContext& ctx = context();
+    ctx.gamepadConnected[gamepad] = true;
+    pushEvent(ctx, InputDevice::GamepadButton, static_cast<int>(gamepadBit(button, gamepad)), down, ctx.pollTime);
+}
+
+void Input::injectGamepadAxis(int axis, float value, int gamepad) {
+    if (!validGamepad(gamepad) || axis < 0 || axis >= kGamepadAxes) return;
+    InputContext& ctx = context();
+    ctx.gamepadConnected[gamepad] = true;
+    ctx.gamepadPolled[gamepad].axes[axis] = value;
+}
+
+// Keyboard
+
+bool Input::isKeyDown(int keycode) {
+    return validKey(keycode) && activeState().keys.down[keycode];
+}
+
+bool Input::isKeyPressed(int keycode) {
+    return validKey(keycode) && activeState().keys.pressed[keycode];
+}
+
+bool Input::isKeyReleased(int keycode) {
+    return validKey(keycode) && activeState().keys.released[keycode];
+}
+
+// Mouse
+
+glm::vec2 Input::getMousePosition() {
+    return context().mousePosition;
+}
+
+glm::vec2 Input::getMouseScroll() {
+    return context().frameScroll;
+}
+
+bool Input::isMouseButtonDown(int button) {
+    return validMouseButton(button) && activeState().mouse.down[button];
+}
+
+bool Input::isMouseButtonPressed(int button) {
+    return validMouseButton(button) && activeState().mouse.pressed[button];
+}
+
+bool Input::isMouseButtonReleased(int button) {
+    return validMouseButton(button) && activeState().mouse.released[button];
+}
+
+// Gamepad
+
+bool Input::isGamepadConnected(int gamepad) {
+    return validGamepad(gamepad) && context().gamepadConnected[gamepad];
+}
+
+float Input::getGamepadAxis(int axis, int gamepad) {
+    if (!validGamepad(gamepad) || axis < 0 || axis >= kGamepadAxes) return 0.0f;
+    return context().gamepadPolled[gamepad].axes[axis];
+}
+
+bool Input::isGamepadButtonDown(int button, int gamepad) {
+    return validGamepadButton(button, gamepad) && activeState().gamepad.down[gamepadBit(button, gamepad)];
+}
+
+bool Input::isGamepadButtonPressed(int button, int gamepad) {
+    return validGamepadButton(button, gamepad) && activeState().gamepad.pressed[gamepadBit(button, gamepad)];
+}
+
+bool Input::isGamepadButtonReleased(int button, int gamepad) {
+    return validGamepadButton(button, gamepad) && activeState().gamepad.released[gamepadBit(button, gamepad)];
 }
+
+} // namespace froggi
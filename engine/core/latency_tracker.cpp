@@ -0,0 +1,241 @@
+#include "latency_tracker.h"
+#include "cvar.h"
+#include "log.h"
+#include "metrics.h"
+#include <GLFW/glfw3.h>
+#include <imgui.h>
+#include <algorithm>
+#include <fstream>
+
+namespace froggi {
+
+static AutoCVarBool cv_latencyEnabled("latency.enabled",
+    "Track input-to-photon latency and publish it as latency.* metrics", false);
+static AutoCVarBool cv_latencyWindow("latency.window", "Show the input latency window", false, CVarFlag_NoSave);
+
+namespace {
+
+constexpr size_t kStageCount = static_cast<size_t>(LatencyStage::Count);
+constexpr size_t kHistorySize = LatencyTracker::kMaxSamples;
+
+const char* kStageNames[kStageCount] = {
+    "Update", "FixedStep", "Submit", "Present", "GpuDone"
+};
+
+struct LatencySample {
+    uint64_t frame = UINT64_MAX;
+    double inputTime = 0.0;                 // 0 = no input this frame
+    double stageTime[kStageCount] = {};     // 0 = stage not reached (yet)
+};
+
+// Indexed by frame % kHistorySize
+LatencySample g_samples[kHistorySize];
+uint64_t g_frameIndex = 0;
+bool g_inFrame = false;
+
+// Input-to-stage stats over the history, refreshed once per sampled frame
+struct StageMetrics {
+    MetricGauge minMs;
+    MetricGauge avgMs;
+    MetricGauge p99Ms;
+};
+
+StageMetrics g_stageMetrics[kStageCount] = {
+    { MetricGauge("latency.update.min_ms"), MetricGauge("latency.update.avg_ms"),
+      MetricGauge("latency.update.p99_ms") },
+    { MetricGauge("latency.fixed_step.min_ms"), MetricGauge("latency.fixed_step.avg_ms"),
+      MetricGauge("latency.fixed_step.p99_ms") },
+    { MetricGauge("latency.submit.min_ms"), MetricGauge("latency.submit.avg_ms"),
+      MetricGauge("latency.submit.p99_ms") },
+    { MetricGauge("latency.present.min_ms"), MetricGauge("latency.present.avg_ms"),
+      MetricGauge("latency.present.p99_ms") },
+    { MetricGauge("latency.gpu_done.min_ms"), MetricGauge("latency.gpu_done.avg_ms"),
+      MetricGauge("latency.gpu_done.p99_ms") },
+};
+
+// Scratch for percentile computation (no per-call allocation)
+float g_scratch[kHistorySize];
+
+LatencySample* sampleFor(uint64_t frame) {
+    LatencySample& sample = g_samples[frame % kHistorySize];
+    return sample.frame == frame ? &sample : nullptr;
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// LatencyTracker Implementation
+
+const char* latencyStageName(LatencyStage stage) {
+    size_t index = static_cast<size_t>(stage);
+    return index < kStageCount ? kStageNames[index] : "Unknown";
+}
+
+void LatencyTracker::setEnabled(bool enabled) {
+    cv_latencyEnabled.set(enabled);
+    g_inFrame = false;
+}
+
+bool LatencyTracker::isEnabled() {
+    return cv_latencyEnabled.get();
+}
+
+uint64_t LatencyTracker::beginFrame(double inputTime) {
+    // The CVar may flip from the console at any time; stages only count
+    // for frames begun while enabled
+    if (!cv_latencyEnabled.get()) {
+        g_inFrame = false;
+        return g_frameIndex;
+    }
+
+    // Earlier frames' stages have landed by now (GpuDone within one frame)
+    if (inputTime != 0.0) publishMetrics();
+
+    uint64_t frame = ++g_frameIndex;
+    LatencySample& sample = g_samples[frame % kHistorySize];
+    sample = LatencySample{};
+    sample.frame = frame;
+    sample.inputTime = inputTime;
+    sample.stageTime[static_cast<size_t>(LatencyStage::Update)] = glfwGetTime();
+    g_inFrame = true;
+    return frame;
+}
+
+void LatencyTracker::mark(LatencyStage stage) {
+    if (!g_inFrame) return;
+    markFrame(g_frameIndex, stage, glfwGetTime());
+}
+
+void LatencyTracker::markFrame(uint64_t frame, LatencyStage stage, double time) {
+    LatencySample* sample = sampleFor(frame);
+    if (!sample) return;
+    double& slot = sample->stageTime[static_cast<size_t>(stage)];
+    if (slot == 0.0) slot = time;
+}
+
+uint64_t LatencyTracker::getCurrentFrame() {
+    return g_frameIndex;
+}
+
+LatencyStats LatencyTracker::getStats(LatencyStage stage) {
+    LatencyStats stats;
+    size_t stageIndex = static_cast<size_t>(stage);
+
+    size_t count = 0;
+    double sum = 0.0;
+    for (const LatencySample& sample : g_samples) {
+        if (sample.frame == UINT64_MAX || sample.inputTime == 0.0) continue;
+        double time = sample.stageTime[stageIndex];
+        if (time == 0.0) continue;
+        float ms = static_cast<float>((time - sample.inputTime) * 1000.0);
+        g_scratch[count++] = ms;
+        sum += ms;
+    }
+    if (count == 0) return stats;
+
+    std::sort(g_scratch, g_scratch + count);
+    size_t p99 = (count * 99 + 99) / 100 - 1;   // ceil(0.99 * count) - 1
+
+    stats.samples = static_cast<uint32_t>(count);
+    stats.minMs = g_scratch[0];
+    stats.maxMs = g_scratch[count - 1];
+    stats.avgMs = static_cast<float>(sum / static_cast<double>(count));
+    stats.p99Ms = g_scratch[std::min(p99, count - 1)];
+    return stats;
+}
+
+void LatencyTracker::publishMetrics() {
+    for (size_t i = 0; i < kStageCount; ++i) {
+        LatencyStats stats = getStats(static_cast<LatencyStage>(i));
+        if (stats.samples == 0) continue;
+        g_stageMetrics[i].minMs.set(stats.minMs);
+        g_stageMetrics[i].avgMs.set(stats.avgMs);
+        g_stageMetrics[i].p99Ms.set(stats.p99Ms);
+    }
+}
+
+bool LatencyTracker::exportCsv(const std::string& path) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        FROGGI_LOG_ERROR(Engine, "[LatencyTracker] Could not write %s", path.c_str());
+        return false;
+    }
+
+    file << "frame";
+    for (size_t i = 0; i < kStageCount; ++i) {
+        file << "," << kStageNames[i] << "_ms";
+    }
+    file << "\n";
+
+    // Oldest first; skip frames without input
+    size_t written = 0;
+    uint64_t first = g_frameIndex >= kHistorySize ? g_frameIndex - kHistorySize + 1 : 1;
+    for (uint64_t frame = first; frame <= g_frameIndex; ++frame) {
+        const LatencySample* sample = sampleFor(frame);
+        if (!sample || sample->inputTime == 0.0) continue;
+        file << frame;
+        for (size_t i = 0; i < kStageCount; ++i) {
+            file << ",";
+            if (sample->stageTime[i] != 0.0) {
+                file << (sample->stageTime[i] - sample->inputTime) * 1000.0;
+            }
+        }
+        file << "\n";
+        written++;
+    }
+
+    FROGGI_LOG_INFO(Engine, "[LatencyTracker] Exported %zu frames to %s", written, path.c_str());
+    return true;
+}
+
+void LatencyTracker::setWindowVisible(bool visible) {
+    cv_latencyWindow.set(visible);
+}
+
+bool LatencyTracker::isWindowVisible() {
+    return cv_latencyWindow.get();
+}
+
+void LatencyTracker::drawDebugWindow() {
+    if (!cv_latencyWindow.get()) return;
+
+    bool open = true;
+    bool expanded = ImGui::Begin("Input Latency", &open);
+    if (!open) cv_latencyWindow.set(false);
+    if (!expanded) {
+        ImGui::End();
+        return;
+    }
+
+    bool enabled = cv_latencyEnabled.get();
+    if (ImGui::Checkbox("Enabled", &enabled)) {
+        setEnabled(enabled);
+    }
+
+    if (ImGui::BeginTable("latency", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("Input ->");
+        ImGui::TableSetupColumn("Min ms");
+        ImGui::TableSetupColumn("Avg ms");
+        ImGui::TableSetupColumn("P99 ms");
+        ImGui::TableSetupColumn("Samples");
+        ImGui::TableHeadersRow();
+        for (size_t i = 0; i < kStageCount; ++i) {
+            LatencyStats stats = getStats(static_cast<LatencyStage>(i));
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(kStageNames[i]);
+            ImGui::TableNextColumn(); ImGui::Text("%.2f", stats.minMs);
+            ImGui::TableNextColumn(); ImGui::Text("%.2f", stats.avgMs);
+            ImGui::TableNextColumn(); ImGui::Text("%.2f", stats.p99Ms);
+            ImGui::TableNextColumn(); ImGui::Text("%u", stats.samples);
+        }
+        ImGui::EndTable();
+    }
+
+    if (ImGui::Button("Export CSV")) {
+        exportCsv("input_latency.csv");
+    }
+
+    ImGui::End();
+}
+
+} // namespace froggi
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace froggi {
+
+///////////////////////////////////////////////////////////////////////////////
+// Latency Stages - Points an input event passes on its way to the screen
+
+enum class LatencyStage : uint8_t {
+    Update = 0,     // Input::update consumed the event
+    FixedStep,      // first fixed step of the frame ran
+    Submit,         // command buffer submitted
+    Present,        // swap chain present returned
+    GpuDone,        // queue reported the frame's work done
+    Count
+};
+
+const char* latencyStageName(LatencyStage stage);
+
+struct LatencyStats {
+    uint32_t samples = 0;
+    float minMs = 0.0f;
+    float avgMs = 0.0f;
+    float p99Ms = 0.0f;
+    float maxMs = 0.0f;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// LatencyTracker - Input-to-photon latency instrumentation
+//
+// Each frame that consumed input carries the timestamp of its oldest input
+// event through the frame; every stage stores glfwGetTime() when it is
+// reached. GpuDone comes from Queue::onSubmittedWorkDone, whose callback
+// only fires when the device is polled, so it is an upper bound with up to
+// one frame of slack. Emscripten builds don't record GpuDone: the browser
+// runs the callback only after the frame has returned to its event loop.
+// Frames without input events are not sampled.
+//
+// Off by default: latency.enabled turns it on (console or --latency.enabled=1)
+// and latency.window (F4) shows its ImGui window. While enabled, min/avg/p99
+// of every stage are published as latency.<stage>.{min,avg,p99}_ms gauges.
+
+class LatencyTracker {
+public:
+    static constexpr size_t kMaxSamples = 256;
+
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    /**
+     * Start a frame (called by Engine right after Input::update)
+     * @param inputTime Input::getFrameEventTime() for this frame
+     * @return Frame id used to report later stages
+     */
+    static uint64_t beginFrame(double inputTime);
+
+    /**
+     * Record that a stage of the current frame was reached (first call wins)
+     */
+    static void mark(LatencyStage stage);
+
+    /**
+     * Record a stage for an older frame (used by GPU work-done callbacks)
+     */
+    static void markFrame(uint64_t frame, LatencyStage stage, double time);
+
+    static uint64_t getCurrentFrame();
+
+    /**
+     * Input-to-stage latency over the sampled history
+     */
+    static LatencyStats getStats(LatencyStage stage);
+
+    /**
+     * Set the latency.* gauges from getStats() of every stage (done by
+     * beginFrame for frames with input)
+     */
+    static void publishMetrics();
+
+    /**
+     * Write per-frame stage latencies as CSV
+     * @return true if the file was written
+     */
+    static bool exportCsv(const std::string& path);
+
+    // ImGui window (drawn by the renderer inside the UI pass)
+    static void setWindowVisible(bool visible);
+    static bool isWindowVisible();
+    static void drawDebugWindow();
+};
+
+} // namespace froggi
@@ -0,0 +1,361 @@
+#include "log.h"
+#include "cvar.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace froggi {
+
+static AutoCVarInt cv_logLevel("log.level",
+    "Minimum log level: 0 = Trace, 1 = Debug, 2 = Info, 3 = Warn, 4 = Error, 5 = Off", 2, 0, 5);
+static AutoCVarInt cv_logRateLimit("log.rateLimit",
+    "Messages per call site per second before repeats are suppressed (0 = unlimited)", 20, 0, 10000);
+static AutoCVarString cv_logFile("log.file",
+    "Log file written by the log thread (empty = console only)", "");
+
+namespace {
+
+constexpr size_t kCategoryCount = static_cast<size_t>(LogCategory::Count);
+constexpr size_t kRingCapacity = 256;       // records per thread
+constexpr size_t kMaxMessageLength = 480;
+
+const char* kLevelNames[] = { "Trace", "Debug", "Info", "Warn", "Error", "Off" };
+
+const char* kCategoryNames[kCategoryCount] = {
+    "General", "Engine", "Renderer", "Physics", "Animation", "Assets", "Input", "Game", "Network"
+};
+
+struct LogRecord {
+    double time;
+    LogLevel level;
+    LogCategory category;
+    uint16_t length;
+    char text[kMaxMessageLength];
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Per-thread rings (single producer: the owning thread, single consumer:
+// whoever holds g_drainMutex)
+
+struct LogRing {
+    LogRecord records[kRingCapacity];
+    std::atomic<uint64_t> head{0};      // written by the producer
+    std::atomic<uint64_t> tail{0};      // written by the consumer
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<bool> inUse{false};
+};
+
+std::mutex& ringMutex() {
+    static std::mutex instance;
+    return instance;
+}
+
+std::vector<std::unique_ptr<LogRing>>& rings() {
+    static std::vector<std::unique_ptr<LogRing>> instance;
+    return instance;
+}
+
+LogRing* acquireRing() {
+    std::lock_guard<std::mutex> lock(ringMutex());
+    for (auto& ring : rings()) {
+        bool expected = false;
+        if (ring->inUse.compare_exchange_strong(expected, true)) return ring.get();
+    }
+    rings().push_back(std::make_unique<LogRing>());
+    rings().back()->inUse.store(true);
+    return rings().back().get();
+}
+
+struct RingOwner {
+    LogRing* ring = nullptr;
+    ~RingOwner() {
+        if (ring) ring->inUse.store(false, std::memory_order_release);
+    }
+};
+
+thread_local RingOwner t_ringOwner;
+
+LogRing& localRing() {
+    if (!t_ringOwner.ring) t_ringOwner.ring = acquireRing();
+    return *t_ringOwner.ring;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// State
+
+std::atomic<int> g_level{static_cast<int>(LogLevel::Info)};
+std::atomic<uint32_t> g_categoryMask{0xFFFFFFFFu};
+std::atomic<int> g_rateLimit{20};
+uint32_t g_levelVersion = UINT32_MAX;
+uint32_t g_rateLimitVersion = UINT32_MAX;
+uint32_t g_fileVersion = UINT32_MAX;
+
+std::mutex g_lifetimeMutex;
+int g_initCount = 0;                    // one per running engine
+std::thread g_writerThread;
+std::atomic<bool> g_writerRunning{false};
+bool g_writerStop = false;
+std::mutex g_wakeMutex;
+std::condition_variable g_wakeCondition;
+
+// Consumer side (drain)
+std::mutex g_drainMutex;
+struct DrainRange {
+    LogRing* ring;
+    uint64_t end;
+};
+std::vector<LogRecord*> g_batch;
+std::vector<DrainRange> g_ranges;
+std::ofstream g_file;
+uint64_t g_reportedDrops = 0;
+
+double now() {
+    static const auto start = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool push(LogLevel level, LogCategory category, const char* format, va_list args) {
+    LogRing& ring = localRing();
+    uint64_t head = ring.head.load(std::memory_order_relaxed);
+    if (head - ring.tail.load(std::memory_order_acquire) >= kRingCapacity) {
+        ring.dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    LogRecord& record = ring.records[head % kRingCapacity];
+    record.time = now();
+    record.level = level;
+    record.category = category;
+    int length = vsnprintf(record.text, sizeof(record.text), format, args);
+    record.length = static_cast<uint16_t>(std::clamp(length, 0, int(kMaxMessageLength - 1)));
+    ring.head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+bool pushf(LogLevel level, LogCategory category, const char* format, ...) FROGGI_PRINTF_FORMAT(3, 4);
+bool pushf(LogLevel level, LogCategory category, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    bool pushed = push(level, category, format, args);
+    va_end(args);
+    return pushed;
+}
+
+void writeRecord(const LogRecord& record) {
+    std::ostream& console = record.level >= LogLevel::Warn ? std::cerr : std::cout;
+    console.write(record.text, record.length);
+    console.put('\n');
+
+    if (g_file.is_open()) {
+        char prefix[64];
+        snprintf(prefix, sizeof(prefix), "%10.4f %-5s %-9s ", record.time,
+                 kLevelNames[static_cast<size_t>(record.level)],
+                 kCategoryNames[static_cast<size_t>(record.category)]);
+        g_file << prefix;
+        g_file.write(record.text, record.length);
+        g_file.put('\n');
+    }
+}
+
+void drain() {
+    std::lock_guard<std::mutex> drainLock(g_drainMutex);
+
+    // Gather everything published so far, then write in time order
+    uint64_t dropped = 0;
+    g_batch.clear();
+    g_ranges.clear();
+    {
+        std::lock_guard<std::mutex> lock(ringMutex());
+        for (auto& ring : rings()) {
+            dropped += ring->dropped.load(std::memory_order_relaxed);
+            uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+            uint64_t head = ring->head.load(std::memory_order_acquire);
+            if (tail == head) continue;
+            for (uint64_t i = tail; i < head; ++i) {
+                g_batch.push_back(&ring->records[i % kRingCapacity]);
+            }
+            g_ranges.push_back({ ring.get(), head });
+        }
+    }
+
+    std::stable_sort(g_batch.begin(), g_batch.end(),
+                     [](const LogRecord* a, const LogRecord* b) { return a->time < b->time; });
+    for (const LogRecord* record : g_batch) {
+        writeRecord(*record);
+    }
+
+    if (dropped > g_reportedDrops) {
+        std::cerr << "[Log] " << (dropped - g_reportedDrops) << " messages dropped (ring buffer full)\n";
+        g_reportedDrops = dropped;
+    }
+
+    std::cout.flush();
+    std::cerr.flush();
+    if (g_file.is_open()) g_file.flush();
+
+    // Release the slots only after the records were written
+    for (const DrainRange& range : g_ranges) {
+        range.ring->tail.store(range.end, std::memory_order_release);
+    }
+}
+
+void writerMain() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(g_wakeMutex);
+            g_wakeCondition.wait_for(lock, std::chrono::milliseconds(5), [] { return g_writerStop; });
+            if (g_writerStop) break;
+        }
+        drain();
+    }
+    drain();
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// Log Implementation
+
+const char* logLevelName(LogLevel level) {
+    size_t index = static_cast<size_t>(level);
+    return index < std::size(kLevelNames) ? kLevelNames[index] : "Unknown";
+}
+
+const char* logCategoryName(LogCategory category) {
+    size_t index = static_cast<size_t>(category);
+    return index < kCategoryCount ? kCategoryNames[index] : "Unknown";
+}
+
+void Log::init() {
+    std::lock_guard<std::mutex> lifetimeLock(g_lifetimeMutex);
+    if (g_initCount++ > 0) return;
+    update();
+    g_writerStop = false;
+    g_writerThread = std::thread(writerMain);
+    g_writerRunning.store(true);
+}
+
+void Log::shutdown() {
+    std::lock_guard<std::mutex> lifetimeLock(g_lifetimeMutex);
+    if (g_initCount == 0 || --g_initCount > 0) return;
+    {
+        std::lock_guard<std::mutex> lock(g_wakeMutex);
+        g_writerStop = true;
+    }
+    g_wakeCondition.notify_one();
+    g_writerThread.join();
+    g_writerRunning.store(false);
+
+    std::lock_guard<std::mutex> drainLock(g_drainMutex);
+    if (g_file.is_open()) g_file.close();
+    g_fileVersion = UINT32_MAX;
+}
+
+void Log::flush() {
+    drain();
+}
+
+void Log::update() {
+    if (g_levelVersion != cv_logLevel.version()) {
+        g_levelVersion = cv_logLevel.version();
+        setLevel(static_cast<LogLevel>(cv_logLevel.get()));
+    }
+    if (g_rateLimitVersion != cv_logRateLimit.version()) {
+        g_rateLimitVersion = cv_logRateLimit.version();
+        g_rateLimit.store(cv_logRateLimit.get(), std::memory_order_relaxed);
+    }
+    if (g_fileVersion != cv_logFile.version()) {
+        g_fileVersion = cv_logFile.version();
+        std::lock_guard<std::mutex> drainLock(g_drainMutex);
+        if (g_file.is_open()) g_file.close();
+        if (!cv_logFile.get().empty()) {
+            g_file.open(cv_logFile.get(), std::ios::trunc);
+            if (!g_file.is_open()) {
+                std::cerr << "[Log] Could not write " << cv_logFile.get() << std::endl;
+            }
+        }
+    }
+}
+
+void Log::setLevel(LogLevel level) {
+    g_level.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+LogLevel Log::getLevel() {
+    return static_cast<LogLevel>(g_level.load(std::memory_order_relaxed));
+}
+
+void Log::setCategoryEnabled(LogCategory category, bool enabled) {
+    uint32_t bit = 1u << static_cast<uint32_t>(category);
+    if (enabled) {
+        g_categoryMask.fetch_or(bit, std::memory_order_relaxed);
+    } else {
+        g_categoryMask.fetch_and(~bit, std::memory_order_relaxed);
+    }
+}
+
+bool Log::isEnabled(LogLevel level, LogCategory category) {
+    return static_cast<int>(level) >= g_level.load(std::memory_order_relaxed) &&
+           (g_categoryMask.load(std::memory_order_relaxed) & (1u << static_cast<uint32_t>(category))) != 0;
+}
+
+void Log::write(LogSite* site, LogLevel level, LogCategory category, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    writeV(site, level, category, format, args);
+    va_end(args);
+}
+
+void Log::writeV(LogSite* site, LogLevel level, LogCategory category, const char* format, va_list args) {
+    // Rate limit per call site over one-second windows
+    int limit = g_rateLimit.load(std::memory_order_relaxed);
+    if (site && limit > 0) {
+        double time = now();
+        if (time - site->windowStart.load(std::memory_order_relaxed) >= 1.0) {
+            site->windowStart.store(time, std::memory_order_relaxed);
+            site->count.store(0, std::memory_order_relaxed);
+            uint32_t suppressed = site->suppressed.exchange(0, std::memory_order_relaxed);
+            if (suppressed > 0) {
+                pushf(LogLevel::Warn, category, "[Log] %u repeats suppressed from %s:%d",
+                      suppressed, site->file, site->line);
+            }
+        }
+        uint32_t count = site->count.fetch_add(1, std::memory_order_relaxed);
+        if (count >= static_cast<uint32_t>(limit)) {
+            if (count == static_cast<uint32_t>(limit)) {
+                pushf(LogLevel::Warn, category, "[Log] Rate limit reached, suppressing repeats from %s:%d",
+                      site->file, site->line);
+            }
+            site->suppressed.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    push(level, category, format, args);
+
+    if (!g_writerRunning.load(std::memory_order_acquire)) {
+        drain();
+    } else if (level >= LogLevel::Error) {
+        g_wakeCondition.notify_one();
+    }
+}
+
+uint64_t Log::getDroppedCount() {
+    uint64_t dropped = 0;
+    std::lock_guard<std::mutex> lock(ringMutex());
+    for (auto& ring : rings()) {
+        dropped += ring->dropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+}
+
+} // namespace froggi
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <atomic>
+#include <cstdarg>
+#include <cstdint>
+
+namespace froggi {
+
+///////////////////////////////////////////////////////////////////////////////
+// Log Levels and Categories
+
+enum class LogLevel : uint8_t {
+    Trace = 0,
+    Debug,
+    Info,
+    Warn,
+    Error,
+    Off
+};
+
+enum class LogCategory : uint8_t {
+    General = 0,
+    Engine,
+    Renderer,
+    Physics,
+    Animation,
+    Assets,
+    Input,
+    Game,
+    Network,
+    Count
+};
+
+const char* logLevelName(LogLevel level);
+const char* logCategoryName(LogCategory category);
+
+// Levels below this are compiled out (set through the FROGGI_LOG_LEVEL CMake option)
+#ifndef FROGGI_LOG_MIN_LEVEL
+#define FROGGI_LOG_MIN_LEVEL 0
+#endif
+
+constexpr bool isLogLevelCompiled(int level) {
+    return level >= FROGGI_LOG_MIN_LEVEL;
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+#define FROGGI_PRINTF_FORMAT(fmtIndex, argIndex) __attribute__((format(printf, fmtIndex, argIndex)))
+#else
+#define FROGGI_PRINTF_FORMAT(fmtIndex, argIndex)
+#endif
+
+/**
+ * Per call-site state for rate limiting (declared by the FROGGI_LOG macros)
+ */
+struct LogSite {
+    const char* file;
+    int line;
+    std::atomic<double> windowStart{0.0};
+    std::atomic<uint32_t> count{0};
+    std::atomic<uint32_t> suppressed{0};
+
+    LogSite(const char* f, int l) : file(f), line(l) {}
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Log - Asynchronous logger
+//
+// Messages are formatted on the calling thread into that thread's ring
+// buffer (single producer, no locks, never blocks: a full ring drops the
+// message and counts it). A background thread drains all rings, orders the
+// records by time and writes them to stdout/stderr and the optional log
+// file. Before init() and after shutdown() records are written
+// synchronously so startup and teardown messages are never lost.
+// init()/shutdown() are counted, so every engine in the process can pair
+// them; the writer stops with the last shutdown().
+//
+// CVars: log.level, log.rateLimit (messages per call site per second),
+// log.file
+
+class Log {
+public:
+    static void init();
+    static void shutdown();
+
+    /**
+     * Write out everything logged so far (blocks until done)
+     */
+    static void flush();
+
+    /**
+     * Pick up CVar changes (called by Engine once per frame)
+     */
+    static void update();
+
+    static void setLevel(LogLevel level);
+    static LogLevel getLevel();
+    static void setCategoryEnabled(LogCategory category, bool enabled);
+
+    static bool isEnabled(LogLevel level, LogCategory category);
+
+    static void write(LogSite* site, LogLevel level, LogCategory category,
+                      const char* format, ...) FROGGI_PRINTF_FORMAT(4, 5);
+    static void writeV(LogSite* site, LogLevel level, LogCategory category,
+                       const char* format, va_list args);
+
+    /**
+     * Messages lost to full ring buffers since startup
+     */
+    static uint64_t getDroppedCount();
+};
+
+} // namespace froggi
+
+///////////////////////////////////////////////////////////////////////////////
+// Logging Macros (printf-style)
+
+#define FROGGI_LOG(Level, Category, ...)                                                        \
+    do {                                                                                        \
+        if constexpr (froggi::isLogLevelCompiled(static_cast<int>(froggi::LogLevel::Level))) {  \
+            if (froggi::Log::isEnabled(froggi::LogLevel::Level, froggi::LogCategory::Category)) {\
+                static froggi::LogSite froggiLogSite(__FILE__, __LINE__);                       \
+                froggi::Log::write(&froggiLogSite, froggi::LogLevel::Level,                     \
+                                   froggi::LogCategory::Category, __VA_ARGS__);                 \
+            }                                                                                   \
+        }                                                                                       \
+    } while (0)
+
+#define FROGGI_LOG_TRACE(Category, ...) FROGGI_LOG(Trace, Category, __VA_ARGS__)
+#define FROGGI_LOG_DEBUG(Category, ...) FROGGI_LOG(Debug, Category, __VA_ARGS__)
+#define FROGGI_LOG_INFO(Category, ...)  FROGGI_LOG(Info, Category, __VA_ARGS__)
+#define FROGGI_LOG_WARN(Category, ...)  FROGGI_LOG(Warn, Category, __VA_ARGS__)
+#define FROGGI_LOG_ERROR(Category, ...) FROGGI_LOG(Error, Category, __VA_ARGS__)
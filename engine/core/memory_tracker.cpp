@@ -0,0 +1,383 @@
+#include "memory_tracker.h"
+#include "log.h"
+
+#include <imgui.h>
+#include <atomic>
+#include <cfloat>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+
+namespace froggi {
+
+namespace {
+
+constexpr size_t kTagCount = static_cast<size_t>(MemoryTag::Count);
+constexpr size_t kHistorySize = 600;
+
+const char* kTagNames[kTagCount] = {
+    "General", "Engine", "Game", "Renderer", "Physics", "Animation", "Assets"
+};
+
+#ifdef FROGGI_TRACK_ALLOCATIONS
+
+// Header stored in front of every tracked block so delete knows the size,
+// the owning tag and the pointer malloc actually returned
+struct alignas(16) AllocHeader {
+    void* raw;
+    uint64_t size;
+    uint32_t tag;
+    uint32_t magic;
+};
+static_assert(sizeof(AllocHeader) == 32, "AllocHeader must keep 16-byte alignment");
+
+constexpr uint32_t kHeaderMagic = 0xF0661A11u;
+
+struct TagCounters {
+    std::atomic<uint64_t> frameAllocs{0};
+    std::atomic<uint64_t> frameBytes{0};
+    std::atomic<uint64_t> liveBytes{0};
+    std::atomic<uint64_t> peakBytes{0};
+};
+
+// Constant-initialized: operator new can run before any dynamic initializer
+TagCounters g_tags[kTagCount];
+std::atomic<uint64_t> g_frees{0};
+std::atomic<uint64_t> g_liveTotal{0};
+std::atomic<uint64_t> g_peakTotal{0};
+
+thread_local MemoryTag t_currentTag = MemoryTag::General;
+
+void raiseToPeak(std::atomic<uint64_t>& peak, uint64_t value) {
+    uint64_t current = peak.load(std::memory_order_relaxed);
+    while (value > current &&
+           !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+void* trackedAlloc(std::size_t size, std::size_t alignment) {
+    if (alignment < alignof(AllocHeader)) alignment = alignof(AllocHeader);
+
+    void* raw = std::malloc(size + sizeof(AllocHeader) + alignment);
+    if (!raw) return nullptr;
+
+    uintptr_t user = reinterpret_cast<uintptr_t>(raw) + sizeof(AllocHeader);
+    user = (user + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+
+    AllocHeader* header = reinterpret_cast<AllocHeader*>(user) - 1;
+    header->raw = raw;
+    header->size = size;
+    header->tag = static_cast<uint32_t>(t_currentTag);
+    header->magic = kHeaderMagic;
+
+    TagCounters& counters = g_tags[header->tag];
+    counters.frameAllocs.fetch_add(1, std::memory_order_relaxed);
+    counters.frameBytes.fetch_add(size, std::memory_order_relaxed);
+    raiseToPeak(counters.peakBytes,
+                counters.liveBytes.fetch_add(size, std::memory_order_relaxed) + size);
+    raiseToPeak(g_peakTotal, g_liveTotal.fetch_add(size, std::memory_order_relaxed) + size);
+
+    return reinterpret_cast<void*>(user);
+}
+
+void trackedFree(void* ptr) {
+    if (!ptr) return;
+
+    AllocHeader* header = static_cast<AllocHeader*>(ptr) - 1;
+    if (header->magic != kHeaderMagic) {
+        // Not ours (allocated before the hooks were linked in) - leak rather than corrupt
+        return;
+    }
+    header->magic = 0;
+
+    g_tags[header->tag].liveBytes.fetch_sub(header->size, std::memory_order_relaxed);
+    g_liveTotal.fetch_sub(header->size, std::memory_order_relaxed);
+    g_frees.fetch_add(1, std::memory_order_relaxed);
+
+    std::free(header->raw);
+}
+
+void* trackedAllocOrThrow(std::size_t size, std::size_t alignment) {
+    void* ptr = trackedAlloc(size, alignment);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+#endif // FROGGI_TRACK_ALLOCATIONS
+
+// Frame history (main thread only)
+MemoryFrameStats g_history[kHistorySize];
+size_t g_historyHead = 0;
+size_t g_historyCount = 0;
+MemoryFrameStats g_lastFrame;
+uint64_t g_frameIndex = 0;
+
+// Budget
+uint64_t g_budgetAllocs = 0;
+uint64_t g_budgetBytes = 0;
+uint32_t g_warmupFrames = 120;
+uint32_t g_framesSinceReset = 0;
+bool g_testMode = false;
+bool g_violation = false;
+uint32_t g_violationReports = 0;
+
+bool g_windowVisible = true;
+
+void formatBytes(char* out, size_t outSize, uint64_t bytes) {
+    if (bytes >= 1024ull * 1024ull) {
+        std::snprintf(out, outSize, "%.2f MB", static_cast<double>(bytes) / (1024.0 * 1024.0));
+    } else if (bytes >= 1024ull) {
+        std::snprintf(out, outSize, "%.1f KB", static_cast<double>(bytes) / 1024.0);
+    } else {
+        std::snprintf(out, outSize, "%llu B", static_cast<unsigned long long>(bytes));
+    }
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// MemoryTracker Implementation
+
+const char* memoryTagName(MemoryTag tag) {
+    size_t index = static_cast<size_t>(tag);
+    return index < kTagCount ? kTagNames[index] : "Unknown";
+}
+
+bool MemoryTracker::isEnabled() {
+#ifdef FROGGI_TRACK_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+void MemoryTracker::endFrame() {
+#ifdef FROGGI_TRACK_ALLOCATIONS
+    MemoryFrameStats stats;
+    stats.frame = g_frameIndex++;
+
+    for (size_t i = 0; i < kTagCount; ++i) {
+        TagCounters& counters = g_tags[i];
+        MemoryTagStats& tag = stats.tags[i];
+        tag.frameAllocs = counters.frameAllocs.exchange(0, std::memory_order_relaxed);
+        tag.frameBytes = counters.frameBytes.exchange(0, std::memory_order_relaxed);
+        tag.liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+        tag.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+
+        stats.allocs += tag.frameAllocs;
+        stats.bytes += tag.frameBytes;
+    }
+    stats.frees = g_frees.exchange(0, std::memory_order_relaxed);
+    stats.liveBytes = g_liveTotal.load(std::memory_order_relaxed);
+    stats.peakBytes = g_peakTotal.load(std::memory_order_relaxed);
+
+    g_lastFrame = stats;
+    g_history[g_historyHead] = stats;
+    g_historyHead = (g_historyHead + 1) % kHistorySize;
+    if (g_historyCount < kHistorySize) g_historyCount++;
+
+    // Budget check (steady-state frames only)
+    if (g_framesSinceReset < g_warmupFrames) {
+        g_framesSinceReset++;
+        return;
+    }
+
+    bool overAllocs = g_budgetAllocs > 0 && stats.allocs > g_budgetAllocs;
+    bool overBytes = g_budgetBytes > 0 && stats.bytes > g_budgetBytes;
+    if (overAllocs || overBytes) {
+        g_violation = true;
+        if (g_violationReports < 10) {
+            g_violationReports++;
+            FROGGI_LOG_WARN(Engine, "[MemoryTracker] Frame %llu over budget: %llu allocs (budget %llu), %llu bytes (budget %llu)",
+                            static_cast<unsigned long long>(stats.frame), static_cast<unsigned long long>(stats.allocs), static_cast<unsigned long long>(g_budgetAllocs),
+                            static_cast<unsigned long long>(stats.bytes), static_cast<unsigned long long>(g_budgetBytes));
+            for (size_t i = 0; i < kTagCount; ++i) {
+                if (stats.tags[i].frameAllocs == 0) continue;
+                FROGGI_LOG_WARN(Engine, "[MemoryTracker]   %s: %llu allocs, %llu bytes", kTagNames[i],
+                                static_cast<unsigned long long>(stats.tags[i].frameAllocs), static_cast<unsigned long long>(stats.tags[i].frameBytes));
+            }
+        }
+    }
+#endif
+}
+
+const MemoryFrameStats& MemoryTracker::getLastFrame() {
+    return g_lastFrame;
+}
+
+void MemoryTracker::setFrameBudget(uint64_t maxAllocs, uint64_t maxBytes, uint32_t warmupFrames) {
+    g_budgetAllocs = maxAllocs;
+    g_budgetBytes = maxBytes;
+    g_warmupFrames = warmupFrames;
+    resetWarmup();
+}
+
+void MemoryTracker::setBudgetTestMode(bool enabled) {
+    g_testMode = enabled;
+}
+
+bool MemoryTracker::isBudgetTestMode() {
+    return g_testMode;
+}
+
+bool MemoryTracker::hasBudgetViolation() {
+    return g_violation;
+}
+
+void MemoryTracker::resetWarmup() {
+    g_framesSinceReset = 0;
+}
+
+bool MemoryTracker::exportCsv(const std::string& path) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        FROGGI_LOG_ERROR(Engine, "[MemoryTracker] Could not write %s", path.c_str());
+        return false;
+    }
+
+    file << "frame,allocs,bytes,frees,live_bytes,peak_bytes";
+    for (size_t i = 0; i < kTagCount; ++i) {
+        file << "," << kTagNames[i] << "_allocs," << kTagNames[i] << "_bytes,"
+             << kTagNames[i] << "_live";
+    }
+    file << "\n";
+
+    size_t start = (g_historyHead + kHistorySize - g_historyCount) % kHistorySize;
+    for (size_t n = 0; n < g_historyCount; ++n) {
+        const MemoryFrameStats& s = g_history[(start + n) % kHistorySize];
+        file << s.frame << "," << s.allocs << "," << s.bytes << "," << s.frees << ","
+             << s.liveBytes << "," << s.peakBytes;
+        for (size_t i = 0; i < kTagCount; ++i) {
+            file << "," << s.tags[i].frameAllocs << "," << s.tags[i].frameBytes << ","
+                 << s.tags[i].liveBytes;
+        }
+        file << "\n";
+    }
+
+    FROGGI_LOG_INFO(Engine, "[MemoryTracker] Exported %zu frames to %s", g_historyCount, path.c_str());
+    return true;
+}
+
+void MemoryTracker::setWindowVisible(bool visible) {
+    g_windowVisible = visible;
+}
+
+void MemoryTracker::drawDebugWindow() {
+#ifdef FROGGI_TRACK_ALLOCATIONS
+    if (!g_windowVisible) return;
+
+    if (!ImGui::Begin("Memory", &g_windowVisible)) {
+        ImGui::End();
+        return;
+    }
+
+    const MemoryFrameStats& s = g_lastFrame;
+    char live[32], peak[32], frameBytes[32];
+    formatBytes(live, sizeof(live), s.liveBytes);
+    formatBytes(peak, sizeof(peak), s.peakBytes);
+    formatBytes(frameBytes, sizeof(frameBytes), s.bytes);
+
+    ImGui::Text("Frame %llu: %llu allocs (%s)", static_cast<unsigned long long>(s.frame),
+                static_cast<unsigned long long>(s.allocs), frameBytes);
+    ImGui::Text("Live: %s  Peak: %s", live, peak);
+
+    if (g_budgetAllocs > 0 || g_budgetBytes > 0) {
+        ImGui::Text("Budget: %llu allocs / %llu bytes%s",
+                    static_cast<unsigned long long>(g_budgetAllocs),
+                    static_cast<unsigned long long>(g_budgetBytes),
+                    g_framesSinceReset < g_warmupFrames ? " (warming up)" : "");
+        if (g_violation) {
+            ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "Budget exceeded");
+        }
+    }
+
+    ImGui::PlotLines("##allocs",
+        [](void*, int idx) -> float {
+            size_t start = (g_historyHead + kHistorySize - g_historyCount) % kHistorySize;
+            return static_cast<float>(g_history[(start + idx) % kHistorySize].allocs);
+        },
+        nullptr, static_cast<int>(g_historyCount), 0, "allocs/frame", 0.0f, FLT_MAX, ImVec2(0, 40));
+
+    if (ImGui::BeginTable("memtags", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("Tag");
+        ImGui::TableSetupColumn("Allocs");
+        ImGui::TableSetupColumn("Bytes");
+        ImGui::TableSetupColumn("Live");
+        ImGui::TableSetupColumn("Peak");
+        ImGui::TableHeadersRow();
+        for (size_t i = 0; i < kTagCount; ++i) {
+            const MemoryTagStats& tag = s.tags[i];
+            char bytes[32], tagLive[32], tagPeak[32];
+            formatBytes(bytes, sizeof(bytes), tag.frameBytes);
+            formatBytes(tagLive, sizeof(tagLive), tag.liveBytes);
+            formatBytes(tagPeak, sizeof(tagPeak), tag.peakBytes);
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(kTagNames[i]);
+            ImGui::TableNextColumn(); ImGui::Text("%llu", static_cast<unsigned long long>(tag.frameAllocs));
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(bytes);
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(tagLive);
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(tagPeak);
+        }
+        ImGui::EndTable();
+    }
+
+    if (ImGui::Button("Export CSV")) {
+        exportCsv("memory_frames.csv");
+    }
+
+    ImGui::End();
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// MemoryScope Implementation
+
+#ifdef FROGGI_TRACK_ALLOCATIONS
+MemoryScope::MemoryScope(MemoryTag tag) : previous(t_currentTag) {
+    t_currentTag = tag;
+}
+
+MemoryScope::~MemoryScope() {
+    t_currentTag = previous;
+}
+#else
+MemoryScope::MemoryScope(MemoryTag tag) : previous(tag) {}
+MemoryScope::~MemoryScope() {}
+#endif
+
+} // namespace froggi
+
+///////////////////////////////////////////////////////////////////////////////
+// Global allocation hooks
+
+#ifdef FROGGI_TRACK_ALLOCATIONS
+
+namespace {
+constexpr std::size_t kDefaultAlign = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+}
+
+void* operator new(std::size_t size) { return froggi::trackedAllocOrThrow(size, kDefaultAlign); }
+void* operator new[](std::size_t size) { return froggi::trackedAllocOrThrow(size, kDefaultAlign); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return froggi::trackedAlloc(size, kDefaultAlign); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return froggi::trackedAlloc(size, kDefaultAlign); }
+void* operator new(std::size_t size, std::align_val_t al) { return froggi::trackedAllocOrThrow(size, static_cast<std::size_t>(al)); }
+void* operator new[](std::size_t size, std::align_val_t al) { return froggi::trackedAllocOrThrow(size, static_cast<std::size_t>(al)); }
+void* operator new(std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept { return froggi::trackedAlloc(size, static_cast<std::size_t>(al)); }
+void* operator new[](std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept { return froggi::trackedAlloc(size, static_cast<std::size_t>(al)); }
+
+void operator delete(void* ptr) noexcept { froggi::trackedFree(ptr); }
+void operator delete[](void* ptr) noexcept { froggi::trackedFree(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { froggi::trackedFree(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { froggi::trackedFree(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { froggi::trackedFree(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { froggi::trackedFree(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { froggi::trackedFree(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { froggi::trackedFree(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { froggi::trackedFree(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { froggi::trackedFree(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { froggi::trackedFree(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { froggi::trackedFree(ptr); }
+
+#endif // FROGGI_TRACK_ALLOCATIONS
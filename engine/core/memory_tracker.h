@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace froggi {
+
+///////////////////////////////////////////////////////////////////////////////
+// Memory Tags - Subsystem that owns an allocation
+
+enum class MemoryTag : uint8_t {
+    General = 0,
+    Engine,
+    Game,
+    Renderer,
+    Physics,
+    Animation,
+    Assets,
+    Count
+};
+
+const char* memoryTagName(MemoryTag tag);
+
+///////////////////////////////////////////////////////////////////////////////
+// Memory Stats
+
+struct MemoryTagStats {
+    uint64_t frameAllocs = 0;   // allocations made during the frame
+    uint64_t frameBytes = 0;    // bytes requested during the frame
+    uint64_t liveBytes = 0;     // bytes currently allocated
+    uint64_t peakBytes = 0;     // highest liveBytes seen so far
+};
+
+struct MemoryFrameStats {
+    uint64_t frame = 0;
+    uint64_t allocs = 0;
+    uint64_t bytes = 0;
+    uint64_t frees = 0;
+    uint64_t liveBytes = 0;
+    uint64_t peakBytes = 0;
+    MemoryTagStats tags[static_cast<size_t>(MemoryTag::Count)];
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// MemoryTracker - Opt-in global allocation tracking
+//
+// Compiled in with FROGGI_TRACK_ALLOCATIONS (CMake option of the same
+// name), which replaces the global operator new/delete. Every allocation
+// is charged to the MemoryTag of the innermost FROGGI_MEMORY_SCOPE on the
+// calling thread. Without the define every call here is a cheap no-op.
+//
+// The Engine sets the frame budget from the mem.frameAllocs, mem.frameBytes,
+// mem.warmupFrames and mem.budgetTest CVars at startup and on scene load,
+// e.g. --mem.frameAllocs=32 --mem.budgetTest=1 fails any steady-state frame
+// making more than 32 allocations.
+
+class MemoryTracker {
+public:
+    /**
+     * True when the allocation hooks are compiled in
+     */
+    static bool isEnabled();
+
+    /**
+     * Close the current frame: snapshot counters into the history,
+     * reset per-frame counts and check the frame budget
+     */
+    static void endFrame();
+
+    /**
+     * Stats of the last completed frame
+     */
+    static const MemoryFrameStats& getLastFrame();
+
+    /**
+     * Frame budget for steady-state frames (0 = unlimited)
+     * @param maxAllocs Allowed allocations per frame
+     * @param maxBytes Allowed bytes per frame
+     * @param warmupFrames Frames to ignore after startup / scene load
+     */
+    static void setFrameBudget(uint64_t maxAllocs, uint64_t maxBytes, uint32_t warmupFrames = 120);
+
+    /**
+     * In test mode a budget violation fails the run (Engine exits with 1)
+     */
+    static void setBudgetTestMode(bool enabled);
+    static bool isBudgetTestMode();
+    static bool hasBudgetViolation();
+
+    /**
+     * Restart the warm-up window (call after loading a scene)
+     */
+    static void resetWarmup();
+
+    /**
+     * Write the frame history as CSV
+     * @return true if the file was written
+     */
+    static bool exportCsv(const std::string& path);
+
+    // ImGui window (drawn by the renderer inside the UI pass)
+    static void setWindowVisible(bool visible);
+    static void drawDebugWindow();
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// MemoryScope - Charges allocations on this thread to a tag
+
+class MemoryScope {
+public:
+    explicit MemoryScope(MemoryTag tag);
+    ~MemoryScope();
+
+    MemoryScope(const MemoryScope&) = delete;
+    MemoryScope& operator=(const MemoryScope&) = delete;
+
+private:
+    MemoryTag previous;
+};
+
+} // namespace froggi
+
+#define FROGGI_MEMORY_CONCAT_INNER(a, b) a##b
+#define FROGGI_MEMORY_CONCAT(a, b) FROGGI_MEMORY_CONCAT_INNER(a, b)
+
+#ifdef FROGGI_TRACK_ALLOCATIONS
+#define FROGGI_MEMORY_SCOPE(tag) \
+    ::froggi::MemoryScope FROGGI_MEMORY_CONCAT(_froggiMemoryScope, __LINE__)(::froggi::MemoryTag::tag)
+#else
+#define FROGGI_MEMORY_SCOPE(tag) ((void)0)
+#endif
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+
+namespace froggi {
+
+///////////////////////////////////////////////////////////////////////////////
+// MeshHandle - Registry slot of a mesh plus the slot's generation
+//
+// Resolved from a mesh name once and then used as a plain array index. A
+// slot's generation changes when its mesh is unloaded, so a handle kept
+// past that is detected as stale instead of drawing whatever mesh reuses
+// the slot. Generation 0 is never handed out: a default handle is invalid.
+
+struct MeshHandle {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool isValid() const { return generation != 0; }
+
+    bool operator==(const MeshHandle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+    bool operator!=(const MeshHandle& other) const { return !(*this == other); }
+};
+
+} // namespace froggi
@@ -0,0 +1,179 @@
+#include "mesh_optimizer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace froggi {
+
+namespace {
+
+constexpr int kCacheSize = 16;          // simulated LRU cache the scores are tuned for
+constexpr uint32_t kNoTriangle = UINT32_MAX;
+
+// Forsyth's vertex score: recently used vertices and vertices with few
+// triangles left score high, so triangles that finish off a vertex go first
+float vertexScore(int cachePosition, uint32_t liveTriangles) {
+    if (liveTriangles == 0) return -1.0f;
+
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3) {
+            // The last triangle's vertices get a fixed, lower score so the
+            // next triangle isn't just its neighbour along the same strip
+            score = 0.75f;
+        } else {
+            float scale = 1.0f - static_cast<float>(cachePosition - 3) / static_cast<float>(kCacheSize - 3);
+            score = std::pow(scale, 1.5f);
+        }
+    }
+    return score + 2.0f / std::sqrt(static_cast<float>(liveTriangles));
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// Vertex cache optimization
+
+void optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount) {
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount < 2 || vertexCount == 0) return;
+
+    // ═══════════════════════════════════════════════════════════════
+    // ADJACENCY (triangles per vertex, compacted as triangles are emitted)
+    // ═══════════════════════════════════════════════════════════════
+    std::vector<uint32_t> live(vertexCount, 0);
+    for (size_t i = 0; i < triangleCount * 3; ++i) live[indices[i]]++;
+
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v) offsets[v + 1] = offsets[v] + live[v];
+
+    std::vector<uint32_t> adjacency(triangleCount * 3);
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        for (int k = 0; k < 3; ++k) adjacency[fill[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+    }
+
+    std::vector<float> vertexScores(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) vertexScores[v] = vertexScore(-1, live[v]);
+
+    std::vector<float> triangleScores(triangleCount);
+    uint32_t current = 0;
+    for (size_t t = 0; t < triangleCount; ++t) {
+        triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] +
+                            vertexScores[indices[t * 3 + 2]];
+        if (triangleScores[t] > triangleScores[current]) current = static_cast<uint32_t>(t);
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // GREEDY EMISSION
+    // ═══════════════════════════════════════════════════════════════
+    std::vector<uint32_t> result;
+    result.reserve(triangleCount * 3);
+    std::vector<uint8_t> emitted(triangleCount, 0);
+
+    uint32_t cache[kCacheSize + 3];
+    uint32_t nextCache[kCacheSize + 3];
+    int cacheCount = 0;
+    size_t cursor = 0;
+
+    while (current != kNoTriangle) {
+        const uint32_t a = indices[current * 3];
+        const uint32_t b = indices[current * 3 + 1];
+        const uint32_t c = indices[current * 3 + 2];
+        result.push_back(a);
+        result.push_back(b);
+        result.push_back(c);
+        emitted[current] = 1;
+
+        // The triangle's vertices move to the front of the cache
+        int nextCount = 0;
+        nextCache[nextCount++] = a;
+        nextCache[nextCount++] = b;
+        nextCache[nextCount++] = c;
+        for (int i = 0; i < cacheCount; ++i) {
+            uint32_t v = cache[i];
+            if (v != a && v != b && v != c) nextCache[nextCount++] = v;
+        }
+
+        for (uint32_t v : { a, b, c }) {
+            uint32_t* begin = &adjacency[offsets[v]];
+            uint32_t* end = begin + live[v];
+            uint32_t* it = std::find(begin, end, current);
+            if (it != end) {
+                *it = *(end - 1);
+                live[v]--;
+            }
+        }
+
+        // Rescore everything that was or is in the cache; vertices pushed
+        // past the end drop back to their valence score
+        for (int i = 0; i < nextCount; ++i) {
+            uint32_t v = nextCache[i];
+            float score = vertexScore(i < kCacheSize ? i : -1, live[v]);
+            float delta = score - vertexScores[v];
+            vertexScores[v] = score;
+            for (uint32_t k = 0; k < live[v]; ++k) triangleScores[adjacency[offsets[v] + k]] += delta;
+        }
+
+        // Best triangle touching the cache
+        current = kNoTriangle;
+        float bestScore = -1.0f;
+        cacheCount = std::min(nextCount, kCacheSize);
+        for (int i = 0; i < cacheCount; ++i) {
+            uint32_t v = nextCache[i];
+            cache[i] = v;
+            for (uint32_t k = 0; k < live[v]; ++k) {
+                uint32_t t = adjacency[offsets[v] + k];
+                if (triangleScores[t] > bestScore) {
+                    bestScore = triangleScores[t];
+                    current = t;
+                }
+            }
+        }
+
+        // Nothing left around the cache: continue in input order
+        if (current == kNoTriangle) {
+            while (cursor < triangleCount && emitted[cursor]) cursor++;
+            if (cursor < triangleCount) current = static_cast<uint32_t>(cursor);
+        }
+    }
+
+    // Any trailing indices that don't make a whole triangle stay at the end
+    result.insert(result.end(), indices.begin() + static_cast<std::ptrdiff_t>(triangleCount * 3), indices.end());
+    indices.swap(result);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Vertex fetch optimization
+
+size_t buildVertexFetchRemap(std::vector<uint32_t>& remap, const std::vector<uint32_t>& indices,
+                             size_t vertexCount) {
+    remap.assign(vertexCount, kUnusedVertex);
+    uint32_t next = 0;
+    for (uint32_t index : indices) {
+        if (remap[index] == kUnusedVertex) remap[index] = next++;
+    }
+    return next;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Analysis
+
+float analyzeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize) {
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) return 0.0f;
+
+    // A vertex is cached while fewer than cacheSize others were loaded after it
+    std::vector<uint32_t> loadedAt(vertexCount, 0);
+    uint32_t time = cacheSize + 1;
+    size_t misses = 0;
+    for (size_t i = 0; i < triangleCount * 3; ++i) {
+        uint32_t index = indices[i];
+        if (time - loadedAt[index] > cacheSize) {
+            loadedAt[index] = time++;
+            misses++;
+        }
+    }
+    return static_cast<float>(misses) / static_cast<float>(triangleCount);
+}
+
+} // namespace froggi
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace froggi {
+
+///////////////////////////////////////////////////////////////////////////////
+// Mesh Optimizer - Index buffer reordering for indexed triangle lists
+//
+// Loaders run these once per mesh after deduplicating vertices: first the
+// triangles are reordered so the GPU's post-transform cache hits more
+// often, then the vertices are renumbered in the order the new index
+// buffer first touches them so vertex fetches walk memory forwards.
+
+constexpr uint32_t kUnusedVertex = UINT32_MAX;
+
+/**
+ * Reorder triangles for the post-transform vertex cache (Forsyth's
+ * linear-speed algorithm); the vertices themselves are not touched
+ */
+void optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount);
+
+/**
+ * Renumber vertices in first-use order
+ * @param remap Receives old index -> new index (kUnusedVertex if never used)
+ * @return Number of vertices the indices use
+ */
+size_t buildVertexFetchRemap(std::vector<uint32_t>& remap, const std::vector<uint32_t>& indices,
+                             size_t vertexCount);
+
+/**
+ * Average vertex shader invocations per triangle (ACMR) with a FIFO
+ * post-transform cache of cacheSize entries; 3 is no reuse at all
+ */
+float analyzeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize = 16);
+
+} // namespace froggi
@@ -0,0 +1,574 @@
+#include "metrics.h"
+#include "cvar.h"
+#include "log.h"
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace froggi {
+
+static AutoCVarInt cv_metricsInterval("metrics.intervalMs",
+    "Interval between metric publishes in milliseconds", 100, 10, 60000);
+static AutoCVarString cv_metricsMmapPath("metrics.mmapPath",
+    "Shared-memory metrics file for external readers (empty = off)", "");
+static AutoCVarString cv_metricsCsvPath("metrics.csvPath",
+    "CSV metrics stream written by a background thread (empty = off)", "");
+
+namespace {
+
+constexpr size_t kBuckets = kMetricHistogramBuckets;
+
+///////////////////////////////////////////////////////////////////////////////
+// Registry
+
+struct MetricInfo {
+    std::string name;
+    MetricType type = MetricType::Counter;
+    uint16_t slot = 0;              // index into the per-type storage
+    double minValue = 0.0;          // histograms: first bucket bound
+    double invLogRatio = 0.0;       // histograms: 1 / log(bucket ratio)
+    double ratio = 1.0;
+};
+
+struct Registry {
+    std::mutex mutex;
+    MetricInfo infos[kMaxMetrics];
+    std::atomic<uint32_t> count{0};
+    uint16_t counters = 0;
+    uint16_t gauges = 0;
+    uint16_t histograms = 0;
+    std::atomic<double> gaugeValues[kMaxMetricGauges];
+};
+
+// Function-local so handles in other translation units can register during
+// static initialization
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Per-thread slabs
+//
+// Only the owning thread writes a slab (relaxed load + store, no RMW), the
+// main thread reads all of them in publish(). Slabs of exited threads are
+// recycled so totals stay monotonic.
+
+struct HistogramSlot {
+    std::atomic<uint64_t> buckets[kBuckets];
+    std::atomic<uint64_t> count;
+    std::atomic<double> sum;
+};
+
+struct ThreadSlab {
+    std::atomic<uint64_t> counters[kMaxMetricCounters];
+    HistogramSlot histograms[kMaxMetricHistograms];
+    std::atomic<bool> inUse;
+};
+
+std::mutex& slabMutex() {
+    static std::mutex instance;
+    return instance;
+}
+
+std::vector<std::unique_ptr<ThreadSlab>>& slabs() {
+    static std::vector<std::unique_ptr<ThreadSlab>> instance;
+    return instance;
+}
+
+ThreadSlab* acquireSlab() {
+    std::lock_guard<std::mutex> lock(slabMutex());
+    for (auto& slab : slabs()) {
+        bool expected = false;
+        if (slab->inUse.compare_exchange_strong(expected, true)) return slab.get();
+    }
+    slabs().push_back(std::make_unique<ThreadSlab>());    // value-initialized (zeroed)
+    slabs().back()->inUse.store(true);
+    return slabs().back().get();
+}
+
+struct SlabOwner {
+    ThreadSlab* slab = nullptr;
+    ~SlabOwner() {
+        if (slab) slab->inUse.store(false, std::memory_order_release);
+    }
+};
+
+thread_local SlabOwner t_slabOwner;
+
+ThreadSlab& localSlab() {
+    if (!t_slabOwner.slab) t_slabOwner.slab = acquireSlab();
+    return *t_slabOwner.slab;
+}
+
+template <typename T>
+void ownerAdd(std::atomic<T>& value, T amount) {
+    value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Aggregation state (main thread only)
+
+struct HistogramTotals {
+    uint64_t buckets[kBuckets] = {};
+    uint64_t count = 0;
+    double sum = 0.0;
+};
+
+HistogramTotals g_previousHistograms[kMaxMetricHistograms];
+std::vector<MetricSnapshot> g_snapshot;
+uint64_t g_snapshotFrame = 0;
+double g_snapshotTime = 0.0;
+double g_lastPublishTime = -1.0;
+uint32_t g_publishedCount = 0;
+
+double bucketUpperBound(const MetricInfo& info, size_t bucket) {
+    if (bucket + 1 >= kBuckets) return info.minValue * std::pow(info.ratio, double(kBuckets - 2));
+    return info.minValue * std::pow(info.ratio, double(bucket));
+}
+
+double percentile(const MetricInfo& info, const uint64_t* buckets, uint64_t count, double fraction) {
+    if (count == 0) return 0.0;
+    uint64_t target = static_cast<uint64_t>(std::ceil(fraction * double(count)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBuckets; ++i) {
+        seen += buckets[i];
+        if (seen >= target) return bucketUpperBound(info, i);
+    }
+    return bucketUpperBound(info, kBuckets - 1);
+}
+
+void collect() {
+    Registry& reg = registry();
+    uint32_t count = reg.count.load(std::memory_order_acquire);
+    g_snapshot.resize(count);
+
+    uint64_t counterTotals[kMaxMetricCounters] = {};
+    static HistogramTotals histogramTotals[kMaxMetricHistograms];
+    for (auto& totals : histogramTotals) totals = HistogramTotals{};
+
+    {
+        std::lock_guard<std::mutex> lock(slabMutex());
+        for (const auto& slab : slabs()) {
+            for (size_t i = 0; i < reg.counters; ++i) {
+                counterTotals[i] += slab->counters[i].load(std::memory_order_relaxed);
+            }
+            for (size_t h = 0; h < reg.histograms; ++h) {
+                const HistogramSlot& slot = slab->histograms[h];
+                for (size_t b = 0; b < kBuckets; ++b) {
+                    histogramTotals[h].buckets[b] += slot.buckets[b].load(std::memory_order_relaxed);
+                }
+                histogramTotals[h].count += slot.count.load(std::memory_order_relaxed);
+                histogramTotals[h].sum += slot.sum.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    for (uint32_t id = 0; id < count; ++id) {
+        const MetricInfo& info = reg.infos[id];
+        MetricSnapshot& out = g_snapshot[id];
+        if (out.name != info.name) out.name = info.name;
+        out.type = info.type;
+
+        switch (info.type) {
+            case MetricType::Counter:
+                out.value = double(counterTotals[info.slot]);
+                break;
+            case MetricType::Gauge:
+                out.value = reg.gaugeValues[info.slot].load(std::memory_order_relaxed);
+                break;
+            case MetricType::Histogram: {
+                // Stats over the samples recorded since the last publish
+                const HistogramTotals& now = histogramTotals[info.slot];
+                HistogramTotals& previous = g_previousHistograms[info.slot];
+                uint64_t interval[kBuckets];
+                for (size_t b = 0; b < kBuckets; ++b) interval[b] = now.buckets[b] - previous.buckets[b];
+                uint64_t samples = now.count - previous.count;
+                double sum = now.sum - previous.sum;
+
+                out.count = double(samples);
+                out.value = samples ? sum / double(samples) : 0.0;
+                out.p50 = percentile(info, interval, samples, 0.50);
+                out.p99 = percentile(info, interval, samples, 0.99);
+                previous = now;
+                break;
+            }
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Shared-memory export
+
+constexpr size_t kSharedFileSize = sizeof(MetricsFileHeader) + kMaxMetrics * sizeof(MetricsFileEntry);
+
+struct SharedFile {
+    std::string path;
+    uint8_t* data = nullptr;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+};
+
+SharedFile g_shared;
+uint32_t g_mmapPathVersion = UINT32_MAX;
+
+void closeSharedFile() {
+    if (!g_shared.data) return;
+#ifdef _WIN32
+    UnmapViewOfFile(g_shared.data);
+    CloseHandle(g_shared.mapping);
+    CloseHandle(g_shared.file);
+    g_shared.mapping = nullptr;
+    g_shared.file = INVALID_HANDLE_VALUE;
+#else
+    munmap(g_shared.data, kSharedFileSize);
+    close(g_shared.fd);
+    g_shared.fd = -1;
+#endif
+    g_shared.data = nullptr;
+    g_shared.path.clear();
+}
+
+bool openSharedFile(const std::string& path) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                              CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, 0,
+                                        static_cast<DWORD>(kSharedFileSize), nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, kSharedFileSize);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    g_shared.file = file;
+    g_shared.mapping = mapping;
+    g_shared.data = static_cast<uint8_t*>(view);
+#else
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+    if (ftruncate(fd, static_cast<off_t>(kSharedFileSize)) != 0) {
+        close(fd);
+        return false;
+    }
+    void* view = mmap(nullptr, kSharedFileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (view == MAP_FAILED) {
+        close(fd);
+        return false;
+    }
+    g_shared.fd = fd;
+    g_shared.data = static_cast<uint8_t*>(view);
+#endif
+    g_shared.path = path;
+
+    std::memset(g_shared.data, 0, kSharedFileSize);
+    MetricsFileHeader* header = new (g_shared.data) MetricsFileHeader;
+    std::memcpy(header->magic, "FROGMET1", sizeof(header->magic));
+    header->version = 1;
+    header->sequence.store(0, std::memory_order_relaxed);
+    return true;
+}
+
+void writeSharedFile() {
+    MetricsFileHeader* header = reinterpret_cast<MetricsFileHeader*>(g_shared.data);
+    MetricsFileEntry* entries = reinterpret_cast<MetricsFileEntry*>(g_shared.data + sizeof(MetricsFileHeader));
+
+    // Seqlock: odd while writing
+    uint64_t sequence = header->sequence.load(std::memory_order_relaxed);
+    header->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    header->entryCount = static_cast<uint32_t>(g_snapshot.size());
+    header->frame = g_snapshotFrame;
+    header->timeSeconds = g_snapshotTime;
+
+    // Names only change when metrics are registered
+    bool writeNames = g_publishedCount != g_snapshot.size();
+    for (size_t i = 0; i < g_snapshot.size(); ++i) {
+        const MetricSnapshot& metric = g_snapshot[i];
+        MetricsFileEntry& entry = entries[i];
+        if (writeNames) {
+            std::memset(entry.name, 0, sizeof(entry.name));
+            std::strncpy(entry.name, metric.name.c_str(), sizeof(entry.name) - 1);
+            entry.type = static_cast<uint32_t>(metric.type);
+        }
+        entry.value = metric.value;
+        entry.count = metric.count;
+        entry.p50 = metric.p50;
+        entry.p99 = metric.p99;
+    }
+
+    header->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// CSV export (background thread)
+
+struct CsvRow {
+    std::string header;     // non-empty when the column set changed
+    uint64_t frame = 0;
+    double time = 0.0;
+    std::vector<double> values;
+};
+
+std::thread g_csvThread;
+std::mutex g_csvMutex;
+std::condition_variable g_csvCondition;
+std::vector<CsvRow> g_csvPending;
+bool g_csvStop = false;
+uint32_t g_csvPathVersion = UINT32_MAX;
+uint32_t g_csvColumnCount = 0;
+
+void csvWriterMain(std::string path) {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.is_open()) {
+        FROGGI_LOG_ERROR(Engine, "[Metrics] Could not write %s", path.c_str());
+    }
+
+    std::vector<CsvRow> batch;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(g_csvMutex);
+            g_csvCondition.wait(lock, [] { return g_csvStop || !g_csvPending.empty(); });
+            batch.swap(g_csvPending);
+            if (batch.empty() && g_csvStop) break;
+        }
+        if (!file.is_open()) {
+            batch.clear();
+            continue;
+        }
+        for (const CsvRow& row : batch) {
+            if (!row.header.empty()) file << row.header << "\n";
+            file << row.frame << "," << row.time;
+            for (double value : row.values) file << "," << value;
+            file << "\n";
+        }
+        file.flush();
+        batch.clear();
+    }
+}
+
+void stopCsvWriter() {
+    if (!g_csvThread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(g_csvMutex);
+        g_csvStop = true;
+    }
+    g_csvCondition.notify_one();
+    g_csvThread.join();
+    g_csvPending.clear();
+    g_csvStop = false;
+}
+
+void startCsvWriter(const std::string& path) {
+    g_csvColumnCount = 0;   // forces a header row
+    g_csvThread = std::thread(csvWriterMain, path);
+}
+
+void queueCsvRow() {
+    CsvRow row;
+    row.frame = g_snapshotFrame;
+    row.time = g_snapshotTime;
+    row.values.reserve(g_snapshot.size() * 2);
+
+    if (g_csvColumnCount != g_snapshot.size()) {
+        std::ostringstream header;
+        header << "frame,time";
+        for (const MetricSnapshot& metric : g_snapshot) {
+            if (metric.type == MetricType::Histogram) {
+                header << "," << metric.name << ".mean," << metric.name << ".count,"
+                       << metric.name << ".p50," << metric.name << ".p99";
+            } else {
+                header << "," << metric.name;
+            }
+        }
+        row.header = header.str();
+        g_csvColumnCount = static_cast<uint32_t>(g_snapshot.size());
+    }
+
+    for (const MetricSnapshot& metric : g_snapshot) {
+        row.values.push_back(metric.value);
+        if (metric.type == MetricType::Histogram) {
+            row.values.push_back(metric.count);
+            row.values.push_back(metric.p50);
+            row.values.push_back(metric.p99);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(g_csvMutex);
+        g_csvPending.push_back(std::move(row));
+    }
+    g_csvCondition.notify_one();
+}
+
+void applyCVarChanges() {
+    if (g_mmapPathVersion != cv_metricsMmapPath.version()) {
+        g_mmapPathVersion = cv_metricsMmapPath.version();
+        closeSharedFile();
+        const std::string& path = cv_metricsMmapPath.get();
+        if (!path.empty()) {
+            if (openSharedFile(path)) {
+                FROGGI_LOG_INFO(Engine, "[Metrics] Publishing to shared file %s", path.c_str());
+            } else {
+                FROGGI_LOG_ERROR(Engine, "[Metrics] Could not map %s", path.c_str());
+            }
+        }
+        g_publishedCount = 0;
+    }
+
+    if (g_csvPathVersion != cv_metricsCsvPath.version()) {
+        g_csvPathVersion = cv_metricsCsvPath.version();
+        stopCsvWriter();
+        const std::string& path = cv_metricsCsvPath.get();
+        if (!path.empty()) {
+            startCsvWriter(path);
+            FROGGI_LOG_INFO(Engine, "[Metrics] Streaming CSV to %s", path.c_str());
+        }
+    }
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// Metrics Implementation
+
+uint16_t Metrics::registerMetric(const char* name, MetricType type, double minValue, double maxValue) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    uint32_t count = reg.count.load(std::memory_order_relaxed);
+    for (uint32_t id = 0; id < count; ++id) {
+        if (reg.infos[id].name == name && reg.infos[id].type == type) return static_cast<uint16_t>(id);
+    }
+
+    uint16_t* typeCount = nullptr;
+    size_t capacity = 0;
+    switch (type) {
+        case MetricType::Counter:   typeCount = &reg.counters;   capacity = kMaxMetricCounters;   break;
+        case MetricType::Gauge:     typeCount = &reg.gauges;     capacity = kMaxMetricGauges;     break;
+        case MetricType::Histogram: typeCount = &reg.histograms; capacity = kMaxMetricHistograms; break;
+    }
+    if (*typeCount >= capacity) {
+        FROGGI_LOG_WARN(Engine, "[Metrics] Too many metrics of this type, ignoring %s", name);
+        return kInvalidId;
+    }
+
+    MetricInfo& info = reg.infos[count];
+    info.name = name;
+    info.type = type;
+    info.slot = (*typeCount)++;
+
+    if (type == MetricType::Histogram) {
+        if (minValue <= 0.0 || maxValue <= minValue) {
+            FROGGI_LOG_WARN(Engine, "[Metrics] Invalid histogram range for %s, using [0.001, 1000]", name);
+            minValue = 0.001;
+            maxValue = 1000.0;
+        }
+        // Bucket 0: <= min, last bucket: > max, log-spaced in between
+        info.minValue = minValue;
+        info.ratio = std::pow(maxValue / minValue, 1.0 / double(kBuckets - 2));
+        info.invLogRatio = 1.0 / std::log(info.ratio);
+    }
+    if (type == MetricType::Gauge) {
+        reg.gaugeValues[info.slot].store(0.0, std::memory_order_relaxed);
+    }
+
+    reg.count.store(count + 1, std::memory_order_release);
+    return static_cast<uint16_t>(count);
+}
+
+void Metrics::addCounter(uint16_t id, uint64_t amount) {
+    if (id == kInvalidId) return;
+    ownerAdd(localSlab().counters[registry().infos[id].slot], amount);
+}
+
+void Metrics::setGauge(uint16_t id, double value) {
+    if (id == kInvalidId) return;
+    Registry& reg = registry();
+    reg.gaugeValues[reg.infos[id].slot].store(value, std::memory_order_relaxed);
+}
+
+void Metrics::addGauge(uint16_t id, double amount) {
+    if (id == kInvalidId) return;
+    Registry& reg = registry();
+    std::atomic<double>& gauge = reg.gaugeValues[reg.infos[id].slot];
+    double current = gauge.load(std::memory_order_relaxed);
+    while (!gauge.compare_exchange_weak(current, current + amount, std::memory_order_relaxed)) {}
+}
+
+void Metrics::recordHistogram(uint16_t id, double value) {
+    if (id == kInvalidId) return;
+    const MetricInfo& info = registry().infos[id];
+
+    size_t bucket = 0;
+    if (value > info.minValue) {
+        double index = 1.0 + std::floor(std::log(value / info.minValue) * info.invLogRatio);
+        bucket = static_cast<size_t>(std::min(index, double(kBuckets - 1)));
+    }
+
+    HistogramSlot& slot = localSlab().histograms[info.slot];
+    ownerAdd(slot.buckets[bucket], uint64_t(1));
+    ownerAdd(slot.count, uint64_t(1));
+    ownerAdd(slot.sum, value);
+}
+
+void Metrics::publish(uint64_t frame, double timeSeconds) {
+    applyCVarChanges();
+
+    double intervalSeconds = cv_metricsInterval.get() / 1000.0;
+    if (g_lastPublishTime >= 0.0 && timeSeconds - g_lastPublishTime < intervalSeconds) return;
+    g_lastPublishTime = timeSeconds;
+
+    collect();
+    g_snapshotFrame = frame;
+    g_snapshotTime = timeSeconds;
+
+    if (g_shared.data) {
+        writeSharedFile();
+        g_publishedCount = static_cast<uint32_t>(g_snapshot.size());
+    }
+    if (g_csvThread.joinable()) {
+        queueCsvRow();
+    }
+}
+
+void Metrics::shutdown() {
+    stopCsvWriter();
+    closeSharedFile();
+    g_csvPathVersion = UINT32_MAX;
+    g_mmapPathVersion = UINT32_MAX;
+}
+
+std::vector<MetricSnapshot> Metrics::getSnapshot() {
+    return g_snapshot;
+}
+
+} // namespace froggi
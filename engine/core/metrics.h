@@ -0,0 +1,138 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace froggi {
+
+///////////////////////////////////////////////////////////////////////////////
+// Metric Types
+
+enum class MetricType : uint32_t {
+    Counter = 0,    // monotonic total, accumulated per thread
+    Gauge,          // last value set
+    Histogram       // distribution, accumulated per thread
+};
+
+constexpr size_t kMaxMetricCounters = 128;
+constexpr size_t kMaxMetricGauges = 64;
+constexpr size_t kMaxMetricHistograms = 32;
+constexpr size_t kMetricHistogramBuckets = 32;
+constexpr size_t kMaxMetrics = kMaxMetricCounters + kMaxMetricGauges + kMaxMetricHistograms;
+
+struct MetricSnapshot {
+    std::string name;
+    MetricType type = MetricType::Counter;
+    double value = 0.0;     // counter total / gauge value / histogram mean (interval)
+    double count = 0.0;     // histogram samples in the interval
+    double p50 = 0.0;       // histogram percentiles (interval, bucket resolution)
+    double p99 = 0.0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Shared-memory layout (metrics.mmapPath)
+//
+// Readers map the file read-only and use the sequence number as a seqlock:
+// read sequence (must be even), copy the entries, read sequence again and
+// retry if it changed. Entries are plain doubles so any language can read
+// them with a struct unpack.
+
+struct MetricsFileHeader {
+    char magic[8];                      // "FROGMET1"
+    uint32_t version;                   // layout version (1)
+    uint32_t entryCount;
+    std::atomic<uint64_t> sequence;     // odd while the engine is writing
+    uint64_t frame;
+    double timeSeconds;
+};
+
+struct MetricsFileEntry {
+    char name[56];
+    uint32_t type;                      // MetricType
+    uint32_t _padding;
+    double value;
+    double count;
+    double p50;
+    double p99;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Metrics - Registry, aggregation and export
+//
+// Counters and histograms are written to a per-thread slab with relaxed
+// atomic stores (no contention, no locks); publish() sums the slabs on the
+// main thread. Export is driven by CVars:
+//   metrics.mmapPath      shared-memory file rewritten every publish
+//   metrics.csvPath       CSV appended by a background thread
+//   metrics.intervalMs    publish interval
+
+class Metrics {
+public:
+    /**
+     * Aggregate and export if the publish interval elapsed
+     * (called by Engine at the end of every frame)
+     */
+    static void publish(uint64_t frame, double timeSeconds);
+
+    /**
+     * Stop the CSV writer and unmap the shared-memory file
+     */
+    static void shutdown();
+
+    /**
+     * Values of the last publish
+     */
+    static std::vector<MetricSnapshot> getSnapshot();
+
+    // Registration (used by the handle classes below)
+    static uint16_t registerMetric(const char* name, MetricType type,
+                                   double minValue = 0.0, double maxValue = 0.0);
+
+    // Recording (used by the handle classes below)
+    static void addCounter(uint16_t id, uint64_t amount);
+    static void setGauge(uint16_t id, double value);
+    static void addGauge(uint16_t id, double amount);
+    static void recordHistogram(uint16_t id, double value);
+
+    static constexpr uint16_t kInvalidId = 0xFFFF;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Handles - declare at file scope next to the code that records them
+
+class MetricCounter {
+public:
+    explicit MetricCounter(const char* name)
+        : id(Metrics::registerMetric(name, MetricType::Counter)) {}
+    void add(uint64_t amount = 1) { Metrics::addCounter(id, amount); }
+private:
+    uint16_t id;
+};
+
+class MetricGauge {
+public:
+    explicit MetricGauge(const char* name)
+        : id(Metrics::registerMetric(name, MetricType::Gauge)) {}
+    void set(double value) { Metrics::setGauge(id, value); }
+    void add(double amount) { Metrics::addGauge(id, amount); }
+private:
+    uint16_t id;
+};
+
+class MetricHistogram {
+public:
+    /**
+     * @param minValue Upper bound of the first bucket
+     * @param maxValue Lower bound of the last bucket (buckets are log-spaced)
+     */
+    MetricHistogram(const char* name, double minValue, double maxValue)
+        : id(Metrics::registerMetric(name, MetricType::Histogram, minValue, maxValue)) {}
+    void record(double value) { Metrics::recordHistogram(id, value); }
+private:
+    uint16_t id;
+};
+
+} // namespace froggi
@@ -0,0 +1,279 @@
+#include "net_transport.h"
+#include "log.h"
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace froggi {
+
+namespace {
+
+#ifdef _WIN32
+using SocketHandle = SOCKET;
+
+// Winsock is initialized while any socket is open
+std::mutex g_winsockMutex;
+int g_winsockUsers = 0;
+
+bool acquireSockets() {
+    std::lock_guard<std::mutex> lock(g_winsockMutex);
+    if (g_winsockUsers == 0) {
+        WSADATA data;
+        if (WSAStartup(MAKEWORD(2, 2), &data) != 0) return false;
+    }
+    g_winsockUsers++;
+    return true;
+}
+
+void releaseSockets() {
+    std::lock_guard<std::mutex> lock(g_winsockMutex);
+    if (--g_winsockUsers == 0) WSACleanup();
+}
+
+void closeSocket(SocketHandle s) { closesocket(s); }
+int lastSocketError() { return WSAGetLastError(); }
+bool wouldBlock(int error) { return error == WSAEWOULDBLOCK; }
+// ICMP port unreachable from an earlier send, or an interrupted call
+bool isRetryable(int error) { return error == WSAECONNRESET || error == WSAEINTR; }
+#else
+using SocketHandle = int;
+
+bool acquireSockets() { return true; }
+void releaseSockets() {}
+void closeSocket(SocketHandle s) { ::close(s); }
+int lastSocketError() { return errno; }
+bool wouldBlock(int error) { return error == EAGAIN || error == EWOULDBLOCK; }
+// ICMP port unreachable from an earlier send, or an interrupted call
+bool isRetryable(int error) { return error == ECONNREFUSED || error == EINTR; }
+#endif
+
+sockaddr_in toSockaddr(const NetAddress& address) {
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(address.ip);
+    addr.sin_port = htons(address.port);
+    return addr;
+}
+
+NetAddress fromSockaddr(const sockaddr_in& addr) {
+    NetAddress address;
+    address.ip = ntohl(addr.sin_addr.s_addr);
+    address.port = ntohs(addr.sin_port);
+    return address;
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// NetAddress Implementation
+
+std::string NetAddress::toString() const {
+    return std::to_string((ip >> 24) & 0xFF) + "." + std::to_string((ip >> 16) & 0xFF) + "." +
+           std::to_string((ip >> 8) & 0xFF) + "." + std::to_string(ip & 0xFF) + ":" + std::to_string(port);
+}
+
+bool NetAddress::resolve(const std::string& host, uint16_t port, NetAddress& out) {
+    if (!acquireSockets()) return false;
+
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+
+    addrinfo* result = nullptr;
+    bool found = getaddrinfo(host.c_str(), nullptr, &hints, &result) == 0 && result;
+    if (found) {
+        sockaddr_in addr;
+        std::memcpy(&addr, result->ai_addr, sizeof(addr));
+        out = fromSockaddr(addr);
+        out.port = port;
+    }
+    if (result) freeaddrinfo(result);
+
+    releaseSockets();
+    return found;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// UdpTransport Implementation
+
+UdpTransport::~UdpTransport() {
+    close();
+}
+
+bool UdpTransport::open(uint16_t port) {
+    close();
+    if (!acquireSockets()) {
+        FROGGI_LOG_ERROR(Network, "Socket library failed to initialize");
+        return false;
+    }
+
+    SocketHandle s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+#ifdef _WIN32
+    bool created = s != INVALID_SOCKET;
+#else
+    bool created = s >= 0;
+#endif
+    if (!created) {
+        FROGGI_LOG_ERROR(Network, "Failed to create UDP socket");
+        releaseSockets();
+        return false;
+    }
+
+    NetAddress any;
+    any.port = port;
+    sockaddr_in addr = toSockaddr(any);
+    bool ok = bind(s, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0;
+
+#ifdef _WIN32
+    u_long nonBlocking = 1;
+    ok = ok && ioctlsocket(s, FIONBIO, &nonBlocking) == 0;
+#else
+    ok = ok && fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK) == 0;
+#endif
+
+    sockaddr_in bound;
+    socklen_t boundSize = sizeof(bound);
+    ok = ok && getsockname(s, reinterpret_cast<sockaddr*>(&bound), &boundSize) == 0;
+
+    if (!ok) {
+        FROGGI_LOG_ERROR(Network, "Failed to bind UDP port %u", static_cast<unsigned>(port));
+        closeSocket(s);
+        releaseSockets();
+        return false;
+    }
+
+    handle = static_cast<intptr_t>(s);
+    localAddress = fromSockaddr(bound);
+    FROGGI_LOG_INFO(Network, "UDP socket bound to port %u", static_cast<unsigned>(localAddress.port));
+    return true;
+}
+
+void UdpTransport::close() {
+    if (handle == kInvalidHandle) return;
+    closeSocket(static_cast<SocketHandle>(handle));
+    handle = kInvalidHandle;
+    localAddress = NetAddress();
+    releaseSockets();
+}
+
+bool UdpTransport::send(const NetAddress& to, const uint8_t* data, size_t size) {
+    if (handle == kInvalidHandle || size > kMaxPacketSize) return false;
+
+    sockaddr_in addr = toSockaddr(to);
+    auto sent = sendto(static_cast<SocketHandle>(handle), reinterpret_cast<const char*>(data),
+                       static_cast<int>(size), 0, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr));
+    return sent == static_cast<decltype(sent)>(size);
+}
+
+bool UdpTransport::receive(NetAddress& from, std::vector<uint8_t>& packet) {
+    if (handle == kInvalidHandle) return false;
+
+    packet.resize(kMaxPacketSize);
+    sockaddr_in addr;
+    while (true) {
+        socklen_t addrSize = sizeof(addr);
+        auto received = recvfrom(static_cast<SocketHandle>(handle), reinterpret_cast<char*>(packet.data()),
+                                 static_cast<int>(packet.size()), 0, reinterpret_cast<sockaddr*>(&addr), &addrSize);
+        if (received >= 0) {
+            packet.resize(static_cast<size_t>(received));
+            from = fromSockaddr(addr);
+            return true;
+        }
+
+        int error = lastSocketError();
+        if (isRetryable(error)) continue;
+        if (!wouldBlock(error)) {
+            FROGGI_LOG_ERROR(Network, "UDP receive failed (error %d)", error);
+        }
+        break;
+    }
+    packet.clear();
+    return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// LoopbackTransport - Endpoint of a LoopbackNetwork
+
+class LoopbackTransport : public Transport {
+public:
+    LoopbackTransport(LoopbackNetwork* network, const NetAddress& address)
+        : network(network), address(address) {}
+
+    bool send(const NetAddress& to, const uint8_t* data, size_t size) override {
+        if (size > kMaxPacketSize) return false;
+        network->send(address, to, data, size);
+        return true;
+    }
+
+    bool receive(NetAddress& from, std::vector<uint8_t>& packet) override {
+        return network->receive(address, from, packet);
+    }
+
+    NetAddress getLocalAddress() const override { return address; }
+
+private:
+    LoopbackNetwork* network;
+    NetAddress address;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// LoopbackNetwork Implementation
+
+std::unique_ptr<Transport> LoopbackNetwork::createEndpoint(uint16_t port) {
+    NetAddress address;
+    address.ip = kLoopbackIp;
+    address.port = port != 0 ? port : nextPort++;
+    return std::make_unique<LoopbackTransport>(this, address);
+}
+
+void LoopbackNetwork::send(const NetAddress& from, const NetAddress& to, const uint8_t* data, size_t size) {
+    stats.packetsSent++;
+    stats.bytesSent += size;
+
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    if (unit(rng) < conditions.lossRate) {
+        stats.packetsDropped++;
+        return;
+    }
+
+    float delayMs = conditions.latencyMs + (unit(rng) * 2.0f - 1.0f) * conditions.jitterMs;
+    InFlight packet;
+    packet.deliverAt = time + std::max(0.0f, delayMs) * 0.001;
+    packet.from = from;
+    packet.to = to;
+    packet.data.assign(data, data + size);
+    inFlight.push_back(std::move(packet));
+}
+
+bool LoopbackNetwork::receive(const NetAddress& at, NetAddress& from, std::vector<uint8_t>& packet) {
+    // Earliest due packet for this endpoint
+    auto best = inFlight.end();
+    for (auto it = inFlight.begin(); it != inFlight.end(); ++it) {
+        if (it->to != at || it->deliverAt > time) continue;
+        if (best == inFlight.end() || it->deliverAt < best->deliverAt) best = it;
+    }
+    if (best == inFlight.end()) return false;
+
+    from = best->from;
+    packet = std::move(best->data);
+    inFlight.erase(best);
+    stats.packetsDelivered++;
+    return true;
+}
+
+} // namespace froggi
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace froggi {
+
+///////////////////////////////////////////////////////////////////////////////
+// NetAddress - IPv4 address and port (host byte order)
+
+struct NetAddress {
+    uint32_t ip = 0;
+    uint16_t port = 0;
+
+    bool operator==(const NetAddress& other) const { return ip == other.ip && port == other.port; }
+    bool operator!=(const NetAddress& other) const { return !(*this == other); }
+
+    std::string toString() const;
+
+    /**
+     * Parse a dotted IPv4 address or resolve a host name
+     */
+    static bool resolve(const std::string& host, uint16_t port, NetAddress& out);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Transport - Unreliable datagrams
+//
+// Replication only needs fire-and-forget packets: lost snapshots are
+// replaced by newer ones rather than resent. Transports are non-blocking
+// and used from one thread.
+
+class Transport {
+public:
+    static constexpr size_t kMaxPacketSize = 1400;
+
+    virtual ~Transport() = default;
+
+    virtual bool send(const NetAddress& to, const uint8_t* data, size_t size) = 0;
+
+    /**
+     * Pop one received packet
+     * @return false if nothing is waiting
+     */
+    virtual bool receive(NetAddress& from, std::vector<uint8_t>& packet) = 0;
+
+    virtual NetAddress getLocalAddress() const = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// UdpTransport - Non-blocking UDP socket
+
+class UdpTransport : public Transport {
+public:
+    UdpTransport() = default;
+    ~UdpTransport() override;
+
+    UdpTransport(const UdpTransport&) = delete;
+    UdpTransport& operator=(const UdpTransport&) = delete;
+
+    /**
+     * Bind to a port on all interfaces (0 = any free port)
+     */
+    bool open(uint16_t port);
+    void close();
+    bool isOpen() const { return handle != kInvalidHandle; }
+
+    bool send(const NetAddress& to, const uint8_t* data, size_t size) override;
+    bool receive(NetAddress& from, std::vector<uint8_t>& packet) override;
+    NetAddress getLocalAddress() const override { return localAddress; }
+
+private:
+    static constexpr intptr_t kInvalidHandle = -1;
+
+    intptr_t handle = kInvalidHandle;
+    NetAddress localAddress;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// LoopbackNetwork - In-process stand-in for UDP with simulated conditions
+//
+// Endpoints created from one network exchange packets through it. Each
+// packet is dropped with lossRate or delivered after latency +/- jitter on
+// the network's own clock, which the caller advances, so runs with the same
+// seed are reproducible. Packets may arrive reordered when jitter is set.
+
+struct LoopbackConditions {
+    float lossRate = 0.0f;      // 0..1
+    float latencyMs = 0.0f;     // one way
+    float jitterMs = 0.0f;
+};
+
+struct LoopbackStats {
+    uint64_t packetsSent = 0;
+    uint64_t packetsDropped = 0;
+    uint64_t packetsDelivered = 0;
+    uint64_t bytesSent = 0;
+};
+
+class LoopbackNetwork {
+public:
+    explicit LoopbackNetwork(uint32_t seed = 1) : rng(seed) {}
+
+    /**
+     * New endpoint; port 0 picks the next free one. Endpoints must not
+     * outlive the network.
+     */
+    std::unique_ptr<Transport> createEndpoint(uint16_t port = 0);
+
+    void setConditions(const LoopbackConditions& value) { conditions = value; }
+    const LoopbackConditions& getConditions() const { return conditions; }
+
+    void advance(double seconds) { time += seconds; }
+    double now() const { return time; }
+
+    const LoopbackStats& getStats() const { return stats; }
+
+private:
+    friend class LoopbackTransport;
+
+    struct InFlight {
+        double deliverAt;
+        NetAddress from;
+        NetAddress to;
+        std::vector<uint8_t> data;
+    };
+
+    void send(const NetAddress& from, const NetAddress& to, const uint8_t* data, size_t size);
+    bool receive(const NetAddress& at, NetAddress& from, std::vector<uint8_t>& packet);
+
+    static constexpr uint32_t kLoopbackIp = 0x7F000001;    // 127.0.0.1
+
+    LoopbackConditions conditions;
+    LoopbackStats stats;
+    std::mt19937 rng;
+    std::deque<InFlight> inFlight;
+    double time = 0.0;
+    uint16_t nextPort = 40000;
+};
+
+} // namespace froggi
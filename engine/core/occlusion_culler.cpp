@@ -0,0 +1,302 @@
+#include "occlusion_culler.h"
+#include "cvar.h"
+#include "metrics.h"
+#include "worker_pool.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define FROGGI_OCCLUSION_SSE 1
+#include <xmmintrin.h>
+#endif
+
+namespace froggi {
+
+static AutoCVarBool cv_occlusionCull("r.occlusionCull", "Skip objects hidden behind large occluders", true);
+static AutoCVarInt cv_maxOccluders("r.maxOccluders", "Most draw items rasterized as occluders per frame", 256, 0, 4096);
+static AutoCVarFloat cv_occluderMinArea("r.occluderMinArea",
+    "Smallest screen fraction an item's bounds must cover to be an occluder", 0.0002f, 0.0f, 1.0f);
+static AutoCVarInt cv_occlusionThreads("r.occlusionThreads",
+    "Most threads rasterizing occluders (0 = every render worker)", 0, 0, 64);
+
+static MetricGauge metric_occluders("render.occluders");
+static MetricGauge metric_occluderTriangles("render.occluder_triangles");
+
+namespace {
+
+constexpr float kMinW = 1e-5f;              // vertices closer to the eye plane are "behind" it
+constexpr float kDepthBias = 1e-5f;         // keeps occluders from hiding their own bounds
+constexpr size_t kParallelTriangles = 256;  // fewer are rasterized on the calling thread
+constexpr int kMinBandRows = 16;
+
+// Projected box in pixels plus its nearest depth
+struct ScreenBounds {
+    float minX, minY, maxX, maxY;
+    float nearDepth;
+};
+
+bool projectBox(const glm::mat4& viewProjection, const glm::vec3& center, const glm::vec3& extents,
+                ScreenBounds& out) {
+    glm::vec4 c = viewProjection * glm::vec4(center, 1.0f);
+    glm::vec4 ax = viewProjection[0] * extents.x;
+    glm::vec4 ay = viewProjection[1] * extents.y;
+    glm::vec4 az = viewProjection[2] * extents.z;
+
+    out = { FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX, FLT_MAX };
+    for (int corner = 0; corner < 8; ++corner) {
+        glm::vec4 p = c + ((corner & 1) ? ax : -ax) + ((corner & 2) ? ay : -ay) + ((corner & 4) ? az : -az);
+        if (p.w < kMinW) return false;
+
+        float inv = 1.0f / p.w;
+        float x = (p.x * inv * 0.5f + 0.5f) * OcclusionCuller::kWidth;
+        float y = (p.y * inv * 0.5f + 0.5f) * OcclusionCuller::kHeight;
+        out.minX = std::min(out.minX, x);
+        out.maxX = std::max(out.maxX, x);
+        out.minY = std::min(out.minY, y);
+        out.maxY = std::max(out.maxY, y);
+        out.nearDepth = std::min(out.nearDepth, p.z * inv);
+    }
+    return true;
+}
+
+uint32_t levelWidth(size_t level) { return std::max(1u, OcclusionCuller::kWidth >> level); }
+uint32_t levelHeight(size_t level) { return std::max(1u, OcclusionCuller::kHeight >> level); }
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// OcclusionCuller Implementation
+
+void OcclusionCuller::render(const std::vector<DrawItem>& items, const MeshRegistry& meshes,
+                             const glm::mat4& matrix, WorkerPool* pool) {
+    stats = OcclusionStats();
+    viewProjection = matrix;
+    candidates.clear();
+    triangles.clear();
+
+    if (levels.empty()) {
+        for (size_t level = 0;; ++level) {
+            levels.emplace_back(static_cast<size_t>(levelWidth(level)) * levelHeight(level));
+            if (levelWidth(level) == 1 && levelHeight(level) == 1) break;
+        }
+    }
+
+    if (cv_occlusionCull.get() && cv_maxOccluders.get() > 0) {
+        // ═══════════════════════════════════════════════════════════════
+        // OCCLUDER SELECTION (largest opaque items on screen)
+        // ═══════════════════════════════════════════════════════════════
+        const float screenArea = static_cast<float>(kWidth * kHeight);
+        const float minArea = cv_occluderMinArea.get();
+        for (size_t i = 0; i < items.size(); ++i) {
+            const DrawItem& item = items[i];
+            if (draw_key::layer(item.sortKey) != DrawLayer::Opaque) continue;
+            if (meshes.getOccluder(item.mesh).empty()) continue;
+
+            ScreenBounds bounds;
+            if (!projectBox(viewProjection, item.boundsCenter, item.boundsExtents, bounds)) continue;
+            float width = std::min(bounds.maxX, static_cast<float>(kWidth)) - std::max(bounds.minX, 0.0f);
+            float height = std::min(bounds.maxY, static_cast<float>(kHeight)) - std::max(bounds.minY, 0.0f);
+            if (width <= 0.0f || height <= 0.0f) continue;
+
+            float area = width * height / screenArea;
+            if (area >= minArea) candidates.emplace_back(area, static_cast<uint32_t>(i));
+        }
+
+        size_t maxOccluders = static_cast<size_t>(cv_maxOccluders.get());
+        if (candidates.size() > maxOccluders) {
+            std::nth_element(candidates.begin(), candidates.begin() + maxOccluders, candidates.end(),
+                             [](const auto& a, const auto& b) { return a.first > b.first; });
+            candidates.resize(maxOccluders);
+        }
+        stats.occluders = static_cast<uint32_t>(candidates.size());
+
+        setupTriangles(items, meshes);
+    }
+
+    stats.triangles = static_cast<uint32_t>(triangles.size());
+    metric_occluders.set(stats.occluders);
+    metric_occluderTriangles.set(stats.triangles);
+    if (triangles.empty()) return;
+
+    // ═══════════════════════════════════════════════════════════════
+    // RASTERIZATION (row bands, one per thread)
+    // ═══════════════════════════════════════════════════════════════
+    std::fill(levels[0].begin(), levels[0].end(), FLT_MAX);
+
+    size_t maxWorkers = pool ? pool->getWorkerCount() : 1;
+    if (cv_occlusionThreads.get() > 0) maxWorkers = std::min(maxWorkers, static_cast<size_t>(cv_occlusionThreads.get()));
+    size_t workers = triangles.size() < kParallelTriangles ? 1 : std::min<size_t>(maxWorkers, kHeight / kMinBandRows);
+    int band = static_cast<int>((kHeight + workers - 1) / workers);
+
+    auto rasterizeBand = [&](uint32_t w) {
+        int begin = static_cast<int>(w) * band;
+        rasterizeRows(begin, std::min(begin + band, static_cast<int>(kHeight)));
+    };
+    if (workers > 1) {
+        pool->run(static_cast<uint32_t>(workers), rasterizeBand);
+    } else {
+        rasterizeBand(0);
+    }
+    stats.workers = static_cast<uint32_t>(workers);
+
+    buildPyramid();
+}
+
+bool OcclusionCuller::isOccluded(const glm::vec3& center, const glm::vec3& extents) const {
+    if (!hasOccluders()) return false;
+
+    ScreenBounds bounds;
+    if (!projectBox(viewProjection, center, extents, bounds)) return false;
+    if (bounds.maxX < 0.0f || bounds.maxY < 0.0f ||
+        bounds.minX >= static_cast<float>(kWidth) || bounds.minY >= static_cast<float>(kHeight)) {
+        return false;
+    }
+
+    int x0 = std::max(0, static_cast<int>(std::floor(bounds.minX)));
+    int y0 = std::max(0, static_cast<int>(std::floor(bounds.minY)));
+    int x1 = std::min(static_cast<int>(kWidth) - 1, static_cast<int>(std::floor(bounds.maxX)));
+    int y1 = std::min(static_cast<int>(kHeight) - 1, static_cast<int>(std::floor(bounds.maxY)));
+
+    // Finest level where the box spans no more than 8x8 texels
+    size_t level = 0;
+    while (level + 1 < levels.size() && ((x1 >> level) - (x0 >> level) > 7 || (y1 >> level) - (y0 >> level) > 7)) {
+        level++;
+    }
+
+    const std::vector<float>& depth = levels[level];
+    uint32_t width = levelWidth(level);
+    float nearDepth = bounds.nearDepth - kDepthBias;
+    for (int y = y0 >> level; y <= (y1 >> level); ++y) {
+        for (int x = x0 >> level; x <= (x1 >> level); ++x) {
+            if (depth[static_cast<size_t>(y) * width + x] >= nearDepth) return false;
+        }
+    }
+    return true;
+}
+
+void OcclusionCuller::setupTriangles(const std::vector<DrawItem>& items, const MeshRegistry& meshes) {
+    for (const auto& candidate : candidates) {
+        const DrawItem& item = items[candidate.second];
+        const std::vector<glm::vec3>& positions = meshes.getOccluder(item.mesh);
+        glm::mat4 toClip = viewProjection * item.worldMatrix;
+
+        for (size_t t = 0; t + 2 < positions.size(); t += 3) {
+            float x[3], y[3], z[3];
+            bool behind = false;
+            for (int v = 0; v < 3; ++v) {
+                glm::vec4 clip = toClip * glm::vec4(positions[t + v], 1.0f);
+                if (clip.w < kMinW) {
+                    behind = true;
+                    break;
+                }
+                float inv = 1.0f / clip.w;
+                x[v] = (clip.x * inv * 0.5f + 0.5f) * kWidth;
+                y[v] = (clip.y * inv * 0.5f + 0.5f) * kHeight;
+                z[v] = clip.z * inv;
+            }
+            if (behind) continue;
+
+            float area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+            if (std::abs(area) < 1e-6f) continue;
+            if (area < 0.0f) {
+                // Occluders are double-sided; make every triangle counter-clockwise
+                std::swap(x[1], x[2]);
+                std::swap(y[1], y[2]);
+                std::swap(z[1], z[2]);
+                area = -area;
+            }
+
+            ScreenTriangle tri;
+            tri.minX = std::max(0, static_cast<int>(std::floor(std::min({ x[0], x[1], x[2] }))));
+            tri.maxX = std::min(static_cast<int>(kWidth) - 1, static_cast<int>(std::ceil(std::max({ x[0], x[1], x[2] }))));
+            tri.minY = std::max(0, static_cast<int>(std::floor(std::min({ y[0], y[1], y[2] }))));
+            tri.maxY = std::min(static_cast<int>(kHeight) - 1, static_cast<int>(std::ceil(std::max({ y[0], y[1], y[2] }))));
+            if (tri.minX > tri.maxX || tri.minY > tri.maxY) continue;
+            tri.minX &= ~3;     // rows are walked four pixels at a time
+
+            for (int e = 0; e < 3; ++e) {
+                int a = e;
+                int b = (e + 1) % 3;
+                tri.edgeA[e] = y[a] - y[b];
+                tri.edgeB[e] = x[b] - x[a];
+                tri.edgeC[e] = x[a] * y[b] - y[a] * x[b];
+            }
+
+            tri.depthA = ((z[1] - z[0]) * (y[2] - y[0]) - (z[2] - z[0]) * (y[1] - y[0])) / area;
+            tri.depthB = ((z[2] - z[0]) * (x[1] - x[0]) - (z[1] - z[0]) * (x[2] - x[0])) / area;
+            tri.depthC = z[0] - tri.depthA * x[0] - tri.depthB * y[0];
+            triangles.push_back(tri);
+        }
+    }
+}
+
+void OcclusionCuller::rasterizeRows(int rowBegin, int rowEnd) {
+    float* depth = levels[0].data();
+
+    for (const ScreenTriangle& tri : triangles) {
+        int firstRow = std::max(tri.minY, rowBegin);
+        int lastRow = std::min(tri.maxY, rowEnd - 1);
+
+        for (int y = firstRow; y <= lastRow; ++y) {
+            float py = static_cast<float>(y) + 0.5f;
+            float* row = depth + static_cast<size_t>(y) * kWidth;
+#ifdef FROGGI_OCCLUSION_SSE
+            const __m128 offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+            const __m128 zero = _mm_setzero_ps();
+            __m128 a0 = _mm_set1_ps(tri.edgeA[0]), a1 = _mm_set1_ps(tri.edgeA[1]), a2 = _mm_set1_ps(tri.edgeA[2]);
+            __m128 r0 = _mm_set1_ps(tri.edgeB[0] * py + tri.edgeC[0]);
+            __m128 r1 = _mm_set1_ps(tri.edgeB[1] * py + tri.edgeC[1]);
+            __m128 r2 = _mm_set1_ps(tri.edgeB[2] * py + tri.edgeC[2]);
+            __m128 dz = _mm_set1_ps(tri.depthA);
+            __m128 rz = _mm_set1_ps(tri.depthB * py + tri.depthC);
+
+            for (int x = tri.minX; x <= tri.maxX; x += 4) {
+                __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), offsets);
+                __m128 inside = _mm_and_ps(_mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a0, px), r0), zero),
+                                           _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a1, px), r1), zero));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a2, px), r2), zero));
+                if (_mm_movemask_ps(inside) == 0) continue;
+
+                __m128 old = _mm_loadu_ps(row + x);
+                __m128 nearer = _mm_min_ps(old, _mm_add_ps(_mm_mul_ps(dz, px), rz));
+                _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, old)));
+            }
+#else
+            for (int x = tri.minX; x <= tri.maxX; ++x) {
+                float px = static_cast<float>(x) + 0.5f;
+                bool inside = true;
+                for (int e = 0; e < 3 && inside; ++e) {
+                    inside = tri.edgeA[e] * px + tri.edgeB[e] * py + tri.edgeC[e] >= 0.0f;
+                }
+                if (!inside) continue;
+                row[x] = std::min(row[x], tri.depthA * px + tri.depthB * py + tri.depthC);
+            }
+#endif
+        }
+    }
+}
+
+void OcclusionCuller::buildPyramid() {
+    // Each texel keeps the farthest depth of the four below it
+    for (size_t level = 1; level < levels.size(); ++level) {
+        const std::vector<float>& src = levels[level - 1];
+        std::vector<float>& dst = levels[level];
+        uint32_t srcWidth = levelWidth(level - 1);
+        uint32_t srcHeight = levelHeight(level - 1);
+        uint32_t width = levelWidth(level);
+        uint32_t height = levelHeight(level);
+
+        for (uint32_t y = 0; y < height; ++y) {
+            uint32_t sy0 = y * 2;
+            uint32_t sy1 = std::min(sy0 + 1, srcHeight - 1);
+            for (uint32_t x = 0; x < width; ++x) {
+                uint32_t sx0 = x * 2;
+                uint32_t sx1 = std::min(sx0 + 1, srcWidth - 1);
+                dst[y * width + x] = std::max(std::max(src[sy0 * srcWidth + sx0], src[sy0 * srcWidth + sx1]),
+                                              std::max(src[sy1 * srcWidth + sx0], src[sy1 * srcWidth + sx1]));
+            }
+        }
+    }
+}
+
+} // namespace froggi
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "draw_list.h"
+#include <glm/glm.hpp>
+#include <cfloat>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace froggi {
+
+class WorkerPool;
+
+struct OcclusionStats {
+    uint32_t occluders = 0;     // draw items rasterized this frame
+    uint32_t triangles = 0;
+    uint32_t workers = 0;       // threads the rasterizer ran on
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// OcclusionCuller - Software depth buffer of the biggest occluders
+//
+// Every frame the largest opaque on-screen items whose mesh has an occluder
+// triangle list are rasterized (SSE, split into row bands across a worker
+// pool)
+// into a small depth buffer, which is then reduced into a max-depth
+// pyramid. A box is occluded when its nearest point is behind the farthest
+// occluder depth of every pyramid texel it covers. Runs entirely on the
+// CPU, so it works headless.
+//
+// Depth is clip z / w, which grows with distance for both orthographic and
+// perspective projections and either depth range. Occluder triangles with a
+// vertex behind the eye are skipped, and boxes reaching behind it are never
+// occluded, so both only ever make the result more conservative.
+
+class OcclusionCuller {
+public:
+    static constexpr uint32_t kWidth = 256;
+    static constexpr uint32_t kHeight = 128;
+
+    /**
+     * Pick occluders from the (frustum-culled) items, rasterize them and
+     * build the depth pyramid
+     * @param workers nullptr rasterizes on the calling thread
+     */
+    void render(const std::vector<DrawItem>& items, const MeshRegistry& meshes, const glm::mat4& viewProjection,
+                WorkerPool* workers = nullptr);
+
+    /**
+     * Test a world-space box against the last render()
+     */
+    bool isOccluded(const glm::vec3& center, const glm::vec3& extents) const;
+
+    bool hasOccluders() const { return stats.triangles > 0; }
+    const OcclusionStats& getStats() const { return stats; }
+
+    /**
+     * Rasterized depth at a pixel (for debug views and tests)
+     */
+    float getDepth(uint32_t x, uint32_t y) const { return levels.empty() ? FLT_MAX : levels[0][y * kWidth + x]; }
+
+private:
+    // Edge functions and depth plane in pixel coordinates; a pixel center p
+    // is inside when all edges are >= 0, its depth is dot(depth, (p, 1))
+    struct ScreenTriangle {
+        float edgeA[3], edgeB[3], edgeC[3];
+        float depthA, depthB, depthC;
+        int minX, maxX, minY, maxY;
+    };
+
+    void setupTriangles(const std::vector<DrawItem>& items, const MeshRegistry& meshes);
+    void rasterizeRows(int rowBegin, int rowEnd);
+    void buildPyramid();
+
+    glm::mat4 viewProjection = glm::mat4(1.0f);
+    OcclusionStats stats;
+
+    std::vector<std::pair<float, uint32_t>> candidates;    // (screen area, item index)
+    std::vector<ScreenTriangle> triangles;
+    std::vector<std::vector<float>> levels;                 // [0] = full resolution
+};
+
+} // namespace froggi
@@ -0,0 +1,290 @@
+#include "offset_allocator.h"
+#include <algorithm>
+#include <cassert>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace froggi {
+
+namespace {
+
+constexpr uint32_t kMantissaBits = 3;
+constexpr uint32_t kMantissaValue = 1u << kMantissaBits;
+constexpr uint32_t kMantissaMask = kMantissaValue - 1;
+constexpr uint32_t kNotFound = UINT32_MAX;
+
+// Bit scans; value must not be 0
+uint32_t highestSetBit(uint32_t value) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse(&index, value);
+    return static_cast<uint32_t>(index);
+#else
+    return 31u - static_cast<uint32_t>(__builtin_clz(value));
+#endif
+}
+
+uint32_t lowestSetBit(uint32_t value) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return static_cast<uint32_t>(index);
+#else
+    return static_cast<uint32_t>(__builtin_ctz(value));
+#endif
+}
+
+uint32_t lowestSetBitFrom(uint32_t mask, uint32_t first) {
+    if (first >= 32) return kNotFound;
+    uint32_t remaining = mask & (~0u << first);
+    return remaining ? lowestSetBit(remaining) : kNotFound;
+}
+
+// Sizes as small floats: exponent above a 3-bit mantissa, sizes below 8
+// are exact. Rounding up finds a bin whose every range fits a request,
+// rounding down files a free range where it is guaranteed to fit.
+uint32_t binRoundDown(uint32_t size) {
+    if (size < kMantissaValue) return size;
+    uint32_t mantissaStart = highestSetBit(size) - kMantissaBits;
+    uint32_t exponent = mantissaStart + 1;
+    uint32_t mantissa = (size >> mantissaStart) & kMantissaMask;
+    return (exponent << kMantissaBits) | mantissa;
+}
+
+uint32_t binRoundUp(uint32_t size) {
+    if (size < kMantissaValue) return size;
+    uint32_t mantissaStart = highestSetBit(size) - kMantissaBits;
+    uint32_t exponent = mantissaStart + 1;
+    uint32_t mantissa = (size >> mantissaStart) & kMantissaMask;
+    uint32_t lowBits = size & ((1u << mantissaStart) - 1);
+    // A mantissa overflow carries into the exponent, which is what we want
+    return ((exponent << kMantissaBits) + mantissa) + (lowBits ? 1 : 0);
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// Setup
+
+OffsetAllocator::OffsetAllocator(uint32_t size, uint32_t maxAllocations) : maxAllocations(maxAllocations) {
+    reset(size);
+}
+
+void OffsetAllocator::reset(uint32_t newSize) {
+    size = newSize;
+    freeStorage = 0;
+    allocationCount = 0;
+    usedBinsTop = 0;
+    std::fill(std::begin(usedBins), std::end(usedBins), 0);
+    std::fill(std::begin(binHeads), std::end(binHeads), kUnused);
+
+    // Every range, used or free, is a node; nodes are added as needed
+    nodes.clear();
+    freeNodes.clear();
+
+    if (size > 0) insertFreeNode(0, size);
+}
+
+bool OffsetAllocator::resetPacked(uint32_t newSize, const std::vector<uint32_t>& sizes,
+                                  std::vector<Allocation>& allocations) {
+    uint64_t total = 0;
+    for (uint32_t rangeSize : sizes) total += rangeSize;
+    if (total > newSize || sizes.size() + 1 > maxAllocations) return false;
+
+    reset(0);
+    size = newSize;
+    allocations.clear();
+    allocations.reserve(sizes.size());
+
+    // Used nodes chained as neighbours, then one free node for the tail
+    uint32_t offset = 0;
+    uint32_t prev = kUnused;
+    for (uint32_t rangeSize : sizes) {
+        uint32_t nodeIndex = static_cast<uint32_t>(nodes.size());
+        Node& node = nodes.emplace_back();
+        node.offset = offset;
+        node.size = rangeSize;
+        node.used = true;
+        node.neighborPrev = prev;
+        if (prev != kUnused) nodes[prev].neighborNext = nodeIndex;
+        allocations.push_back({ offset, nodeIndex });
+        allocationCount++;
+        prev = nodeIndex;
+        offset += rangeSize;
+    }
+    if (offset < newSize) {
+        uint32_t rest = insertFreeNode(offset, newSize - offset);
+        nodes[rest].neighborPrev = prev;
+        if (prev != kUnused) nodes[prev].neighborNext = rest;
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Allocation
+
+OffsetAllocator::Allocation OffsetAllocator::allocate(uint32_t request) {
+    // Splitting may need a node for the remainder
+    if (request == 0 || (freeNodes.empty() && nodes.size() >= maxAllocations)) return {};
+
+    uint32_t minBin = binRoundUp(request);
+    uint32_t minTop = minBin / kBinsPerLeaf;
+    uint32_t minLeaf = minBin % kBinsPerLeaf;
+
+    // Smallest bin of at least minBin: first in the same top bin, then the
+    // lowest non-empty leaf of any larger top bin
+    uint32_t top = minTop;
+    uint32_t leaf = kNotFound;
+    if (top < kTopBins && (usedBinsTop & (1u << top))) leaf = lowestSetBitFrom(usedBins[top], minLeaf);
+    if (leaf == kNotFound) {
+        top = lowestSetBitFrom(usedBinsTop, minTop + 1);
+        if (top == kNotFound) return {};
+        leaf = lowestSetBit(usedBins[top]);
+    }
+
+    uint32_t bin = top * kBinsPerLeaf + leaf;
+    uint32_t nodeIndex = binHeads[bin];
+    Node& node = nodes[nodeIndex];
+    uint32_t nodeSize = node.size;
+
+    // Pop it off its bin
+    binHeads[bin] = node.binNext;
+    if (node.binNext != kUnused) nodes[node.binNext].binPrev = kUnused;
+    if (binHeads[bin] == kUnused) {
+        usedBins[top] = static_cast<uint8_t>(usedBins[top] & ~(1u << leaf));
+        if (usedBins[top] == 0) usedBinsTop &= ~(1u << top);
+    }
+    freeStorage -= nodeSize;
+
+    node.size = request;
+    node.used = true;
+    node.binPrev = node.binNext = kUnused;
+    allocationCount++;
+
+    // The rest stays free, right after the allocation
+    uint32_t remainder = nodeSize - request;
+    if (remainder > 0) {
+        uint32_t rest = insertFreeNode(nodes[nodeIndex].offset + request, remainder);
+        Node& allocated = nodes[nodeIndex];
+        nodes[rest].neighborPrev = nodeIndex;
+        nodes[rest].neighborNext = allocated.neighborNext;
+        if (allocated.neighborNext != kUnused) nodes[allocated.neighborNext].neighborPrev = rest;
+        allocated.neighborNext = rest;
+    }
+
+    return { nodes[nodeIndex].offset, nodeIndex };
+}
+
+void OffsetAllocator::free(Allocation allocation) {
+    if (allocation.node == kUnused) return;
+    Node& node = nodes[allocation.node];
+    assert(node.used && "OffsetAllocator: double free");
+
+    uint32_t offset = node.offset;
+    uint32_t rangeSize = node.size;
+    uint32_t neighborPrev = node.neighborPrev;
+    uint32_t neighborNext = node.neighborNext;
+
+    // Merge with free neighbours on both sides
+    if (neighborPrev != kUnused && !nodes[neighborPrev].used) {
+        const Node& prev = nodes[neighborPrev];
+        offset = prev.offset;
+        rangeSize += prev.size;
+        uint32_t merged = neighborPrev;
+        neighborPrev = prev.neighborPrev;
+        removeFreeNode(merged);
+    }
+    if (neighborNext != kUnused && !nodes[neighborNext].used) {
+        const Node& next = nodes[neighborNext];
+        rangeSize += next.size;
+        uint32_t merged = neighborNext;
+        neighborNext = next.neighborNext;
+        removeFreeNode(merged);
+    }
+
+    nodes[allocation.node] = Node{};
+    freeNodes.push_back(allocation.node);
+    allocationCount--;
+
+    uint32_t combined = insertFreeNode(offset, rangeSize);
+    nodes[combined].neighborPrev = neighborPrev;
+    nodes[combined].neighborNext = neighborNext;
+    if (neighborPrev != kUnused) nodes[neighborPrev].neighborNext = combined;
+    if (neighborNext != kUnused) nodes[neighborNext].neighborPrev = combined;
+}
+
+uint32_t OffsetAllocator::getAllocationSize(Allocation allocation) const {
+    return allocation.node == kUnused ? 0 : nodes[allocation.node].size;
+}
+
+OffsetAllocator::StorageReport OffsetAllocator::getStorageReport() const {
+    StorageReport report;
+    report.totalFree = freeStorage;
+    if (usedBinsTop == 0) return report;
+
+    // The highest bin only bounds its ranges from below; check each
+    uint32_t top = highestSetBit(usedBinsTop);
+    uint32_t leaf = highestSetBit(usedBins[top]);
+    for (uint32_t i = binHeads[top * kBinsPerLeaf + leaf]; i != kUnused; i = nodes[i].binNext) {
+        report.largestFree = std::max(report.largestFree, nodes[i].size);
+    }
+    return report;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Bins
+
+uint32_t OffsetAllocator::insertFreeNode(uint32_t offset, uint32_t rangeSize) {
+    uint32_t bin = binRoundDown(rangeSize);
+    uint32_t top = bin / kBinsPerLeaf;
+    uint32_t leaf = bin % kBinsPerLeaf;
+    if (binHeads[bin] == kUnused) {
+        usedBins[top] = static_cast<uint8_t>(usedBins[top] | (1u << leaf));
+        usedBinsTop |= 1u << top;
+    }
+
+    uint32_t nodeIndex;
+    if (!freeNodes.empty()) {
+        nodeIndex = freeNodes.back();
+        freeNodes.pop_back();
+    } else {
+        nodeIndex = static_cast<uint32_t>(nodes.size());
+        nodes.emplace_back();
+    }
+
+    Node& node = nodes[nodeIndex];
+    node = Node{};
+    node.offset = offset;
+    node.size = rangeSize;
+    node.binNext = binHeads[bin];
+    if (node.binNext != kUnused) nodes[node.binNext].binPrev = nodeIndex;
+    binHeads[bin] = nodeIndex;
+
+    freeStorage += rangeSize;
+    return nodeIndex;
+}
+
+void OffsetAllocator::removeFreeNode(uint32_t nodeIndex) {
+    const Node& node = nodes[nodeIndex];
+    if (node.binPrev != kUnused) {
+        nodes[node.binPrev].binNext = node.binNext;
+        if (node.binNext != kUnused) nodes[node.binNext].binPrev = node.binPrev;
+    } else {
+        uint32_t bin = binRoundDown(node.size);
+        uint32_t top = bin / kBinsPerLeaf;
+        uint32_t leaf = bin % kBinsPerLeaf;
+        binHeads[bin] = node.binNext;
+        if (node.binNext != kUnused) nodes[node.binNext].binPrev = kUnused;
+        if (binHeads[bin] == kUnused) {
+            usedBins[top] = static_cast<uint8_t>(usedBins[top] & ~(1u << leaf));
+            if (usedBins[top] == 0) usedBinsTop &= ~(1u << top);
+        }
+    }
+
+    freeStorage -= node.size;
+    nodes[nodeIndex] = Node{};
+    freeNodes.push_back(nodeIndex);
+}
+
+} // namespace froggi
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace froggi {
+
+///////////////////////////////////////////////////////////////////////////////
+// OffsetAllocator - TLSF-style allocator of ranges in an abstract heap
+//
+// Hands out [offset, offset + size) ranges of a heap it never touches (here:
+// elements of a GPU buffer). Free ranges are binned by size on a small
+// float scale (3 mantissa bits, so bins are at most 12.5% apart) with a
+// two-level bitmask over the bins, which makes allocate and free O(1).
+// Neighbouring free ranges merge on free.
+//
+// Allocations never move; callers defragment by packing everything into a
+// fresh allocator in offset order (resetPacked, see GeometryBuffer).
+
+class OffsetAllocator {
+public:
+    static constexpr uint32_t kNoSpace = UINT32_MAX;
+
+    struct Allocation {
+        uint32_t offset = kNoSpace;
+        uint32_t node = kNoSpace;       // internal; pass back to free()
+    };
+
+    struct StorageReport {
+        uint32_t totalFree = 0;
+        uint32_t largestFree = 0;
+    };
+
+    explicit OffsetAllocator(uint32_t size = 0, uint32_t maxAllocations = 64 * 1024);
+
+    /**
+     * Forget every allocation and start over with one free range of size
+     */
+    void reset(uint32_t size);
+
+    /**
+     * Start over with ranges of the given sizes back to back from offset 0
+     * and the rest free, for repacking: unlike allocate(), which rounds
+     * requests up to a size bin, this fills the heap exactly
+     * @return false (state unchanged) if the sizes don't fit
+     */
+    bool resetPacked(uint32_t size, const std::vector<uint32_t>& sizes, std::vector<Allocation>& allocations);
+
+    /**
+     * @return offset kNoSpace when no free range is big enough
+     */
+    Allocation allocate(uint32_t size);
+    void free(Allocation allocation);
+
+    uint32_t getSize() const { return size; }
+    uint32_t getAllocationSize(Allocation allocation) const;
+    uint32_t getAllocationCount() const { return allocationCount; }
+    StorageReport getStorageReport() const;
+
+private:
+    static constexpr uint32_t kTopBins = 32;
+    static constexpr uint32_t kBinsPerLeaf = 8;
+    static constexpr uint32_t kLeafBins = kTopBins * kBinsPerLeaf;
+    static constexpr uint32_t kUnused = UINT32_MAX;
+
+    struct Node {
+        uint32_t offset = 0;
+        uint32_t size = 0;
+        uint32_t binPrev = kUnused;         // free ranges of the same bin
+        uint32_t binNext = kUnused;
+        uint32_t neighborPrev = kUnused;    // ranges adjacent in the heap
+        uint32_t neighborNext = kUnused;
+        bool used = false;
+    };
+
+    uint32_t insertFreeNode(uint32_t offset, uint32_t size);
+    void removeFreeNode(uint32_t node);
+
+    uint32_t size = 0;
+    uint32_t maxAllocations = 0;
+    uint32_t freeStorage = 0;
+    uint32_t allocationCount = 0;
+
+    uint32_t usedBinsTop = 0;
+    uint8_t usedBins[kTopBins] = {};
+    uint32_t binHeads[kLeafBins];
+
+    std::vector<Node> nodes;                // added as needed, up to maxAllocations
+    std::vector<uint32_t> freeNodes;        // unused node indices (stack)
+};
+
+} // namespace froggi
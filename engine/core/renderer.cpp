@@ -2,17 +2,26 @@
 #include "resource_manager.h"
 #include "pond_interface.h"
 #include "jolt_debug_renderer.h"
+#include "memory_tracker.h"
+#include "frame_profiler.h"
+#include "latency_tracker.h"
+#include "cvar.h"
+#include "metrics.h"
 
 #include <glfw3webgpu.h>
+#ifdef WEBGPU_BACKEND_WGPU
+#include <webgpu/wgpu.h>
+#endif
 #include <GLFW/glfw3.h>
 
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #define GLM_FORCE_LEFT_HANDED
 #include <glm/glm.hpp>
 #include <glm/ext.hpp>
+#include <algorithm>
 #include <chrono>
-#include <iostream>
 #include <cassert>
+#include <cstring>
 #include <filesystem>
 #include <sstream>
 #include <string>
@@ -33,11 +42,33 @@ using VertexAttributes = resource_manager::VertexAttributes;
 
 // Engine configuration
 constexpr float PI = 3.14159265358979323846f;
-uint32_t renderWidth = 640;
-uint32_t renderHeight = 360;
-float displayWidth = renderWidth;
-float displayHeight = renderHeight;
-bool renderCheck = false;
+constexpr uint64_t kMaxBufferSize = 15000000 * sizeof(VertexAttributes);
+
+static froggi::AutoCVarInt cv_renderWidth("r.width", "Internal render target width", 640, 160, 3840);
+static froggi::AutoCVarInt cv_renderHeight("r.height", "Internal render target height", 360, 90, 2160);
+static froggi::AutoCVarInt cv_presentMode("r.presentMode", "Swap chain present mode: 0 = Fifo, 1 = Immediate, 2 = Mailbox", 0, 0, 2);
+static froggi::AutoCVarBool cv_renderCheck("r.printTiming", "Print render pass timings every 60 frames", false);
+static froggi::AutoCVarInt cv_outlineSamples("r.outlineSamples", "Neighbour samples per pixel for outline detection", 8, 1, 32);
+static froggi::AutoCVarFloat cv_outlineWidth("r.outlineWidth", "Outline sample radius in silhouette pixels", 0.35f, 0.0f, 8.0f);
+static froggi::AutoCVarInt cv_vertexFormat("r.vertexFormat", "Vertex layout of meshes loaded from now on: 0 = float, 1 = compact (8-bit normals), 2 = precise (16-bit normals)", 1, 0, 2);
+static froggi::AutoCVarInt cv_occluderMaxTriangles("r.occluderMaxTriangles", "Meshes with more triangles are never used as occluders", 512, 0, 65536);
+static froggi::AutoCVarInt cv_workerThreads("r.workerThreads", "Background threads for frustum culling and occlusion rasterization (0 = one less than the hardware threads)", 0, 0, 64, froggi::CVarFlag_Restart);
+static froggi::AutoCVarFloat cv_outlineDepthThreshold("r.outlineDepthThreshold", "Depth difference treated as an outline edge", 0.003f, 0.0f, 0.1f);
+
+// r.vertexFormat values; meshes with vertex colors use the layout's color variant
+static const froggi::VertexLayout kVertexFormats[] = {
+    froggi::VertexLayout::Float, froggi::VertexLayout::Compact, froggi::VertexLayout::Precise
+};
+static_assert(froggi::kVertexLayoutCount <= froggi::draw_key::kMaxPipelines, "vertex layouts are draw key pipelines");
+
+static froggi::MetricCounter metric_drawCalls("render.draw_calls");
+static froggi::MetricCounter metric_bindsSkipped("render.binds_skipped");
+static froggi::MetricCounter metric_uploadBytes("render.upload_bytes");
+static froggi::MetricGauge metric_droppedInstances("render.instances_dropped");
+static froggi::MetricGauge metric_meshes("assets.meshes");
+static froggi::MetricGauge metric_geometryBytes("render.geometry_bytes");
+static froggi::MetricGauge metric_geometryUsedBytes("render.geometry_used_bytes");
+static froggi::MetricGauge metric_geometryFragmentation("render.geometry_fragmentation");
 
 namespace froggi {
 
@@ -48,26 +79,36 @@ bool Renderer::init(int width, int height) {
     m_windowWidth = width;
     m_windowHeight = height;
     m_lastTime = static_cast<float>(glfwGetTime());
+    
+    m_renderWidth = static_cast<uint32_t>(cv_renderWidth.get());
+    m_renderHeight = static_cast<uint32_t>(cv_renderHeight.get());
+    m_displayWidth = static_cast<float>(m_renderWidth);
+    m_displayHeight = static_cast<float>(m_renderHeight);
+    m_renderSizeVersion = cv_renderWidth.version() + cv_renderHeight.version();
+    m_presentModeVersion = cv_presentMode.version();
+
+    uint32_t workerThreads = cv_workerThreads.get() > 0 ? static_cast<uint32_t>(cv_workerThreads.get())
+                                                        : WorkerPool::hardwareThreads() - 1;
+    m_workers = std::make_unique<WorkerPool>(workerThreads);
 
     if (!initWindowAndDevice()) return false;
     if (!initSwapChain()) return false;
     if (!initDepthBuffer()) return false;
     if (!initRenderPipeline()) return false;
-    if (!initSilhouettePipeline()) return false;
     if (!initTexture()) return false;
     if (!initGeometry()) return false;
     if (!initUniforms()) return false;
     if (!initBindGroup()) return false;
     if (!initGui()) return false;
     
-    createRenderTarget(renderWidth, renderHeight);
-    createSilhouetteTarget(renderWidth, renderHeight);
+    createRenderTarget(m_renderWidth, m_renderHeight);
+    createSilhouetteTarget(m_renderWidth, m_renderHeight);
     
     if (!initBlitPipeline()) return false;
     if (!initOutlineComposePipeline()) return false;
     if (!initDebugPipeline()) return false; 
     
-    std::cout << "Renderer initialized successfully!" << std::endl;
+    FROGGI_LOG_INFO(Renderer, "Renderer initialized successfully!");
     return true;
 }
 
@@ -77,7 +118,6 @@ void Renderer::shutdown() {
     terminateUniforms();
     terminateGeometry();
     terminateTexture();
-    terminateSilhouettePipeline();
     terminateOutlineComposePipeline();
     terminateRenderPipeline();
     terminateBlitPipeline();
@@ -85,6 +125,7 @@ void Renderer::shutdown() {
     terminateDepthBuffer();
     terminateSwapChain();
     terminateWindowAndDevice();
+    m_workers.reset();
 }
 
 bool Renderer::isRunning() {
@@ -96,7 +137,7 @@ GLFWwindow* Renderer::getWindow() {
 }
 
 float Renderer::getAspectRatio() const {
-    return static_cast<float>(renderWidth) / static_cast<float>(renderHeight);
+    return static_cast<float>(m_renderWidth) / static_cast<float>(m_renderHeight);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -108,7 +149,9 @@ void Renderer::renderScene(Scene* scene,
                            UICallback uiCallback) {
     if (!scene) return;
     
-    auto frameStart = std::chrono::high_resolution_clock::now();
+    FROGGI_PROFILE_ZONE(Render);
+    pollWorkDoneCallbacks();
+    applyCVarChanges();
     
     float currentTime = static_cast<float>(glfwGetTime());
     m_deltaTime = currentTime - m_lastTime;
@@ -122,69 +165,241 @@ void Renderer::renderScene(Scene* scene,
     m_viewMatrix = viewMatrix;
     m_projectionMatrix = projectionMatrix;
 
+    // Extract and cull once; every pass draws from the same list and instances
+    glm::mat4 viewProjection = m_projectionMatrix * m_viewMatrix;
+    m_drawList.extract(scene, m_meshRegistry, viewProjection);
+    m_drawList.cull(Frustum::fromViewProjection(viewProjection), m_workers.get());
+    m_occlusionCuller.render(m_drawList.getItems(), m_meshRegistry, viewProjection, m_workers.get());
+    m_drawList.cullOccluded(m_occlusionCuller);
+    m_drawList.sort();
+    const CullStats& cullStats = m_drawList.getCullStats();
+    FrameProfiler::setCullCounts(cullStats.visible, cullStats.culled, cullStats.occluded);
+    buildInstanceBatches();
+    uploadFrameData();
+
     CommandEncoderDescriptor encoderDesc{};
     encoderDesc.label = "Frame Encoder";
     CommandEncoder encoder = m_device.createCommandEncoder(encoderDesc);
 
-    auto t1 = std::chrono::high_resolution_clock::now();
-    renderSilhouettePass(encoder, scene);
-    auto t2 = std::chrono::high_resolution_clock::now();
+    {
+        FROGGI_PROFILE_ZONE(Silhouette);
+        renderSilhouettePass(encoder);
+    }
     
-    renderMainPass(encoder, scene);
-    auto t3 = std::chrono::high_resolution_clock::now();
+    {
+        FROGGI_PROFILE_ZONE(MainPass);
+        renderMainPass(encoder);
+    }
     
-    renderOutlineComposePass(encoder);
-    auto t4 = std::chrono::high_resolution_clock::now();
+    {
+        FROGGI_PROFILE_ZONE(Outline);
+        renderOutlineComposePass(encoder);
+    }
 
     if (scene && scene->collisionSystem && scene->collisionSystem->isDebugDrawEnabled()) {
+        FROGGI_PROFILE_ZONE(Debug);
         renderDebugPass(encoder, scene);
     }
-    auto t5 = std::chrono::high_resolution_clock::now();
 
     if (uiCallback) {
+        FROGGI_PROFILE_ZONE(UI);
         renderUIPass(encoder, uiCallback);
     }
-    auto t6 = std::chrono::high_resolution_clock::now();
 
-    renderBlitPass(encoder);
-    auto t7 = std::chrono::high_resolution_clock::now();
+    {
+        FROGGI_PROFILE_ZONE(Blit);
+        renderBlitPass(encoder);
+    }
 
     // Submit commands
-    CommandBufferDescriptor cmdDesc{};
-    cmdDesc.label = "Command Buffer";
-    CommandBuffer cmd = encoder.finish(cmdDesc);
-    m_queue.submit(cmd);
-    m_swapChain.present();
-    
-    auto frameEnd = std::chrono::high_resolution_clock::now();
+    {
+        FROGGI_PROFILE_ZONE(Submit);
+        CommandBufferDescriptor cmdDesc{};
+        cmdDesc.label = "Command Buffer";
+        CommandBuffer cmd = encoder.finish(cmdDesc);
+        LatencyTracker::mark(LatencyStage::Submit);
+        m_queue.submit(cmd);
+        
+#ifndef __EMSCRIPTEN__     // no GpuDone on the web, see LatencyTracker
+        if (LatencyTracker::isEnabled()) {
+            uint64_t frame = LatencyTracker::getCurrentFrame();
+            auto fired = std::make_shared<bool>(false);
+            PendingWorkDone pending;
+            pending.fired = fired;
+            pending.handle = m_queue.onSubmittedWorkDone([frame, fired](QueueWorkDoneStatus status) {
+                *fired = true;
+                if (status == QueueWorkDoneStatus::Success) {
+                    LatencyTracker::markFrame(frame, LatencyStage::GpuDone, glfwGetTime());
+                }
+            });
+            m_workDoneCallbacks.push_back(std::move(pending));
+        }
+#endif
+        
+        m_swapChain.present();
+        LatencyTracker::mark(LatencyStage::Present);
+    }
     
-    // Print timing (every 60 frames to avoid spam)
+    // Print timing of the last completed frame (every 60 frames to avoid spam)
     static int frameCount = 0;
     if (++frameCount % 60 == 0) {
-        auto silhouetteTime = std::chrono::duration<float, std::milli>(t2 - t1).count();
-        auto mainTime = std::chrono::duration<float, std::milli>(t3 - t2).count();
-        auto outlineTime = std::chrono::duration<float, std::milli>(t4 - t3).count();
-        auto debugTime = std::chrono::duration<float, std::milli>(t5 - t4).count();
-        auto uiTime = std::chrono::duration<float, std::milli>(t6 - t5).count();
-        auto blitTime = std::chrono::duration<float, std::milli>(t7 - t6).count();
-        auto totalTime = std::chrono::duration<float, std::milli>(frameEnd - frameStart).count();
-    if (renderCheck){
-        std::cout << "\n=== Render Timing ===" << std::endl;
-        std::cout << "Silhouette: " << silhouetteTime << "ms" << std::endl;
-        std::cout << "Main Pass:  " << mainTime << "ms" << std::endl;
-        std::cout << "Outline:    " << outlineTime << "ms" << std::endl;
-        std::cout << "Debug:      " << debugTime << "ms" << std::endl;
-        std::cout << "UI:         " << uiTime << "ms" << std::endl;
-        std::cout << "Blit:       " << blitTime << "ms" << std::endl;
-        std::cout << "TOTAL:      " << totalTime << "ms" << std::endl;
+        const FrameRecord& timing = FrameProfiler::getLastFrame();
+        auto zoneMs = [&timing](ProfileZone zone) { return timing.zoneMs[static_cast<size_t>(zone)]; };
+    if (cv_renderCheck.get()){
+        FROGGI_LOG_INFO(Renderer, "\n=== Render Timing ===\n"
+                        "Silhouette: %gms\nMain Pass:  %gms\nOutline:    %gms\nDebug:      %gms\n"
+                        "UI:         %gms\nBlit:       %gms\nTOTAL:      %gms",
+                        zoneMs(ProfileZone::Silhouette), zoneMs(ProfileZone::MainPass),
+                        zoneMs(ProfileZone::Outline), zoneMs(ProfileZone::Debug),
+                        zoneMs(ProfileZone::UI), zoneMs(ProfileZone::Blit),
+                        zoneMs(ProfileZone::Render));
         }
     }
 }
 
+void Renderer::pollWorkDoneCallbacks() {
+    if (m_workDoneCallbacks.empty()) return;
+    
+    // Work-done callbacks only fire while the device is being polled
+#if defined(WEBGPU_BACKEND_WGPU)
+    wgpuDevicePoll(m_device, false, nullptr);
+#elif defined(WEBGPU_BACKEND_DAWN)
+    m_device.tick();
+#endif
+    
+    // Queues finish work in order; a handle can go once its callback ran
+    while (!m_workDoneCallbacks.empty() && *m_workDoneCallbacks.front().fired) {
+        m_workDoneCallbacks.pop_front();
+    }
+}
+
+void Renderer::uploadBuffer(const wgpu::Buffer& buffer, uint64_t offset, const void* data, size_t size) {
+    m_queue.writeBuffer(buffer, offset, data, size);
+    metric_uploadBytes.add(size);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Instancing
+
+void Renderer::buildInstanceBatches() {
+    m_batches.clear();
+    
+    const std::vector<DrawItem>& items = m_drawList.getItems();
+    size_t drawCount = std::min(items.size(), m_maxInstances);
+    size_t dropped = items.size() - drawCount;
+    // Once per run of overflowing frames; the metric has the per-frame count
+    if (dropped > 0 && m_droppedInstances == 0) {
+        FROGGI_LOG_WARN(Renderer, "%zu visible objects exceed the instance limit of %zu; drawing the first ones",
+                        items.size(), m_maxInstances);
+    }
+    m_droppedInstances = dropped;
+    metric_droppedInstances.set(static_cast<double>(dropped));
+    
+    m_instanceCount = drawCount;
+    reserveInstances(m_instanceCount);
+    
+    // Sorted order: opaque items of a mesh are contiguous, transparent ones
+    // only batch while consecutive back to front
+    for (size_t i = 0; i < drawCount; ++i) {
+        const DrawItem& item = items[i];
+        bool transparent = draw_key::layer(item.sortKey) == DrawLayer::Transparent;
+        Mesh* mesh = &m_meshes[item.mesh];
+        
+        if (m_batches.empty() || m_batches.back().mesh != mesh || m_batches.back().transparent != transparent) {
+            m_batches.push_back({ mesh, static_cast<uint32_t>(i), 0, transparent });
+        }
+        m_batches.back().instanceCount++;
+        
+        InstanceData instance{};
+        instance.modelMatrix = item.worldMatrix * mesh->dequantize;
+        instance.color = item.color;
+        instance.objectId = float(item.objectId) / 255.0f;
+        std::memcpy(m_frameData.data() + m_instanceOffset + i * sizeof(InstanceData),
+                    &instance, sizeof(InstanceData));
+    }
+}
+
+void Renderer::reserveInstances(size_t count) {
+    if (m_frameRing && count <= m_instanceCapacity) return;
+    
+    size_t capacity = std::max<size_t>(m_instanceCapacity, 1024);
+    while (capacity < count) capacity *= 2;
+    capacity = std::min(capacity, m_maxInstances);
+    
+    // Slots start on an offset both binding types accept
+    auto alignUp = [](uint64_t value, uint64_t alignment) { return (value + alignment - 1) / alignment * alignment; };
+    m_instanceOffset = alignUp(sizeof(FrameUniforms), m_storageAlignment);
+    m_frameSlotSize = alignUp(m_instanceOffset + capacity * sizeof(InstanceData),
+                              std::max(m_uniformAlignment, m_storageAlignment));
+    
+    // Frames already submitted keep the old ring alive until they finish
+    if (m_frameRing) m_frameRing.release();
+    
+    BufferDescriptor bufferDesc{};
+    bufferDesc.label = "Frame Ring";
+    bufferDesc.size = m_frameSlotSize * kFramesInFlight;
+    bufferDesc.usage = BufferUsage::CopyDst | BufferUsage::Uniform | BufferUsage::Storage;
+    bufferDesc.mappedAtCreation = false;
+    m_frameRing = m_device.createBuffer(bufferDesc);
+    m_instanceCapacity = capacity;
+    m_frameData.resize(static_cast<size_t>(m_frameSlotSize));
+    
+    // The bind group references the buffer, so it is rebuilt with it
+    createBindGroup();
+    FROGGI_LOG_DEBUG(Renderer, "Frame ring grown to %zu instances per frame", capacity);
+}
+
+void Renderer::createBindGroup() {
+    if (m_bindGroup) m_bindGroup.release();
+    
+    std::vector<BindGroupEntry> bindings(4);
+    bindings[0].binding = 0;
+    bindings[0].buffer = m_frameRing;
+    bindings[0].offset = 0;
+    bindings[0].size = sizeof(FrameUniforms);
+    
+    bindings[1].binding = 1;
+    bindings[1].textureView = m_textureView;
+    
+    bindings[2].binding = 2;
+    bindings[2].sampler = m_sampler;
+    
+    bindings[3].binding = 3;
+    bindings[3].buffer = m_frameRing;
+    bindings[3].offset = 0;
+    bindings[3].size = m_instanceCapacity * sizeof(InstanceData);
+    
+    BindGroupDescriptor bindGroupDesc;
+    bindGroupDesc.layout = m_bindGroupLayout;
+    bindGroupDesc.entryCount = (uint32_t)bindings.size();
+    bindGroupDesc.entries = bindings.data();
+    m_bindGroup = m_device.createBindGroup(bindGroupDesc);
+}
+
+void Renderer::uploadFrameData() {
+    FrameUniforms frame{};
+    frame.projectionMatrix = m_projectionMatrix;
+    frame.viewMatrix = m_viewMatrix;
+    frame.viewProjectionMatrix = m_projectionMatrix * m_viewMatrix;
+    frame.time = m_time;
+    std::memcpy(m_frameData.data(), &frame, sizeof(FrameUniforms));
+    
+    m_frameSlot = (m_frameSlot + 1) % kFramesInFlight;
+    size_t used = static_cast<size_t>(m_instanceOffset) + m_instanceCount * sizeof(InstanceData);
+    uploadBuffer(m_frameRing, m_frameSlot * m_frameSlotSize, m_frameData.data(), used);
+}
+
+void Renderer::bindFrameData(RenderPassEncoder& renderPass) {
+    // Dynamic offsets in binding order: frame uniforms, then instances
+    uint32_t slotOffset = static_cast<uint32_t>(m_frameSlot * m_frameSlotSize);
+    uint32_t offsets[2] = { slotOffset, slotOffset + static_cast<uint32_t>(m_instanceOffset) };
+    renderPass.setBindGroup(0, m_bindGroup, 2, offsets);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Render Passes
 
-void Renderer::renderSilhouettePass(CommandEncoder& encoder, Scene* scene) {
+void Renderer::renderSilhouettePass(CommandEncoder& encoder) {
     RenderPassColorAttachment silhouetteAttachment{};
     silhouetteAttachment.view = m_silhouetteView;
     silhouetteAttachment.loadOp = LoadOp::Clear;
@@ -208,40 +423,11 @@ void Renderer::renderSilhouettePass(CommandEncoder& encoder, Scene* scene) {
     passDesc.depthStencilAttachment = &depthAttachment;
 
     RenderPassEncoder renderPass = encoder.beginRenderPass(passDesc);
-    renderPass.setPipeline(m_silhouettePipeline);
-    
-    // Render all objects with unique IDs for outline detection
-    size_t objectIndex = 0;
-    for (auto* gameObject : scene->gameObjects) {
-        if (!gameObject->active) continue;
-        
-        MeshComponent* meshComp = gameObject->getComponent<MeshComponent>();
-        if (!meshComp || !meshComp->enabled) continue;
-        
-        Mesh* meshData = getMeshByName(meshComp->meshName);
-        if (!meshData) continue;
-        
-        // Update uniforms
-        meshData->uniforms.modelMatrix = gameObject->getWorldTransform();
-        meshData->uniforms.viewMatrix = m_viewMatrix;
-        meshData->uniforms.projectionMatrix = m_projectionMatrix;
-        meshData->uniforms.time = m_time;
-        meshData->uniforms.color = glm::vec4(float(objectIndex + 1) / 255.0f, 0.0f, 0.0f, 1.0f);
-        
-        m_queue.writeBuffer(meshData->uniformBuffer, 0, &meshData->uniforms, sizeof(MyUniforms));
-        
-        renderPass.setBindGroup(0, meshData->bindGroup, 0, nullptr);
-        renderPass.setVertexBuffer(0, meshData->vertexBuffer, 0,
-                                  meshData->vertexCount * sizeof(VertexAttributes));
-        renderPass.draw(meshData->vertexCount, 1, 0, 0);
-        
-        objectIndex++;
-    }
-    
+    drawBatches(renderPass, true);
     renderPass.end();
 }
 
-void Renderer::renderMainPass(CommandEncoder& encoder, Scene* scene) {
+void Renderer::renderMainPass(CommandEncoder& encoder) {
     RenderPassColorAttachment colorAttachment{};
     colorAttachment.view = m_colorView;
     colorAttachment.loadOp = LoadOp::Clear;
@@ -265,34 +451,65 @@ void Renderer::renderMainPass(CommandEncoder& encoder, Scene* scene) {
     passDesc.depthStencilAttachment = &depthAttachment;
 
     RenderPassEncoder renderPass = encoder.beginRenderPass(passDesc);
-    renderPass.setPipeline(m_pipeline);
+    drawBatches(renderPass, false);
+    renderPass.end();
+}
 
-    // Render all game objects with mesh components
-    for (auto* gameObject : scene->gameObjects) {
-        if (!gameObject->active) continue;
+void Renderer::drawBatches(RenderPassEncoder& renderPass, bool silhouette) {
+    // What is bound on this pass; a bind of the same object again is skipped
+    WGPURenderPipeline boundPipeline = nullptr;
+    WGPUBindGroup boundBindGroup = nullptr;
+    WGPUBuffer boundVertexBuffer = nullptr;
+    WGPUBuffer boundIndexBuffer = nullptr;
+    uint32_t skipped = 0;
+    
+    uint64_t vertexTotal = 0;
+    for (const InstanceBatch& batch : m_batches) {
+        const Mesh* meshData = batch.mesh;
         
-        MeshComponent* meshComp = gameObject->getComponent<MeshComponent>();
-        if (!meshComp || !meshComp->enabled) continue;
+        const LayoutPipelines& pipelines = m_layoutPipelines[static_cast<size_t>(meshData->layout)];
+        const RenderPipeline& pipeline = silhouette ? pipelines.silhouette
+                                       : batch.transparent ? pipelines.transparent : pipelines.opaque;
+        if (boundPipeline != static_cast<WGPURenderPipeline>(pipeline)) {
+            renderPass.setPipeline(pipeline);
+            boundPipeline = pipeline;
+        } else {
+            skipped++;
+        }
         
-        Renderer::Mesh* meshData = getMeshByName(meshComp->meshName);
-        if (!meshData) continue;
+        if (boundBindGroup != static_cast<WGPUBindGroup>(m_bindGroup)) {
+            bindFrameData(renderPass);
+            boundBindGroup = m_bindGroup;
+        } else {
+            skipped++;
+        }
+        
+        // Meshes share one buffer per vertex layout / index format, so these
+        // only change along with the pipeline or index format
+        const GeometryBuffer& vertices = m_vertexBuffers[static_cast<size_t>(meshData->layout)];
+        if (boundVertexBuffer != static_cast<WGPUBuffer>(vertices.getBuffer())) {
+            renderPass.setVertexBuffer(0, vertices.getBuffer(), 0, vertices.getByteSize());
+            boundVertexBuffer = vertices.getBuffer();
+        } else {
+            skipped++;
+        }
+        
+        const GeometryBuffer& indices = getIndexBuffer(meshData->indexFormat);
+        if (boundIndexBuffer != static_cast<WGPUBuffer>(indices.getBuffer())) {
+            renderPass.setIndexBuffer(indices.getBuffer(), meshData->indexFormat, 0, indices.getByteSize());
+            boundIndexBuffer = indices.getBuffer();
+        } else {
+            skipped++;
+        }
         
-        // Update uniforms with GameObject's world transform
-        meshData->uniforms.modelMatrix = gameObject->getWorldTransform();
-        meshData->uniforms.viewMatrix = m_viewMatrix;
-        meshData->uniforms.projectionMatrix = m_projectionMatrix;
-        meshData->uniforms.time = m_time;
-        meshData->uniforms.color = meshComp->color;
-
-        m_queue.writeBuffer(meshData->uniformBuffer, 0, &meshData->uniforms, sizeof(MyUniforms));
-
-        renderPass.setBindGroup(0, meshData->bindGroup, 0, nullptr);
-        renderPass.setVertexBuffer(0, meshData->vertexBuffer, 0,
-                                 meshData->vertexCount * sizeof(VertexAttributes));
-        renderPass.draw(meshData->vertexCount, 1, 0, 0);
+        renderPass.drawIndexed(meshData->indexCount, batch.instanceCount, indices.getOffset(meshData->indexRange),
+                               static_cast<int32_t>(vertices.getOffset(meshData->vertexRange)), batch.firstInstance);
+        vertexTotal += static_cast<uint64_t>(meshData->indexCount) * batch.instanceCount;
     }
-
-    renderPass.end();
+    
+    FrameProfiler::addDraws(static_cast<uint32_t>(m_batches.size()), vertexTotal);
+    metric_drawCalls.add(m_batches.size());
+    metric_bindsSkipped.add(skipped);
 }
 
 void Renderer::renderOutlineComposePass(CommandEncoder& encoder) {
@@ -329,7 +546,7 @@ void Renderer::renderUIPass(CommandEncoder& encoder, UICallback uiCallback) {
     ImGuiIO& io = ImGui::GetIO();
     
     // CRITICAL FIX: Override the display size to match render target
-    io.DisplaySize = ImVec2((float)renderWidth, (float)renderHeight);
+    io.DisplaySize = ImVec2((float)m_renderWidth, (float)m_renderHeight);
     io.DisplayFramebufferScale = ImVec2(1.0f, 1.0f);
     io.DeltaTime = m_deltaTime;
     
@@ -342,6 +559,12 @@ void Renderer::renderUIPass(CommandEncoder& encoder, UICallback uiCallback) {
     // Call game's UI rendering
     uiCallback();
     
+    // Engine debug windows
+    MemoryTracker::drawDebugWindow();
+    FrameProfiler::drawDebugWindow();
+    LatencyTracker::drawDebugWindow();
+    CVarRegistry::drawConsole();
+    
     ImGui::Render();
     ImGui_ImplWGPU_RenderDrawData(ImGui::GetDrawData(), renderPass);
     
@@ -350,11 +573,11 @@ void Renderer::renderUIPass(CommandEncoder& encoder, UICallback uiCallback) {
 
 void Renderer::renderBlitPass(CommandEncoder& encoder) {
     // Update zoom uniforms before rendering
-    m_queue.writeBuffer(m_zoomUniformBuffer, 0, &m_zoomUniforms, sizeof(ZoomUniforms));
+    uploadBuffer(m_zoomUniformBuffer, 0, &m_zoomUniforms, sizeof(ZoomUniforms));
     
     TextureView swapView = m_swapChain.getCurrentTextureView();
     if (!swapView) {
-        std::cerr << "Cannot acquire next swap chain texture" << std::endl;
+        FROGGI_LOG_ERROR(Renderer, "Cannot acquire next swap chain texture");
         return;
     }
     
@@ -377,75 +600,168 @@ void Renderer::renderBlitPass(CommandEncoder& encoder) {
 ///////////////////////////////////////////////////////////////////////////////
 // Resource Management
 
-Renderer::Mesh* Renderer::getMeshByName(const std::string& name) {
-    for (auto& mesh : m_meshes) {
-        if (mesh.name == name) {
-            return &mesh;
-        }
-    }
-    return nullptr;
+GeometryBufferStats Renderer::getGeometryStats() const {
+    GeometryBufferStats total;
+    auto accumulate = [&total](const GeometryBuffer& buffer) {
+        GeometryBufferStats stats = buffer.getStats();
+        total.capacityBytes += stats.capacityBytes;
+        total.usedBytes += stats.usedBytes;
+        total.largestFreeBytes = std::max(total.largestFreeBytes, stats.largestFreeBytes);
+        total.ranges += stats.ranges;
+        total.rebuilds += stats.rebuilds;
+        total.fragmentation = std::max(total.fragmentation, stats.fragmentation);
+    };
+    for (const GeometryBuffer& buffer : m_vertexBuffers) accumulate(buffer);
+    for (const GeometryBuffer& buffer : m_indexBuffers) accumulate(buffer);
+    return total;
+}
+
+void Renderer::defragmentGeometry() {
+    for (GeometryBuffer& buffer : m_vertexBuffers) buffer.defragment();
+    for (GeometryBuffer& buffer : m_indexBuffers) buffer.defragment();
+    updateGeometryMetrics();
+}
+
+void Renderer::updateGeometryMetrics() {
+    GeometryBufferStats stats = getGeometryStats();
+    metric_geometryBytes.set(static_cast<double>(stats.capacityBytes));
+    metric_geometryUsedBytes.set(static_cast<double>(stats.usedBytes));
+    metric_geometryFragmentation.set(stats.fragmentation);
 }
 
 bool Renderer::loadMesh(const std::string& name, const std::string& filepath) {
     std::vector<VertexAttributes> vertexData;
-    if (!resource_manager::loadGeometryFromObj(filepath, vertexData)) {
-        std::cerr << "Could not load geometry: " << filepath << std::endl;
+    std::vector<uint32_t> indexData;
+    if (!resource_manager::loadGeometryFromObj(filepath, vertexData, indexData)) {
+        FROGGI_LOG_ERROR(Assets, "Could not load geometry: %s", filepath.c_str());
         return false;
     }
 
     if (vertexData.empty()) {
-        std::cerr << "No vertices loaded from: " << filepath << std::endl;
+        FROGGI_LOG_ERROR(Assets, "No vertices loaded from: %s", filepath.c_str());
         return false;
     }
 
-    BufferDescriptor bufferDesc{};
-    bufferDesc.size = vertexData.size() * sizeof(VertexAttributes);
-    bufferDesc.usage = BufferUsage::CopyDst | BufferUsage::Vertex;
-    bufferDesc.mappedAtCreation = false;
+    return createMesh(name, vertexData, indexData);
+}
 
-    wgpu::Buffer vertexBuffer = m_device.createBuffer(bufferDesc);
-    if (!vertexBuffer) {
-        std::cerr << "Failed to create vertex buffer for " << filepath << std::endl;
+bool Renderer::createMesh(const std::string& name, const std::vector<VertexAttributes>& vertexData,
+                          const std::vector<uint32_t>& indexData) {
+    if (vertexData.empty() || indexData.size() < 3) {
+        FROGGI_LOG_ERROR(Assets, "No triangles for mesh: %s", name.c_str());
         return false;
     }
+    if (m_meshRegistry.find(name).isValid()) {
+        // Objects would keep drawing the first mesh of that name anyway
+        FROGGI_LOG_WARN(Assets, "Mesh %s already exists, keeping the first one", name.c_str());
+        return true;
+    }
 
-    m_queue.writeBuffer(vertexBuffer, 0, vertexData.data(), bufferDesc.size);
-    
-    // Create mesh and setup uniforms/bind group
-    m_meshes.emplace_back(vertexBuffer, static_cast<int>(vertexData.size()), name);
-    Mesh& mesh = m_meshes.back();
-    
-    // Create uniform buffer for this mesh
-    BufferDescriptor uniformDesc;
-    uniformDesc.size = sizeof(MyUniforms);
-    uniformDesc.usage = BufferUsage::CopyDst | BufferUsage::Uniform;
-    uniformDesc.mappedAtCreation = false;
-    mesh.uniformBuffer = m_device.createBuffer(uniformDesc);
-    
-    mesh.uniforms.modelMatrix = glm::mat4(1.0f);
-    mesh.uniforms.color = glm::vec4(1.0f);
-    m_queue.writeBuffer(mesh.uniformBuffer, 0, &mesh.uniforms, sizeof(MyUniforms));
-    
-    // Create bind group
-    std::vector<BindGroupEntry> bindings(3);
-    bindings[0].binding = 0;
-    bindings[0].buffer = mesh.uniformBuffer;
-    bindings[0].offset = 0;
-    bindings[0].size = sizeof(MyUniforms);
+    VertexLayout layout = chooseVertexLayout(vertexData, kVertexFormats[cv_vertexFormat.get()]);
+    if (!createLayoutPipelines(layout)) {
+        FROGGI_LOG_ERROR(Renderer, "Failed to create pipelines for %s vertices", vertexLayoutName(layout));
+        return false;
+    }
+    std::vector<uint8_t> packedVertices;
+    glm::mat4 dequantize = packVertices(layout, vertexData, packedVertices);
+
+    GeometryBuffer& vertices = m_vertexBuffers[static_cast<size_t>(layout)];
+    uint32_t vertexRange = vertices.allocate(static_cast<uint32_t>(vertexData.size()));
+    if (vertexRange == GeometryBuffer::kInvalidRange) {
+        FROGGI_LOG_ERROR(Assets, "No room for the vertices of %s", name.c_str());
+        return false;
+    }
+    uploadBuffer(vertices.getBuffer(), vertices.getByteOffset(vertexRange), packedVertices.data(),
+                 packedVertices.size());
+    
+    // 16-bit indices (relative to the mesh's base vertex) when every vertex
+    // fits; uploads stay whole multiples of 4 bytes
+    bool shortIndices = vertexData.size() <= 65536;
+    std::vector<uint16_t> shortIndexData;
+    if (shortIndices) {
+        shortIndexData.assign(indexData.begin(), indexData.end());
+        if (shortIndexData.size() % 2 != 0) shortIndexData.push_back(0);
+    }
     
-    bindings[1].binding = 1;
-    bindings[1].textureView = m_textureView;
+    IndexFormat indexFormat = shortIndices ? IndexFormat::Uint16 : IndexFormat::Uint32;
+    GeometryBuffer& indices = getIndexBuffer(indexFormat);
+    uint32_t indexRange = indices.allocate(static_cast<uint32_t>(shortIndices ? shortIndexData.size()
+                                                                              : indexData.size()));
+    if (indexRange == GeometryBuffer::kInvalidRange) {
+        FROGGI_LOG_ERROR(Assets, "No room for the indices of %s", name.c_str());
+        vertices.free(vertexRange);
+        return false;
+    }
+    if (shortIndices) {
+        uploadBuffer(indices.getBuffer(), indices.getByteOffset(indexRange), shortIndexData.data(),
+                     shortIndexData.size() * sizeof(uint16_t));
+    } else {
+        uploadBuffer(indices.getBuffer(), indices.getByteOffset(indexRange), indexData.data(),
+                     indexData.size() * sizeof(uint32_t));
+    }
     
-    bindings[2].binding = 2;
-    bindings[2].sampler = m_sampler;
+    // Local bounds for the draw list (culling, sorting)
+    glm::vec3 boundsMin = vertexData[0].position;
+    glm::vec3 boundsMax = vertexData[0].position;
+    for (const VertexAttributes& vertex : vertexData) {
+        boundsMin = glm::min(boundsMin, vertex.position);
+        boundsMax = glm::max(boundsMax, vertex.position);
+    }
+    glm::vec3 boundsCenter = (boundsMin + boundsMax) * 0.5f;
+    float boundsRadius = 0.0f;
+    for (const VertexAttributes& vertex : vertexData) {
+        boundsRadius = std::max(boundsRadius, glm::length(vertex.position - boundsCenter));
+    }
     
-    BindGroupDescriptor bindGroupDesc;
-    bindGroupDesc.layout = m_bindGroupLayout;
-    bindGroupDesc.entryCount = (uint32_t)bindings.size();
-    bindGroupDesc.entries = bindings.data();
-    mesh.bindGroup = m_device.createBindGroup(bindGroupDesc);
+    // Slots of unloaded meshes are reused, new ones extend the pool
+    size_t indexCount = indexData.size() / 3 * 3;
+    MeshHandle handle = m_meshRegistry.add(name, boundsMin, boundsMax, boundsRadius);
+    if (!handle.isValid()) {
+        vertices.free(vertexRange);
+        indices.free(indexRange);
+        return false;
+    }
+    uint32_t meshIndex = handle.index;
+    while (m_meshes.size() <= meshIndex) {
+        m_meshes.emplace_back(GeometryBuffer::kInvalidRange, 0, GeometryBuffer::kInvalidRange, 0, IndexFormat::Uint32);
+    }
+    Mesh& mesh = m_meshes[meshIndex];
+    mesh = Mesh(vertexRange, static_cast<int>(vertexData.size()), indexRange, static_cast<int>(indexCount),
+                indexFormat, name);
+    mesh.layout = layout;
+    mesh.dequantize = dequantize;
+    m_meshRegistry.setPipeline(meshIndex, static_cast<uint32_t>(layout));
+    
+    // Small meshes keep a CPU copy of their triangles for occlusion culling
+    if (indexCount <= static_cast<size_t>(cv_occluderMaxTriangles.get()) * 3) {
+        std::vector<glm::vec3> occluder;
+        occluder.reserve(indexCount);
+        for (size_t i = 0; i < indexCount; ++i) occluder.push_back(vertexData[indexData[i]].position);
+        m_meshRegistry.setOccluder(meshIndex, std::move(occluder));
+    }
+    metric_meshes.set(static_cast<double>(m_meshRegistry.size()));
+    updateGeometryMetrics();
     
-    std::cout << "Loaded mesh: " << name << " (" << vertexData.size() << " vertices)" << std::endl;
+    FROGGI_LOG_DEBUG(Assets, "Loaded mesh: %s (%zu %s vertices, %zu indices)", name.c_str(), vertexData.size(),
+                     vertexLayoutName(layout), indexCount);
+    return true;
+}
+
+bool Renderer::unloadMesh(const std::string& name) {
+    MeshHandle handle = m_meshRegistry.find(name);
+    if (!handle.isValid()) return false;
+
+    // Frames in flight may still read the ranges; whatever reuses them is
+    // written through the queue, which orders it after those frames
+    Mesh& mesh = m_meshes[handle.index];
+    m_vertexBuffers[static_cast<size_t>(mesh.layout)].free(mesh.vertexRange);
+    getIndexBuffer(mesh.indexFormat).free(mesh.indexRange);
+    mesh = Mesh(GeometryBuffer::kInvalidRange, 0, GeometryBuffer::kInvalidRange, 0, IndexFormat::Uint32);
+    m_meshRegistry.remove(handle);
+
+    metric_meshes.set(static_cast<double>(m_meshRegistry.size()));
+    updateGeometryMetrics();
+    FROGGI_LOG_DEBUG(Assets, "Unloaded mesh: %s", name.c_str());
     return true;
 }
 
@@ -455,43 +771,43 @@ bool Renderer::loadMesh(const std::string& name, const std::string& filepath) {
 bool Renderer::initWindowAndDevice() {
     m_instance = createInstance(InstanceDescriptor{});
     if (!m_instance) {
-        std::cerr << "Could not initialize WebGPU!" << std::endl;
+        FROGGI_LOG_ERROR(Renderer, "Could not initialize WebGPU!");
         return false;
     }
 
     if (!glfwInit()) {
-        std::cerr << "Could not initialize GLFW!" << std::endl;
+        FROGGI_LOG_ERROR(Renderer, "Could not initialize GLFW!");
         return false;
     }
 
     glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
     glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
 
-    m_window = glfwCreateWindow(displayWidth, displayHeight, "_froggi", NULL, NULL);
+    m_window = glfwCreateWindow(m_displayWidth, m_displayHeight, "_froggi", NULL, NULL);
     if (!m_window) {
-        std::cerr << "Could not open window!" << std::endl;
+        FROGGI_LOG_ERROR(Renderer, "Could not open window!");
         return false;
     }
 
-    std::cout << "Requesting adapter..." << std::endl;
+    FROGGI_LOG_INFO(Renderer, "Requesting adapter...");
     m_surface = glfwGetWGPUSurface(m_instance, m_window);
     RequestAdapterOptions adapterOpts{};
     adapterOpts.compatibleSurface = m_surface;
     Adapter adapter = m_instance.requestAdapter(adapterOpts);
-    std::cout << "Got adapter: " << adapter << std::endl;
+    FROGGI_LOG_INFO(Renderer, "Got adapter: %p", static_cast<const void*>(static_cast<WGPUAdapter>(adapter)));
 
     SupportedLimits supportedLimits;
     adapter.getLimits(&supportedLimits);
 
-    std::cout << "Requesting device..." << std::endl;
+    FROGGI_LOG_INFO(Renderer, "Requesting device...");
     RequiredLimits requiredLimits = Default;
     requiredLimits.limits.maxVertexAttributes = 4;
     requiredLimits.limits.maxVertexBuffers = 1;
-    requiredLimits.limits.maxBufferSize = 15000000 * sizeof(VertexAttributes);
+    requiredLimits.limits.maxBufferSize = kMaxBufferSize;
     requiredLimits.limits.maxVertexBufferArrayStride = sizeof(VertexAttributes);
     requiredLimits.limits.minStorageBufferOffsetAlignment = supportedLimits.limits.minStorageBufferOffsetAlignment;
     requiredLimits.limits.minUniformBufferOffsetAlignment = supportedLimits.limits.minUniformBufferOffsetAlignment;
-    requiredLimits.limits.maxInterStageShaderComponents = 8;
+    requiredLimits.limits.maxInterStageShaderComponents = 12;
     requiredLimits.limits.maxBindGroups = 2;
     requiredLimits.limits.maxUniformBuffersPerShaderStage = 1;
     requiredLimits.limits.maxUniformBufferBindingSize = 16 * 4 * sizeof(float);
@@ -500,6 +816,8 @@ bool Renderer::initWindowAndDevice() {
     requiredLimits.limits.maxTextureArrayLayers = 1;
     requiredLimits.limits.maxSampledTexturesPerShaderStage = 1;
     requiredLimits.limits.maxSamplersPerShaderStage = 1;
+    requiredLimits.limits.maxStorageBuffersPerShaderStage = 1;
+    requiredLimits.limits.maxStorageBufferBindingSize = supportedLimits.limits.maxStorageBufferBindingSize;
 
     DeviceDescriptor deviceDesc;
     deviceDesc.label = "My Device";
@@ -507,14 +825,17 @@ bool Renderer::initWindowAndDevice() {
     deviceDesc.requiredLimits = &requiredLimits;
     deviceDesc.defaultQueue.label = "The default queue";
     m_device = adapter.requestDevice(deviceDesc);
-    std::cout << "Got device: " << m_device << std::endl;
+    FROGGI_LOG_INFO(Renderer, "Got device: %p", static_cast<const void*>(static_cast<WGPUDevice>(m_device)));
 
     m_errorCallbackHandle = m_device.setUncapturedErrorCallback([](ErrorType type, char const* message) {
-        std::cout << "Device error: type " << type;
-        if (message) std::cout << " (message: " << message << ")";
-        std::cout << std::endl;
+        FROGGI_LOG_ERROR(Renderer, "Device error: type %u (message: %s)",
+                         static_cast<uint32_t>(type), message ? message : "");
     });
 
+    m_maxInstances = supportedLimits.limits.maxStorageBufferBindingSize / sizeof(InstanceData);
+    m_uniformAlignment = supportedLimits.limits.minUniformBufferOffsetAlignment;
+    m_storageAlignment = supportedLimits.limits.minStorageBufferOffsetAlignment;
+    
     m_queue = m_device.getQueue();
     m_swapChainFormat = m_surface.getPreferredFormat(adapter);
 
@@ -531,6 +852,7 @@ bool Renderer::initWindowAndDevice() {
 void Renderer::terminateWindowAndDevice() {
     m_queue.release();
     m_device.release();
+    m_workDoneCallbacks.clear();
     m_surface.release();
     m_instance.release();
     glfwDestroyWindow(m_window);
@@ -541,15 +863,19 @@ bool Renderer::initSwapChain() {
     int width, height;
     glfwGetFramebufferSize(m_window, &width, &height);
 
-    std::cout << "Creating swapchain..." << std::endl;
+    FROGGI_LOG_INFO(Renderer, "Creating swapchain...");
     SwapChainDescriptor swapChainDesc;
     swapChainDesc.width = static_cast<uint32_t>(width);
     swapChainDesc.height = static_cast<uint32_t>(height);
     swapChainDesc.usage = TextureUsage::RenderAttachment;
     swapChainDesc.format = m_swapChainFormat;
-    swapChainDesc.presentMode = PresentMode::Fifo;
+    switch (cv_presentMode.get()) {
+        case 1:  swapChainDesc.presentMode = PresentMode::Immediate; break;
+        case 2:  swapChainDesc.presentMode = PresentMode::Mailbox; break;
+        default: swapChainDesc.presentMode = PresentMode::Fifo; break;
+    }
     m_swapChain = m_device.createSwapChain(m_surface, swapChainDesc);
-    std::cout << "Swapchain: " << m_swapChain << std::endl;
+    FROGGI_LOG_INFO(Renderer, "Swapchain: %p", static_cast<const void*>(static_cast<WGPUSwapChain>(m_swapChain)));
     return m_swapChain != nullptr;
 }
 
@@ -563,7 +889,7 @@ bool Renderer::initDepthBuffer() {
     depthTextureDesc.format = m_depthTextureFormat;
     depthTextureDesc.mipLevelCount = 1;
     depthTextureDesc.sampleCount = 1;
-    depthTextureDesc.size = { renderWidth, renderHeight, 1 };
+    depthTextureDesc.size = { m_renderWidth, m_renderHeight, 1 };
     depthTextureDesc.usage = TextureUsage::RenderAttachment;
     depthTextureDesc.viewFormatCount = 1;
     depthTextureDesc.viewFormats = (WGPUTextureFormat*)&m_depthTextureFormat;
@@ -589,37 +915,81 @@ void Renderer::terminateDepthBuffer() {
 }
 
 bool Renderer::initRenderPipeline() {
-    std::cout << "Creating shader module..." << std::endl;
-    m_shaderModule = resource_manager::loadShaderModule("shaders/shader.wgsl", m_device);
+    std::vector<BindGroupLayoutEntry> bindingLayoutEntries(4, Default);
 
-    RenderPipelineDescriptor pipelineDesc;
+    BindGroupLayoutEntry& bindingLayout = bindingLayoutEntries[0];
+    bindingLayout.binding = 0;
+    bindingLayout.visibility = ShaderStage::Vertex | ShaderStage::Fragment;
+    bindingLayout.buffer.type = BufferBindingType::Uniform;
+    bindingLayout.buffer.hasDynamicOffset = true;
+    bindingLayout.buffer.minBindingSize = sizeof(FrameUniforms);
 
-    std::vector<VertexAttribute> vertexAttribs(4);
-    vertexAttribs[0].shaderLocation = 0;
-    vertexAttribs[0].format = VertexFormat::Float32x3;
-    vertexAttribs[0].offset = 0;
+    BindGroupLayoutEntry& textureBindingLayout = bindingLayoutEntries[1];
+    textureBindingLayout.binding = 1;
+    textureBindingLayout.visibility = ShaderStage::Fragment;
+    textureBindingLayout.texture.sampleType = TextureSampleType::Float;
+    textureBindingLayout.texture.viewDimension = TextureViewDimension::_2D;
 
-    vertexAttribs[1].shaderLocation = 1;
-    vertexAttribs[1].format = VertexFormat::Float32x3;
-    vertexAttribs[1].offset = offsetof(resource_manager::VertexAttributes, normal);
+    BindGroupLayoutEntry& samplerBindingLayout = bindingLayoutEntries[2];
+    samplerBindingLayout.binding = 2;
+    samplerBindingLayout.visibility = ShaderStage::Fragment;
+    samplerBindingLayout.sampler.type = SamplerBindingType::Filtering;
+
+    BindGroupLayoutEntry& instanceBindingLayout = bindingLayoutEntries[3];
+    instanceBindingLayout.binding = 3;
+    instanceBindingLayout.visibility = ShaderStage::Vertex | ShaderStage::Fragment;
+    instanceBindingLayout.buffer.type = BufferBindingType::ReadOnlyStorage;
+    instanceBindingLayout.buffer.hasDynamicOffset = true;
+    instanceBindingLayout.buffer.minBindingSize = sizeof(InstanceData);
+
+    BindGroupLayoutDescriptor bindGroupLayoutDesc{};
+    bindGroupLayoutDesc.entryCount = (uint32_t)bindingLayoutEntries.size();
+    bindGroupLayoutDesc.entries = bindingLayoutEntries.data();
+    m_bindGroupLayout = m_device.createBindGroupLayout(bindGroupLayoutDesc);
 
-    vertexAttribs[2].shaderLocation = 2;
-    vertexAttribs[2].format = VertexFormat::Float32x3;
-    vertexAttribs[2].offset = offsetof(resource_manager::VertexAttributes, color);
+    PipelineLayoutDescriptor layoutDesc{};
+    layoutDesc.bindGroupLayoutCount = 1;
+    layoutDesc.bindGroupLayouts = (WGPUBindGroupLayout*)&m_bindGroupLayout;
+    m_pipelineLayout = m_device.createPipelineLayout(layoutDesc);
+    
+    // Fails here rather than on the first mesh if the shaders don't compile
+    return createLayoutPipelines(VertexLayout::Float);
+}
 
-    vertexAttribs[3].shaderLocation = 3;
-    vertexAttribs[3].format = VertexFormat::Float32x2;
-    vertexAttribs[3].offset = offsetof(resource_manager::VertexAttributes, uv);
+void Renderer::terminateRenderPipeline() {
+    for (LayoutPipelines& pipelines : m_layoutPipelines) {
+        if (!pipelines.shader) continue;
+        pipelines.opaque.release();
+        pipelines.transparent.release();
+        pipelines.silhouette.release();
+        pipelines.shader.release();
+        pipelines.silhouetteShader.release();
+        pipelines = LayoutPipelines{};
+    }
+    m_pipelineLayout.release();
+    m_bindGroupLayout.release();
+}
 
-    VertexBufferLayout vertexBufferLayout;
-    vertexBufferLayout.attributeCount = (uint32_t)vertexAttribs.size();
-    vertexBufferLayout.attributes = vertexAttribs.data();
-    vertexBufferLayout.arrayStride = sizeof(resource_manager::VertexAttributes);
-    vertexBufferLayout.stepMode = VertexStepMode::Vertex;
+bool Renderer::createLayoutPipelines(VertexLayout layout) {
+    LayoutPipelines& pipelines = m_layoutPipelines[static_cast<size_t>(layout)];
+    if (pipelines.shader) return pipelines.opaque && pipelines.transparent && pipelines.silhouette;
+    
+    FROGGI_LOG_INFO(Renderer, "Creating pipelines for %s vertices...", vertexLayoutName(layout));
+    std::string vertexSource = vertexLayoutWgsl(layout);
+    pipelines.shader = resource_manager::loadShaderModule("shaders/shader.wgsl", m_device, vertexSource);
+    pipelines.silhouetteShader = resource_manager::loadShaderModule("shaders/silhouette.wgsl", m_device, vertexSource);
+
+    std::vector<VertexAttribute> vertexAttribs;
+    VertexBufferLayout vertexBufferLayout = describeVertexLayout(layout, vertexAttribs);
+
+    // ═══════════════════════════════════════════════════════════════
+    // MAIN PASS (opaque and transparent)
+    // ═══════════════════════════════════════════════════════════════
+    RenderPipelineDescriptor pipelineDesc;
 
     pipelineDesc.vertex.bufferCount = 1;
     pipelineDesc.vertex.buffers = &vertexBufferLayout;
-    pipelineDesc.vertex.module = m_shaderModule;
+    pipelineDesc.vertex.module = pipelines.shader;
     pipelineDesc.vertex.entryPoint = "vs_main";
     pipelineDesc.vertex.constantCount = 0;
     pipelineDesc.vertex.constants = nullptr;
@@ -631,7 +1001,7 @@ bool Renderer::initRenderPipeline() {
 
     FragmentState fragmentState;
     pipelineDesc.fragment = &fragmentState;
-    fragmentState.module = m_shaderModule;
+    fragmentState.module = pipelines.shader;
     fragmentState.entryPoint = "fs_main";
     fragmentState.constantCount = 0;
     fragmentState.constants = nullptr;
@@ -668,130 +1038,38 @@ bool Renderer::initRenderPipeline() {
     pipelineDesc.multisample.count = 1;
     pipelineDesc.multisample.mask = ~0u;
     pipelineDesc.multisample.alphaToCoverageEnabled = false;
+    pipelineDesc.layout = m_pipelineLayout;
 
-    std::vector<BindGroupLayoutEntry> bindingLayoutEntries(3, Default);
-
-    BindGroupLayoutEntry& bindingLayout = bindingLayoutEntries[0];
-    bindingLayout.binding = 0;
-    bindingLayout.visibility = ShaderStage::Vertex | ShaderStage::Fragment;
-    bindingLayout.buffer.type = BufferBindingType::Uniform;
-    bindingLayout.buffer.minBindingSize = sizeof(MyUniforms);
-
-    BindGroupLayoutEntry& textureBindingLayout = bindingLayoutEntries[1];
-    textureBindingLayout.binding = 1;
-    textureBindingLayout.visibility = ShaderStage::Fragment;
-    textureBindingLayout.texture.sampleType = TextureSampleType::Float;
-    textureBindingLayout.texture.viewDimension = TextureViewDimension::_2D;
-
-    BindGroupLayoutEntry& samplerBindingLayout = bindingLayoutEntries[2];
-    samplerBindingLayout.binding = 2;
-    samplerBindingLayout.visibility = ShaderStage::Fragment;
-    samplerBindingLayout.sampler.type = SamplerBindingType::Filtering;
-
-    BindGroupLayoutDescriptor bindGroupLayoutDesc{};
-    bindGroupLayoutDesc.entryCount = (uint32_t)bindingLayoutEntries.size();
-    bindGroupLayoutDesc.entries = bindingLayoutEntries.data();
-    m_bindGroupLayout = m_device.createBindGroupLayout(bindGroupLayoutDesc);
-
-    PipelineLayoutDescriptor layoutDesc{};
-    layoutDesc.bindGroupLayoutCount = 1;
-    layoutDesc.bindGroupLayouts = (WGPUBindGroupLayout*)&m_bindGroupLayout;
-    PipelineLayout layout = m_device.createPipelineLayout(layoutDesc);
-    pipelineDesc.layout = layout;
-
-    m_pipeline = m_device.createRenderPipeline(pipelineDesc);
-    return m_pipeline != nullptr;
-}
-
-void Renderer::terminateRenderPipeline() {
-    m_pipeline.release();
-    m_shaderModule.release();
-    m_bindGroupLayout.release();
-}
-
-bool Renderer::initSilhouettePipeline() {
-    m_silhouetteShader = resource_manager::loadShaderModule(
-        "shaders/silhouette.wgsl", m_device);
-    
-    RenderPipelineDescriptor pipelineDesc;
-    
-    std::vector<VertexAttribute> vertexAttribs(4);
-    vertexAttribs[0].shaderLocation = 0;
-    vertexAttribs[0].format = VertexFormat::Float32x3;
-    vertexAttribs[0].offset = 0;
-    
-    vertexAttribs[1].shaderLocation = 1;
-    vertexAttribs[1].format = VertexFormat::Float32x3;
-    vertexAttribs[1].offset = offsetof(resource_manager::VertexAttributes, normal);
-    
-    vertexAttribs[2].shaderLocation = 2;
-    vertexAttribs[2].format = VertexFormat::Float32x3;
-    vertexAttribs[2].offset = offsetof(resource_manager::VertexAttributes, color);
-    
-    vertexAttribs[3].shaderLocation = 3;
-    vertexAttribs[3].format = VertexFormat::Float32x2;
-    vertexAttribs[3].offset = offsetof(resource_manager::VertexAttributes, uv);
-    
-    VertexBufferLayout vertexBufferLayout;
-    vertexBufferLayout.attributeCount = (uint32_t)vertexAttribs.size();
-    vertexBufferLayout.attributes = vertexAttribs.data();
-    vertexBufferLayout.arrayStride = sizeof(resource_manager::VertexAttributes);
-    vertexBufferLayout.stepMode = VertexStepMode::Vertex;
-    
-    pipelineDesc.vertex.bufferCount = 1;
-    pipelineDesc.vertex.buffers = &vertexBufferLayout;
-    pipelineDesc.vertex.module = m_silhouetteShader;
-    pipelineDesc.vertex.entryPoint = "vs_main";
-    
-    pipelineDesc.primitive.topology = PrimitiveTopology::TriangleList;
-    pipelineDesc.primitive.stripIndexFormat = IndexFormat::Undefined;
-    pipelineDesc.primitive.frontFace = FrontFace::CCW;
-    pipelineDesc.primitive.cullMode = CullMode::None;
+    pipelines.opaque = m_device.createRenderPipeline(pipelineDesc);
     
-    FragmentState fragmentState;
-    pipelineDesc.fragment = &fragmentState;
-    fragmentState.module = m_silhouetteShader;
-    fragmentState.entryPoint = "fs_main";
+    // Transparent draws are sorted back to front and must not hide each other
+    depthStencilState.depthWriteEnabled = false;
+    pipelines.transparent = m_device.createRenderPipeline(pipelineDesc);
+
+    // ═══════════════════════════════════════════════════════════════
+    // SILHOUETTE PASS (object ID and depth for outlines)
+    // ═══════════════════════════════════════════════════════════════
+    pipelineDesc.vertex.module = pipelines.silhouetteShader;
+    fragmentState.module = pipelines.silhouetteShader;
     
-    ColorTargetState colorTarget;
     colorTarget.format = TextureFormat::RGBA16Float;
     colorTarget.blend = nullptr;
-    colorTarget.writeMask = ColorWriteMask::All;
     
-    fragmentState.targetCount = 1;
-    fragmentState.targets = &colorTarget;
-    
-    DepthStencilState depthStencilState = Default;
+    depthStencilState = Default;
     depthStencilState.depthCompare = CompareFunction::Less;
     depthStencilState.depthWriteEnabled = true;
     depthStencilState.format = m_depthTextureFormat;
     depthStencilState.stencilReadMask = 0;
     depthStencilState.stencilWriteMask = 0;
     
-    pipelineDesc.depthStencil = &depthStencilState;
-    pipelineDesc.multisample.count = 1;
-    pipelineDesc.multisample.mask = ~0u;
-    pipelineDesc.multisample.alphaToCoverageEnabled = false;
-    
-    PipelineLayoutDescriptor layoutDesc{};
-    layoutDesc.bindGroupLayoutCount = 1;
-    layoutDesc.bindGroupLayouts = (WGPUBindGroupLayout*)&m_bindGroupLayout;
-    PipelineLayout layout = m_device.createPipelineLayout(layoutDesc);
-    pipelineDesc.layout = layout;
-    
-    m_silhouettePipeline = m_device.createRenderPipeline(pipelineDesc);
-    return m_silhouettePipeline != nullptr;
-}
-
-void Renderer::terminateSilhouettePipeline() {
-    m_silhouettePipeline.release();
-    m_silhouetteShader.release();
+    pipelines.silhouette = m_device.createRenderPipeline(pipelineDesc);
+    return pipelines.opaque && pipelines.transparent && pipelines.silhouette;
 }
 
 bool Renderer::initOutlineComposePipeline() {
     m_outlineComposeShader = resource_manager::loadShaderModule("shaders/outline_compose.wgsl", m_device);
     
-    BindGroupLayoutEntry bglEntries[2]{};
+    BindGroupLayoutEntry bglEntries[3]{};
     bglEntries[0].binding = 0;
     bglEntries[0].visibility = ShaderStage::Fragment;
     bglEntries[0].texture.sampleType = TextureSampleType::Float;
@@ -801,11 +1079,24 @@ bool Renderer::initOutlineComposePipeline() {
     bglEntries[1].visibility = ShaderStage::Fragment;
     bglEntries[1].sampler.type = SamplerBindingType::Filtering;
     
+    // Outline parameters (r.outline* cvars)
+    bglEntries[2].binding = 2;
+    bglEntries[2].visibility = ShaderStage::Fragment;
+    bglEntries[2].buffer.type = BufferBindingType::Uniform;
+    bglEntries[2].buffer.minBindingSize = sizeof(OutlineUniforms);
+    
     BindGroupLayoutDescriptor bglDesc{};
-    bglDesc.entryCount = 2;
+    bglDesc.entryCount = 3;
     bglDesc.entries = bglEntries;
     m_outlineComposeBindGroupLayout = m_device.createBindGroupLayout(bglDesc);
     
+    BufferDescriptor outlineUniformDesc;
+    outlineUniformDesc.size = sizeof(OutlineUniforms);
+    outlineUniformDesc.usage = BufferUsage::CopyDst | BufferUsage::Uniform;
+    outlineUniformDesc.mappedAtCreation = false;
+    m_outlineUniformBuffer = m_device.createBuffer(outlineUniformDesc);
+    writeOutlineUniforms();
+    
     PipelineLayoutDescriptor layoutDesc{};
     layoutDesc.bindGroupLayoutCount = 1;
     layoutDesc.bindGroupLayouts = (WGPUBindGroupLayout*)&m_outlineComposeBindGroupLayout;
@@ -848,23 +1139,46 @@ bool Renderer::initOutlineComposePipeline() {
     
     m_outlineComposePipeline = m_device.createRenderPipeline(pipelineDesc);
     
-    BindGroupEntry bgEntries[2]{};
+    createOutlineComposeBindGroup();
+    
+    return m_outlineComposePipeline != nullptr;
+}
+
+void Renderer::createOutlineComposeBindGroup() {
+    BindGroupEntry bgEntries[3]{};
     bgEntries[0].binding = 0;
     bgEntries[0].textureView = m_silhouetteView;
     bgEntries[1].binding = 1;
     bgEntries[1].sampler = m_sampler;
+    bgEntries[2].binding = 2;
+    bgEntries[2].buffer = m_outlineUniformBuffer;
+    bgEntries[2].offset = 0;
+    bgEntries[2].size = sizeof(OutlineUniforms);
     
     BindGroupDescriptor bgDesc{};
     bgDesc.layout = m_outlineComposeBindGroupLayout;
-    bgDesc.entryCount = 2;
+    bgDesc.entryCount = 3;
     bgDesc.entries = bgEntries;
     m_outlineComposeBindGroup = m_device.createBindGroup(bgDesc);
+}
+
+void Renderer::writeOutlineUniforms() {
+    OutlineUniforms uniforms{};
+    uniforms.width = cv_outlineWidth.get();
+    uniforms.samples = cv_outlineSamples.get();
+    uniforms.depthThreshold = cv_outlineDepthThreshold.get();
+    uploadBuffer(m_outlineUniformBuffer, 0, &uniforms, sizeof(OutlineUniforms));
     
-    return m_outlineComposePipeline != nullptr;
+    m_outlineVersion = cv_outlineWidth.version() + cv_outlineSamples.version() +
+                       cv_outlineDepthThreshold.version();
 }
 
 void Renderer::terminateOutlineComposePipeline() {
     m_outlineComposeBindGroup.release();
+    if (m_outlineUniformBuffer) {
+        m_outlineUniformBuffer.destroy();
+        m_outlineUniformBuffer.release();
+    }
     m_outlineComposePipeline.release();
     m_outlineComposeBindGroupLayout.release();
     m_outlineComposeShader.release();
@@ -910,7 +1224,7 @@ bool Renderer::initBlitPipeline() {
     m_zoomUniforms.zoom = 1.0f;
     m_zoomUniforms.centerX = 0.5f;
     m_zoomUniforms.centerY = 0.5f;
-    m_queue.writeBuffer(m_zoomUniformBuffer, 0, &m_zoomUniforms, sizeof(ZoomUniforms));
+    uploadBuffer(m_zoomUniformBuffer, 0, &m_zoomUniforms, sizeof(ZoomUniforms));
     
     PipelineLayoutDescriptor layoutDesc{};
     layoutDesc.bindGroupLayoutCount = 1;
@@ -944,6 +1258,12 @@ bool Renderer::initBlitPipeline() {
     
     m_blitPipeline = m_device.createRenderPipeline(pipelineDesc);
     
+    createBlitBindGroup();
+    
+    return m_blitPipeline != nullptr;
+}
+
+void Renderer::createBlitBindGroup() {
     // Create bind group with 3 entries
     BindGroupEntry bgEntries[3]{};
     bgEntries[0].binding = 0;
@@ -960,8 +1280,6 @@ bool Renderer::initBlitPipeline() {
     bgDesc.entryCount = 3;  // Changed from 2 to 3
     bgDesc.entries = bgEntries;
     m_blitBindGroup = m_device.createBindGroup(bgDesc);
-    
-    return m_blitPipeline != nullptr;
 }
 
 void Renderer::terminateBlitPipeline() {
@@ -996,7 +1314,7 @@ bool Renderer::initTexture() {
         "assets/textures/master_spritesheet.png", m_device, &m_textureView);
     
     if (!m_texture) {
-        std::cerr << "Warning: Could not load default texture. Game should load textures." << std::endl;
+        FROGGI_LOG_WARN(Assets, "Warning: Could not load default texture. Game should load textures.");
         // Create a dummy 1x1 white texture as fallback
         return true; // Don't fail, just warn
     }
@@ -1012,25 +1330,25 @@ void Renderer::terminateTexture() {
 }
 
 bool Renderer::initGeometry() {
-    // Meshes will be loaded by game via loadMesh()
+    // Meshes will be loaded by game via loadMesh(); the buffers are
+    // created with the first mesh that uses them
+    for (size_t i = 0; i < kVertexLayoutCount; ++i) {
+        VertexLayout layout = static_cast<VertexLayout>(i);
+        std::string label = std::string("Vertex Buffer (") + vertexLayoutName(layout) + ")";
+        m_vertexBuffers[i].init(m_device, m_queue, BufferUsage::Vertex, vertexStride(layout), kMaxBufferSize,
+                                label.c_str());
+    }
+    m_indexBuffers[0].init(m_device, m_queue, BufferUsage::Index, sizeof(uint16_t), kMaxBufferSize, "Index Buffer (16)");
+    m_indexBuffers[1].init(m_device, m_queue, BufferUsage::Index, sizeof(uint32_t), kMaxBufferSize, "Index Buffer (32)");
     return true;
 }
 
 void Renderer::terminateGeometry() {
-    for (auto& mesh : m_meshes) {
-        if (mesh.vertexBuffer) {
-            mesh.vertexBuffer.destroy();
-            mesh.vertexBuffer.release();
-        }
-        if (mesh.uniformBuffer) {
-            mesh.uniformBuffer.destroy();
-            mesh.uniformBuffer.release();
-        }
-        if (mesh.bindGroup) {
-            mesh.bindGroup.release();
-        }
-    }
+    for (GeometryBuffer& buffer : m_vertexBuffers) buffer.terminate();
+    for (GeometryBuffer& buffer : m_indexBuffers) buffer.terminate();
     m_meshes.clear();
+    m_meshRegistry.clear();
+    m_drawList.clear();
 }
 
 bool Renderer::initUniforms() {
@@ -1045,16 +1363,21 @@ bool Renderer::initUniforms() {
 }
 
 void Renderer::terminateUniforms() {
-    // Individual mesh uniforms cleaned up in terminateGeometry
+    if (m_frameRing) {
+        m_frameRing.destroy();
+        m_frameRing.release();
+        m_instanceCapacity = 0;
+    }
 }
 
 bool Renderer::initBindGroup() {
-    // Bind groups created per-mesh in loadMesh()
-    return true;
+    // Shared by every draw; recreated whenever the instance buffer grows
+    reserveInstances(1);
+    return m_bindGroup != nullptr;
 }
 
 void Renderer::terminateBindGroup() {
-    m_bindGroup.release();
+    if (m_bindGroup) m_bindGroup.release();
 }
 
 bool Renderer::initGui() {
@@ -1141,13 +1464,59 @@ void Renderer::onResize() {
     // Disabled for now
 }
 
+void Renderer::applyCVarChanges() {
+    uint32_t sizeVersion = cv_renderWidth.version() + cv_renderHeight.version();
+    if (sizeVersion != m_renderSizeVersion) {
+        m_renderSizeVersion = sizeVersion;
+        recreateRenderTargets();
+    }
+    
+    if (cv_presentMode.version() != m_presentModeVersion) {
+        m_presentModeVersion = cv_presentMode.version();
+        terminateSwapChain();
+        initSwapChain();
+    }
+    
+    uint32_t outlineVersion = cv_outlineWidth.version() + cv_outlineSamples.version() +
+                              cv_outlineDepthThreshold.version();
+    if (outlineVersion != m_outlineVersion) {
+        writeOutlineUniforms();
+    }
+}
+
+void Renderer::recreateRenderTargets() {
+    m_renderWidth = static_cast<uint32_t>(cv_renderWidth.get());
+    m_renderHeight = static_cast<uint32_t>(cv_renderHeight.get());
+    
+    // Bind groups reference the old views
+    m_outlineComposeBindGroup.release();
+    m_blitBindGroup.release();
+    
+    m_colorView.release();
+    m_colorTexture.destroy();
+    m_colorTexture.release();
+    m_silhouetteView.release();
+    m_silhouetteTexture.destroy();
+    m_silhouetteTexture.release();
+    terminateDepthBuffer();
+    
+    createRenderTarget(m_renderWidth, m_renderHeight);
+    createSilhouetteTarget(m_renderWidth, m_renderHeight);
+    initDepthBuffer();
+    
+    createOutlineComposeBindGroup();
+    createBlitBindGroup();
+    
+    FROGGI_LOG_INFO(Renderer, "Render targets resized to %ux%u", m_renderWidth, m_renderHeight);
+}
+
 bool Renderer::initDebugPipeline() {
-    std::cout << "Initializing debug pipeline..." << std::endl;
+    FROGGI_LOG_INFO(Renderer, "Initializing debug pipeline...");
     
     // Load shader
     m_debugShader = resource_manager::loadShaderModule("shaders/debug.wgsl", m_device);
     if (!m_debugShader) {
-        std::cerr << "Failed to load debug.wgsl" << std::endl;
+        FROGGI_LOG_ERROR(Renderer, "Failed to load debug.wgsl");
         return false;
     }
     
@@ -1250,7 +1619,7 @@ bool Renderer::initDebugPipeline() {
     
     m_debugPipeline = m_device.createRenderPipeline(pipelineDesc);
     
-    std::cout << "✓ Debug pipeline initialized" << std::endl;
+    FROGGI_LOG_INFO(Renderer, "✓ Debug pipeline initialized");
     return m_debugPipeline != nullptr;
 }
 
@@ -1292,11 +1661,11 @@ void Renderer::renderDebugPass(wgpu::CommandEncoder& encoder, Scene* scene) {
     bufferDesc.size = vertices.size() * sizeof(DebugVertex);
     bufferDesc.usage = BufferUsage::CopyDst | BufferUsage::Vertex;
     m_debugVertexBuffer = m_device.createBuffer(bufferDesc);
-    m_queue.writeBuffer(m_debugVertexBuffer, 0, vertices.data(), bufferDesc.size);
+    uploadBuffer(m_debugVertexBuffer, 0, vertices.data(), bufferDesc.size);
     
     // Update uniforms (view-projection matrix)
     glm::mat4 viewProj = m_projectionMatrix * m_viewMatrix;
-    m_queue.writeBuffer(m_debugUniformBuffer, 0, &viewProj, sizeof(glm::mat4));
+    uploadBuffer(m_debugUniformBuffer, 0, &viewProj, sizeof(glm::mat4));
     
     // Render
     RenderPassColorAttachment colorAttachment{};
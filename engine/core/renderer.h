@@ -3,8 +3,15 @@
 #include <webgpu/webgpu.hpp>
 #include <glm/glm.hpp>
 #include <resource_manager.h>
+#include "draw_list.h"
+#include "occlusion_culler.h"
+#include "vertex_format.h"
+#include "geometry_buffer.h"
+#include "worker_pool.h"
 #include <string>
 #include <vector>
+#include <deque>
+#include <memory>
 #include <functional>
 
 // Forward declarations
@@ -29,27 +36,41 @@ public:
     // Internal Structures (must be public for getMeshByName return type)
     // ═══════════════════════════════════════════════════════════════════════
     
-    struct MyUniforms {
+    // Per-frame values shared by every draw
+    struct FrameUniforms {
         glm::mat4 projectionMatrix;
         glm::mat4 viewMatrix;
+        glm::mat4 viewProjectionMatrix;
+        float time;
+        float _pad[3];
+    };
+    static_assert(sizeof(FrameUniforms) % 16 == 0);
+    
+    // Per-object values, read by the shaders from the instance storage buffer
+    struct InstanceData {
         glm::mat4 modelMatrix;
         glm::vec4 color;
-        float time;
+        float objectId;         // silhouette ID for outline detection
         float _pad[3];
     };
-    static_assert(sizeof(MyUniforms) % 16 == 0);
+    static_assert(sizeof(InstanceData) % 16 == 0);
     
+    // Geometry lives in the shared geometry buffers of its vertex layout and
+    // index format; draws resolve the ranges to baseVertex / firstIndex
     struct Mesh {
-        wgpu::Buffer vertexBuffer;
+        uint32_t vertexRange = GeometryBuffer::kInvalidRange;
+        uint32_t indexRange = GeometryBuffer::kInvalidRange;
         int vertexCount = 0;
-        glm::mat4 modelMatrix = glm::mat4(1.0f);
+        int indexCount = 0;
+        wgpu::IndexFormat indexFormat = wgpu::IndexFormat::Uint32;
+        VertexLayout layout = VertexLayout::Float;
+        glm::mat4 dequantize = glm::mat4(1.0f);    // decoded position -> mesh space, folded into instances
         std::string name;
-        wgpu::BindGroup bindGroup = nullptr;
-        wgpu::Buffer uniformBuffer = nullptr;
-        MyUniforms uniforms{};
         
-        Mesh(const wgpu::Buffer& buffer, int count, const std::string& n = "")
-            : vertexBuffer(buffer), vertexCount(count), name(n) {}
+        Mesh(uint32_t vertices, int vertexCount, uint32_t indices, int indexCount,
+             wgpu::IndexFormat format, const std::string& n = "")
+            : vertexRange(vertices), indexRange(indices), vertexCount(vertexCount), indexCount(indexCount),
+              indexFormat(format), name(n) {}
     };
 
     struct ZoomUniforms {
@@ -60,6 +81,14 @@ public:
     };
     static_assert(sizeof(ZoomUniforms) % 16 == 0);
 
+    struct OutlineUniforms {
+        float width;            // Sample radius in silhouette pixels
+        int32_t samples;        // Neighbours tested per pixel
+        float depthThreshold;   // Depth difference that counts as an edge
+        float _padding;
+    };
+    static_assert(sizeof(OutlineUniforms) % 16 == 0);
+
 public:
     Renderer() = default;
     ~Renderer() = default;
@@ -121,10 +150,52 @@ public:
      */
     bool loadMesh(const std::string& name, const std::string& filepath);
     
+    /**
+     * Register a mesh from an indexed triangle list already loaded (e.g.
+     * parsed on a worker thread with resource_manager::loadGeometryFromObj);
+     * GPU upload only. Meshes under 65536 vertices get 16-bit indices, and
+     * vertices are packed in the r.vertexFormat layout (see vertex_format.h).
+     */
+    bool createMesh(const std::string& name, const std::vector<resource_manager::VertexAttributes>& vertexData,
+                    const std::vector<uint32_t>& indexData);
+    
+    /**
+     * Release a mesh's geometry and registry slot; objects still showing it
+     * stop drawing (their cached handles go stale) until a mesh of that
+     * name is created again
+     * @return false if no mesh has that name
+     */
+    bool unloadMesh(const std::string& name);
+    
+    /**
+     * Resolve a mesh name once (hashed lookup, for loading and setup);
+     * per-frame code keeps the handle and uses getMesh()
+     */
+    MeshHandle findMesh(const std::string& name) const { return m_meshRegistry.find(name); }
+    
+    /**
+     * @return nullptr if the handle is stale
+     */
+    Renderer::Mesh* getMesh(MeshHandle handle) {
+        return m_meshRegistry.isValid(handle) ? &m_meshes[handle.index] : nullptr;
+    }
+    
     /**
      * Get mesh by name (for internal use)
      */
-    Renderer::Mesh* getMeshByName(const std::string& name);
+    Renderer::Mesh* getMeshByName(const std::string& name) { return getMesh(findMesh(name)); }
+    
+    /**
+     * Occupancy and fragmentation of all geometry buffers together;
+     * fragmentation is the worst of any single buffer
+     */
+    GeometryBufferStats getGeometryStats() const;
+    
+    /**
+     * Pack every geometry buffer's meshes together again (e.g. after
+     * unloading a level); allocation does this by itself when it must
+     */
+    void defragmentGeometry();
 
     // Zoom controls
     void setZoom(float zoom) { m_zoomUniforms.zoom = zoom; }
@@ -139,8 +210,11 @@ private:
     // Render Passes
     // ═══════════════════════════════════════════════════════════════════════
     
-    void renderSilhouettePass(wgpu::CommandEncoder& encoder, Scene* scene);
-    void renderMainPass(wgpu::CommandEncoder& encoder, Scene* scene);
+    void renderSilhouettePass(wgpu::CommandEncoder& encoder);
+    void renderMainPass(wgpu::CommandEncoder& encoder);
+    
+    // Issues the frame's batches, skipping binds that change nothing
+    void drawBatches(wgpu::RenderPassEncoder& renderPass, bool silhouette);
     void renderOutlineComposePass(wgpu::CommandEncoder& encoder);
     void renderUIPass(wgpu::CommandEncoder& encoder, UICallback uiCallback);
     void renderBlitPass(wgpu::CommandEncoder& encoder);
@@ -159,11 +233,11 @@ private:
     bool initDepthBuffer();
     void terminateDepthBuffer();
     
+    // Layouts shared by the mesh pipelines; the pipelines themselves are
+    // created per vertex layout the first time a mesh uses it
     bool initRenderPipeline();
     void terminateRenderPipeline();
-    
-    bool initSilhouettePipeline();
-    void terminateSilhouettePipeline();
+    bool createLayoutPipelines(VertexLayout layout);
     
     bool initOutlineComposePipeline();
     void terminateOutlineComposePipeline();
@@ -189,10 +263,36 @@ private:
     bool initGui();
     void terminateGui();
     
+    // Splits the sorted draw list into instanced batches and stages their data
+    void buildInstanceBatches();
+    void reserveInstances(size_t count);
+    void createBindGroup();
+    
+    // Uploads this frame's uniforms and instances into the next ring slot
+    void uploadFrameData();
+    void bindFrameData(wgpu::RenderPassEncoder& renderPass);
+    
     void createRenderTarget(uint32_t width, uint32_t height);
     void createSilhouetteTarget(uint32_t width, uint32_t height);
+    void createOutlineComposeBindGroup();
+    void createBlitBindGroup();
+    void writeOutlineUniforms();
     
     void onResize();
+    
+    // Picks up CVar changes (render size, present mode, outline settings)
+    void applyCVarChanges();
+    void recreateRenderTargets();
+    
+    void pollWorkDoneCallbacks();
+    
+    // Queue::writeBuffer that also counts the uploaded bytes for Metrics
+    void uploadBuffer(const wgpu::Buffer& buffer, uint64_t offset, const void* data, size_t size);
+    
+    GeometryBuffer& getIndexBuffer(wgpu::IndexFormat format) {
+        return m_indexBuffers[format == wgpu::IndexFormat::Uint16 ? 0 : 1];
+    }
+    void updateGeometryMetrics();
 
     // ═══════════════════════════════════════════════════════════════════════
     // Member Variables
@@ -215,14 +315,19 @@ private:
     wgpu::Texture m_depthTexture = nullptr;
     wgpu::TextureView m_depthTextureView = nullptr;
     
-    // Main Render Pipeline
+    // Mesh Pipelines (main pass and silhouettes for outlines), per vertex layout
+    struct LayoutPipelines {
+        wgpu::ShaderModule shader = nullptr;
+        wgpu::ShaderModule silhouetteShader = nullptr;
+        wgpu::RenderPipeline opaque = nullptr;
+        wgpu::RenderPipeline transparent = nullptr;     // same, without depth writes
+        wgpu::RenderPipeline silhouette = nullptr;
+    };
     wgpu::BindGroupLayout m_bindGroupLayout = nullptr;
-    wgpu::ShaderModule m_shaderModule = nullptr;
-    wgpu::RenderPipeline m_pipeline = nullptr;
+    wgpu::PipelineLayout m_pipelineLayout = nullptr;
+    LayoutPipelines m_layoutPipelines[kVertexLayoutCount];
     
-    // Silhouette Pipeline (for outlines)
-    wgpu::RenderPipeline m_silhouettePipeline = nullptr;
-    wgpu::ShaderModule m_silhouetteShader = nullptr;
+    // Silhouette Target
     wgpu::Texture m_silhouetteTexture = nullptr;
     wgpu::TextureView m_silhouetteView = nullptr;
     
@@ -231,6 +336,7 @@ private:
     wgpu::ShaderModule m_outlineComposeShader = nullptr;
     wgpu::BindGroup m_outlineComposeBindGroup = nullptr;
     wgpu::BindGroupLayout m_outlineComposeBindGroupLayout = nullptr;
+    wgpu::Buffer m_outlineUniformBuffer = nullptr;
     
     // Blit Pipeline (render target to swapchain)
     wgpu::RenderPipeline m_blitPipeline = nullptr;
@@ -256,8 +362,44 @@ private:
     wgpu::Texture m_texture = nullptr;
     wgpu::TextureView m_textureView = nullptr;
     
-    // Meshes
-    std::vector<Mesh> m_meshes;
+    // Meshes (m_meshRegistry slot i is m_meshes[i]); a deque so growing it
+    // never moves the meshes that batches and callers point at
+    std::deque<Mesh> m_meshes;
+    MeshRegistry m_meshRegistry;
+    
+    // Mesh geometry: vertices per layout, indices per format (Uint16, Uint32)
+    GeometryBuffer m_vertexBuffers[kVertexLayoutCount];
+    GeometryBuffer m_indexBuffers[2];
+    
+    // Visible objects of the frame being rendered, shared by all passes
+    DrawList m_drawList;
+    OcclusionCuller m_occlusionCuller;
+    std::unique_ptr<WorkerPool> m_workers;  // culling and occlusion threads, woken per frame
+    
+    // One draw per run of same-state items in the sorted draw list
+    struct InstanceBatch {
+        Mesh* mesh = nullptr;
+        uint32_t firstInstance = 0;
+        uint32_t instanceCount = 0;
+        bool transparent = false;
+    };
+    std::vector<InstanceBatch> m_batches;
+    
+    // Frame data ring: each slot holds one frame's uniforms followed by its
+    // instances, so the GPU can still be reading earlier frames while the
+    // next is written. Bound with dynamic offsets into the current slot.
+    static constexpr uint32_t kFramesInFlight = 3;
+    wgpu::Buffer m_frameRing = nullptr;
+    uint64_t m_frameSlotSize = 0;
+    uint64_t m_instanceOffset = 0;          // from the start of a slot
+    uint32_t m_frameSlot = 0;
+    size_t m_instanceCount = 0;
+    size_t m_instanceCapacity = 0;          // per slot
+    size_t m_maxInstances = 0;
+    size_t m_droppedInstances = 0;          // visible items over m_maxInstances last frame
+    uint32_t m_uniformAlignment = 256;
+    uint32_t m_storageAlignment = 256;
+    std::vector<uint8_t> m_frameData;       // staging for the slot's single writeBuffer
     
     // Bind Groups
     wgpu::BindGroup m_bindGroup = nullptr;
@@ -278,6 +420,25 @@ private:
     int m_windowWidth = 1280;
     int m_windowHeight = 720;
     
+    // Queue work-done callbacks for latency tracking, in submission order;
+    // each handle is kept alive until its callback has run
+    struct PendingWorkDone {
+        std::unique_ptr<wgpu::QueueWorkDoneCallback> handle;
+        std::shared_ptr<bool> fired;
+    };
+    std::deque<PendingWorkDone> m_workDoneCallbacks;
+    
+    // Render target size (applied; requested through r.width / r.height)
+    uint32_t m_renderWidth = 640;
+    uint32_t m_renderHeight = 360;
+    float m_displayWidth = 640.0f;
+    float m_displayHeight = 360.0f;
+    
+    // CVar versions last applied
+    uint32_t m_renderSizeVersion = 0;
+    uint32_t m_presentModeVersion = 0;
+    uint32_t m_outlineVersion = 0;
+    
     // Zoom uniforms
     wgpu::Buffer m_zoomUniformBuffer = nullptr;
     ZoomUniforms m_zoomUniforms{1.0f, 0.5f, 0.5f, 0.0f};
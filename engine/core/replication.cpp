@@ -0,0 +1,727 @@
+#include "replication.h"
+#include "animation_system.h"
+#include "collision_system.h"
+#include "cvar.h"
+#include "metrics.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace froggi {
+
+static AutoCVarInt cv_netSendRate("net.sendRate",
+    "Snapshots per second sent to each client", 20, 1, 120);
+static AutoCVarFloat cv_netRelevanceRadius("net.relevanceRadius",
+    "Objects farther than this from a client's focus are not sent to it", 60.0f, 1.0f, 100000.0f);
+static AutoCVarInt cv_netMaxPacketBytes("net.maxPacketBytes",
+    "Snapshot size limit; nearer objects are sent first", 1200, 200, static_cast<int>(Transport::kMaxPacketSize));
+static AutoCVarFloat cv_netClientTimeout("net.clientTimeout",
+    "Seconds without an acknowledgement before a client is dropped", 10.0f, 0.5f, 600.0f);
+static AutoCVarInt cv_netMaxClients("net.maxClients",
+    "Clients a replication server accepts", 64, 1, 4096);
+
+static MetricCounter metric_netBytesSent("net.bytes_sent");
+static MetricCounter metric_netSnapshots("net.snapshots_sent");
+static MetricGauge metric_netBytesPerClient("net.bytes_per_client");
+static MetricGauge metric_netServerUsPerClient("net.server_us_per_client");
+
+namespace {
+
+constexpr uint32_t kProtocolVersion = 1;
+constexpr double kHelloInterval = 0.5;
+
+enum class PacketType : uint8_t {
+    Hello = 1,
+    Snapshot,
+    Ack
+};
+
+// Which fields an entity record carries
+enum FieldMask : uint8_t {
+    Field_Position = 1 << 0,
+    Field_Rotation = 1 << 1,
+    Field_Scale = 1 << 2,
+    Field_Velocity = 1 << 3,
+    Field_Clip = 1 << 4,
+    Field_Frame = 1 << 5,
+    Field_Spawn = 1 << 6        // not in the baseline: type follows, deltas are from defaults
+};
+
+constexpr float kPositionScale = 512.0f;
+constexpr float kScaleScale = 1024.0f;
+constexpr float kVelocityScale = 256.0f;
+constexpr float kTwoPi = 6.28318530718f;
+
+///////////////////////////////////////////////////////////////////////////////
+// Packet encoding
+
+class PacketWriter {
+public:
+    explicit PacketWriter(std::vector<uint8_t>& out) : out(out) {}
+
+    void u8(uint8_t value) { out.push_back(value); }
+
+    void u16(uint16_t value) {
+        out.push_back(static_cast<uint8_t>(value));
+        out.push_back(static_cast<uint8_t>(value >> 8));
+    }
+
+    void u32(uint32_t value) {
+        for (int i = 0; i < 4; ++i) out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+    }
+
+    void f32(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        u32(bits);
+    }
+
+    void varint(uint32_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    // Zigzag: small magnitudes of either sign stay short
+    void svarint(int32_t value) {
+        varint((static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31));
+    }
+
+    void string(const std::string& value) {
+        varint(static_cast<uint32_t>(value.size()));
+        out.insert(out.end(), value.begin(), value.end());
+    }
+
+    void patchU16(size_t offset, uint16_t value) {
+        out[offset] = static_cast<uint8_t>(value);
+        out[offset + 1] = static_cast<uint8_t>(value >> 8);
+    }
+
+private:
+    std::vector<uint8_t>& out;
+};
+
+// Reads past the end return zeros and clear ok
+class PacketReader {
+public:
+    PacketReader(const uint8_t* data, size_t size) : data(data), size(size) {}
+
+    bool ok = true;
+
+    uint8_t u8() {
+        if (pos >= size) { ok = false; return 0; }
+        return data[pos++];
+    }
+
+    uint16_t u16() {
+        uint16_t lo = u8();
+        return static_cast<uint16_t>(lo | (u8() << 8));
+    }
+
+    uint32_t u32() {
+        uint32_t value = 0;
+        for (int i = 0; i < 4; ++i) value |= static_cast<uint32_t>(u8()) << (i * 8);
+        return value;
+    }
+
+    float f32() {
+        uint32_t bits = u32();
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    uint32_t varint() {
+        uint32_t value = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            uint8_t byte = u8();
+            value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        ok = false;
+        return 0;
+    }
+
+    int32_t svarint() {
+        uint32_t value = varint();
+        return static_cast<int32_t>((value >> 1) ^ (~(value & 1) + 1));
+    }
+
+    std::string string() {
+        uint32_t length = varint();
+        if (length > size - pos) { ok = false; return std::string(); }
+        std::string value(reinterpret_cast<const char*>(data + pos), length);
+        pos += length;
+        return value;
+    }
+
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t pos = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Quantization
+
+int32_t quantize(float value, float scale) {
+    double q = std::round(static_cast<double>(value) * scale);
+    return static_cast<int32_t>(std::max(-2147483647.0, std::min(2147483647.0, q)));
+}
+
+uint16_t quantizeAngle(float radians) {
+    double turns = static_cast<double>(radians) / kTwoPi;
+    turns -= std::floor(turns);
+    return static_cast<uint16_t>(static_cast<uint32_t>(std::lround(turns * 65536.0)) & 0xFFFF);
+}
+
+float dequantizeAngle(uint16_t value) {
+    int32_t signedValue = value >= 32768 ? static_cast<int32_t>(value) - 65536 : value;
+    return static_cast<float>(signedValue) * (kTwoPi / 65536.0f);
+}
+
+glm::vec3 dequantize(const int32_t q[3], float scale) {
+    return glm::vec3(static_cast<float>(q[0]), static_cast<float>(q[1]), static_cast<float>(q[2])) / scale;
+}
+
+// Reference for objects the baseline doesn't have
+NetEntityState defaultState(uint32_t netId, uint16_t type) {
+    NetEntityState state;
+    state.netId = netId;
+    state.type = type;
+    for (int32_t& s : state.scale) s = static_cast<int32_t>(kScaleScale);
+    return state;
+}
+
+bool sameArray(const int32_t a[3], const int32_t b[3]) {
+    return a[0] == b[0] && a[1] == b[1] && a[2] == b[2];
+}
+
+bool sameArray(const uint16_t a[3], const uint16_t b[3]) {
+    return a[0] == b[0] && a[1] == b[1] && a[2] == b[2];
+}
+
+uint8_t changedFields(const NetEntityState& state, const NetEntityState& ref) {
+    uint8_t mask = 0;
+    if (!sameArray(state.position, ref.position)) mask |= Field_Position;
+    if (!sameArray(state.rotation, ref.rotation)) mask |= Field_Rotation;
+    if (!sameArray(state.scale, ref.scale)) mask |= Field_Scale;
+    if (!sameArray(state.velocity, ref.velocity)) mask |= Field_Velocity;
+    if (state.clip != ref.clip) mask |= Field_Clip;
+    if (state.frame != ref.frame) mask |= Field_Frame;
+    return mask;
+}
+
+const NetEntityState* findEntity(const std::vector<NetEntityState>& entities, uint32_t netId) {
+    auto it = std::lower_bound(entities.begin(), entities.end(), netId,
+                               [](const NetEntityState& e, uint32_t id) { return e.netId < id; });
+    return it != entities.end() && it->netId == netId ? &*it : nullptr;
+}
+
+bool byNetId(const NetEntityState& a, const NetEntityState& b) {
+    return a.netId < b.netId;
+}
+
+// Sorted merge; entries of overrides replace those of base with the same netId
+void mergeEntities(const std::vector<NetEntityState>& base, const std::vector<NetEntityState>& overrides,
+                   std::vector<NetEntityState>& out) {
+    out.clear();
+    out.reserve(base.size() + overrides.size());
+    size_t i = 0, j = 0;
+    while (i < base.size() || j < overrides.size()) {
+        if (j == overrides.size() || (i < base.size() && base[i].netId < overrides[j].netId)) {
+            out.push_back(base[i++]);
+        } else {
+            if (i < base.size() && base[i].netId == overrides[j].netId) i++;
+            out.push_back(overrides[j++]);
+        }
+    }
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// ReplicationServer Implementation
+
+void ReplicationServer::update(Scene* scene, double time) {
+    receivePackets(time);
+
+    // Drop clients that went quiet
+    float timeout = cv_netClientTimeout.get();
+    clients.erase(std::remove_if(clients.begin(), clients.end(), [&](const Client& c) {
+        if (time - c.lastHeard <= timeout) return false;
+        FROGGI_LOG_INFO(Network, "Client %u (%s) timed out", c.id, c.address.toString().c_str());
+        return true;
+    }), clients.end());
+
+    if (time < nextSendTime) return;
+    double interval = 1.0 / static_cast<double>(cv_netSendRate.get());
+    // Don't try to catch up after a hitch
+    nextSendTime = std::max(nextSendTime + interval, time);
+
+    auto start = std::chrono::steady_clock::now();
+
+    stats = ReplicationStats();
+    stats.time = time;
+    stats.clients = static_cast<uint32_t>(clients.size());
+    if (scene) {
+        gatherWorld(scene);
+    } else {
+        world.clear();
+    }
+    for (Client& client : clients) {
+        sendSnapshot(client);
+    }
+
+    float elapsedUs = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count();
+    if (!clients.empty()) {
+        stats.bytesPerClient = static_cast<float>(stats.bytesSent) / static_cast<float>(clients.size());
+        stats.cpuUsPerClient = elapsedUs / static_cast<float>(clients.size());
+        metric_netBytesPerClient.set(stats.bytesPerClient);
+        metric_netServerUsPerClient.set(stats.cpuUsPerClient);
+    }
+    metric_netBytesSent.add(stats.bytesSent);
+    metric_netSnapshots.add(stats.snapshotsSent);
+}
+
+void ReplicationServer::setClientFocus(ClientId client, const glm::vec3& position) {
+    for (Client& c : clients) {
+        if (c.id != client) continue;
+        c.focus = position;
+        c.focusOverride = true;
+    }
+}
+
+void ReplicationServer::disconnect(ClientId client) {
+    clients.erase(std::remove_if(clients.begin(), clients.end(),
+                                 [client](const Client& c) { return c.id == client; }),
+                  clients.end());
+}
+
+std::vector<ReplicationServer::ClientId> ReplicationServer::getClients() const {
+    std::vector<ClientId> ids;
+    ids.reserve(clients.size());
+    for (const Client& c : clients) ids.push_back(c.id);
+    return ids;
+}
+
+void ReplicationServer::receivePackets(double time) {
+    NetAddress from;
+    while (transport->receive(from, received)) {
+        PacketReader reader(received.data(), received.size());
+        PacketType type = static_cast<PacketType>(reader.u8());
+
+        auto client = std::find_if(clients.begin(), clients.end(),
+                                   [&](const Client& c) { return c.address == from; });
+
+        if (type == PacketType::Hello) {
+            if (reader.u32() != kProtocolVersion || !reader.ok) continue;
+            if (client != clients.end()) {
+                client->lastHeard = time;
+                continue;
+            }
+            if (clients.size() >= static_cast<size_t>(cv_netMaxClients.get())) {
+                FROGGI_LOG_WARN(Network, "Refusing %s: server full", from.toString().c_str());
+                continue;
+            }
+            Client added;
+            added.id = nextClientId++;
+            added.address = from;
+            added.lastHeard = time;
+            clients.push_back(std::move(added));
+            FROGGI_LOG_INFO(Network, "Client %u connected from %s", clients.back().id, from.toString().c_str());
+        } else if (type == PacketType::Ack && client != clients.end()) {
+            uint32_t sequence = reader.u32();
+            glm::vec3 focus;
+            focus.x = reader.f32();
+            focus.y = reader.f32();
+            focus.z = reader.f32();
+            if (!reader.ok) continue;
+
+            client->lastHeard = time;
+            if (!client->focusOverride) client->focus = focus;
+            // Only snapshots still in the history can serve as a baseline
+            if (sequence > client->ackedSequence && client->history[sequence % kHistory].sequence == sequence) {
+                client->ackedSequence = sequence;
+            }
+        }
+    }
+}
+
+void ReplicationServer::gatherWorld(Scene* scene) {
+    world.clear();
+    for (Component* component : scene->components) {
+        Replicated* replicated = dynamic_cast<Replicated*>(component);
+        if (!replicated || !replicated->enabled || !replicated->owner || !replicated->owner->active) continue;
+
+        GameObject* obj = replicated->owner;
+        if (replicated->netId == 0) replicated->netId = nextNetId++;
+
+        WorldEntity entity;
+        entity.position = obj->position;
+        entity.alwaysRelevant = replicated->alwaysRelevant;
+
+        NetEntityState& state = entity.state;
+        state.netId = replicated->netId;
+        state.type = replicated->type;
+        for (int i = 0; i < 3; ++i) {
+            state.position[i] = quantize(obj->position[i], kPositionScale);
+            state.rotation[i] = quantizeAngle(obj->rotation[i]);
+            state.scale[i] = quantize(obj->scale[i], kScaleScale);
+        }
+        if (Rigidbody* rb = obj->getComponent<Rigidbody>()) {
+            for (int i = 0; i < 3; ++i) state.velocity[i] = quantize(rb->velocity[i], kVelocityScale);
+        }
+        if (Animator* animator = obj->getComponent<Animator>()) {
+            if (!animator->getCurrentClip().empty()) {
+                state.clip = clipIndex(animator->getCurrentClip());
+                state.frame = static_cast<uint16_t>(std::max(0, animator->getCurrentFrame()));
+            }
+        }
+        world.push_back(entity);
+    }
+    std::sort(world.begin(), world.end(),
+              [](const WorldEntity& a, const WorldEntity& b) { return a.state.netId < b.state.netId; });
+}
+
+void ReplicationServer::sendSnapshot(Client& client) {
+    // ═══════════════════════════════════════════════════════════════
+    // BASELINE (last acknowledged snapshot, or nothing)
+    // ═══════════════════════════════════════════════════════════════
+    static const std::vector<NetEntityState> kEmpty;
+    const SentSnapshot& acked = client.history[client.ackedSequence % kHistory];
+    bool hasBaseline = client.ackedSequence != 0 && acked.sequence == client.ackedSequence;
+    const std::vector<NetEntityState>& base = hasBaseline ? acked.entities : kEmpty;
+
+    // ═══════════════════════════════════════════════════════════════
+    // RELEVANCE & CHANGES
+    // ═══════════════════════════════════════════════════════════════
+    float radius = cv_netRelevanceRadius.get();
+    float radiusSq = radius * radius;
+    candidates.clear();
+    relevant.assign(world.size(), 0);
+    for (uint32_t i = 0; i < world.size(); ++i) {
+        const WorldEntity& entity = world[i];
+        glm::vec3 offset = entity.position - client.focus;
+        float distanceSq = glm::dot(offset, offset);
+        if (!entity.alwaysRelevant && distanceSq > radiusSq) continue;
+        relevant[i] = 1;
+
+        const NetEntityState* before = findEntity(base, entity.state.netId);
+        if (before && changedFields(entity.state, *before) == 0) continue;
+        candidates.push_back({ entity.alwaysRelevant ? 0.0f : distanceSq, i });
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    // ═══════════════════════════════════════════════════════════════
+    // ENCODE (removals first, then nearest changes until the packet is full)
+    // ═══════════════════════════════════════════════════════════════
+    size_t budget = static_cast<size_t>(cv_netMaxPacketBytes.get());
+    uint32_t sequence = client.nextSequence++;
+
+    packet.clear();
+    PacketWriter writer(packet);
+    writer.u8(static_cast<uint8_t>(PacketType::Snapshot));
+    writer.u32(sequence);
+    writer.u32(hasBaseline ? client.ackedSequence : 0);
+    size_t removedCountOffset = packet.size();
+    writer.u16(0);
+    size_t entityCountOffset = packet.size();
+    writer.u16(0);
+
+    // Objects that left relevance or the scene
+    kept.clear();
+    uint16_t removedCount = 0;
+    for (const NetEntityState& before : base) {
+        auto it = std::lower_bound(world.begin(), world.end(), before.netId,
+                                   [](const WorldEntity& e, uint32_t id) { return e.state.netId < id; });
+        bool stillRelevant = it != world.end() && it->state.netId == before.netId && relevant[it - world.begin()];
+        // Keep half the packet for changes; the rest go next time
+        if (!stillRelevant && packet.size() + 5 <= budget / 2 && removedCount < UINT16_MAX) {
+            writer.varint(before.netId);
+            removedCount++;
+            continue;
+        }
+        kept.push_back(before);
+    }
+
+    written.clear();
+    PacketWriter recordWriter(record);
+    for (const auto& candidate : candidates) {
+        if (written.size() >= UINT16_MAX) break;
+        const NetEntityState& state = world[candidate.second].state;
+        const NetEntityState* before = findEntity(kept, state.netId);
+        NetEntityState ref = before ? *before : defaultState(state.netId, state.type);
+
+        uint8_t mask = changedFields(state, ref);
+        if (!before) mask |= Field_Spawn;
+
+        record.clear();
+        recordWriter.varint(state.netId);
+        recordWriter.u8(mask);
+        if (mask & Field_Spawn) recordWriter.varint(state.type);
+        if (mask & Field_Position) {
+            for (int i = 0; i < 3; ++i) recordWriter.svarint(state.position[i] - ref.position[i]);
+        }
+        if (mask & Field_Rotation) {
+            for (int i = 0; i < 3; ++i) {
+                recordWriter.svarint(static_cast<int16_t>(static_cast<uint16_t>(state.rotation[i] - ref.rotation[i])));
+            }
+        }
+        if (mask & Field_Scale) {
+            for (int i = 0; i < 3; ++i) recordWriter.svarint(state.scale[i] - ref.scale[i]);
+        }
+        if (mask & Field_Velocity) {
+            for (int i = 0; i < 3; ++i) recordWriter.svarint(state.velocity[i] - ref.velocity[i]);
+        }
+        if (mask & Field_Clip) recordWriter.string(clipNames[state.clip]);
+        if (mask & Field_Frame) recordWriter.varint(state.frame);
+
+        if (packet.size() + record.size() > budget) break;
+        packet.insert(packet.end(), record.begin(), record.end());
+        written.push_back(state);
+    }
+
+    writer.patchU16(removedCountOffset, removedCount);
+    writer.patchU16(entityCountOffset, static_cast<uint16_t>(written.size()));
+
+    // ═══════════════════════════════════════════════════════════════
+    // SEND & REMEMBER (what the client will have if this arrives)
+    // ═══════════════════════════════════════════════════════════════
+    if (!transport->send(client.address, packet.data(), packet.size())) {
+        FROGGI_LOG_WARN(Network, "Snapshot send to %s failed", client.address.toString().c_str());
+    }
+
+    std::sort(written.begin(), written.end(), byNetId);
+    // May overwrite the baseline's slot; kept already holds what was needed
+    SentSnapshot& slot = client.history[sequence % kHistory];
+    mergeEntities(kept, written, slot.entities);
+    slot.sequence = sequence;
+
+    stats.snapshotsSent++;
+    stats.bytesSent += packet.size();
+}
+
+uint16_t ReplicationServer::clipIndex(const std::string& name) {
+    auto it = clipIndices.find(name);
+    if (it != clipIndices.end()) return it->second;
+    if (clipNames.size() >= UINT16_MAX) return 0;
+    uint16_t index = static_cast<uint16_t>(clipNames.size());
+    clipNames.push_back(name);
+    clipIndices.emplace(name, index);
+    return index;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// ReplicationClient Implementation
+
+void ReplicationClient::connect(const NetAddress& address) {
+    server = address;
+    connected = true;
+    nextHelloTime = 0.0;
+    latestSequence = 0;
+    appliedSequence = 0;
+    for (ReceivedSnapshot& snapshot : history) snapshot = ReceivedSnapshot();
+}
+
+void ReplicationClient::update(Scene* scene, double time) {
+    if (!connected) return;
+
+    // Say hello until the first snapshot arrives
+    if (latestSequence == 0 && time >= nextHelloTime) {
+        std::vector<uint8_t> hello;
+        PacketWriter writer(hello);
+        writer.u8(static_cast<uint8_t>(PacketType::Hello));
+        writer.u32(kProtocolVersion);
+        transport->send(server, hello.data(), hello.size());
+        nextHelloTime = time + kHelloInterval;
+    }
+
+    NetAddress from;
+    bool gotSnapshot = false;
+    while (transport->receive(from, received)) {
+        if (from != server) continue;
+        bytesReceived += received.size();
+        if (decodeSnapshot(received)) gotSnapshot = true;
+    }
+    if (gotSnapshot) sendAck();
+
+    if (scene && latestSequence != appliedSequence) {
+        applySnapshot(scene, history[latestSequence % kHistory]);
+        appliedSequence = latestSequence;
+    }
+}
+
+size_t ReplicationClient::getEntityCount() const {
+    return latestSequence ? history[latestSequence % kHistory].entities.size() : 0;
+}
+
+bool ReplicationClient::decodeSnapshot(const std::vector<uint8_t>& data) {
+    PacketReader reader(data.data(), data.size());
+    if (static_cast<PacketType>(reader.u8()) != PacketType::Snapshot) return false;
+
+    uint32_t sequence = reader.u32();
+    uint32_t baselineSequence = reader.u32();
+    uint16_t removedCount = reader.u16();
+    uint16_t entityCount = reader.u16();
+    // Older than what we have (reordered): the newer one already supersedes it
+    if (!reader.ok || sequence <= latestSequence) return false;
+
+    static const std::vector<NetEntityState> kEmpty;
+    const ReceivedSnapshot& baseSlot = history[baselineSequence % kHistory];
+    if (baselineSequence != 0 && baseSlot.sequence != baselineSequence) return false;
+    const std::vector<NetEntityState>& base = baselineSequence ? baseSlot.entities : kEmpty;
+
+    std::vector<uint32_t> removed(removedCount);
+    for (uint32_t& netId : removed) netId = reader.varint();
+    std::sort(removed.begin(), removed.end());
+
+    std::vector<NetEntityState> kept;
+    kept.reserve(base.size());
+    for (const NetEntityState& state : base) {
+        if (!std::binary_search(removed.begin(), removed.end(), state.netId)) kept.push_back(state);
+    }
+
+    std::vector<NetEntityState> changed;
+    changed.reserve(entityCount);
+    for (uint16_t e = 0; e < entityCount && reader.ok; ++e) {
+        uint32_t netId = reader.varint();
+        uint8_t mask = reader.u8();
+
+        NetEntityState state;
+        if (mask & Field_Spawn) {
+            state = defaultState(netId, static_cast<uint16_t>(reader.varint()));
+        } else {
+            const NetEntityState* before = findEntity(kept, netId);
+            if (!before) return false;
+            state = *before;
+        }
+
+        if (mask & Field_Position) {
+            for (int32_t& v : state.position) v += reader.svarint();
+        }
+        if (mask & Field_Rotation) {
+            for (uint16_t& v : state.rotation) v = static_cast<uint16_t>(v + reader.svarint());
+        }
+        if (mask & Field_Scale) {
+            for (int32_t& v : state.scale) v += reader.svarint();
+        }
+        if (mask & Field_Velocity) {
+            for (int32_t& v : state.velocity) v += reader.svarint();
+        }
+        if (mask & Field_Clip) state.clip = clipIndex(reader.string());
+        if (mask & Field_Frame) state.frame = static_cast<uint16_t>(reader.varint());
+        changed.push_back(state);
+    }
+    if (!reader.ok) return false;
+
+    std::sort(changed.begin(), changed.end(), byNetId);
+    ReceivedSnapshot& slot = history[sequence % kHistory];
+    std::vector<NetEntityState> merged;
+    mergeEntities(kept, changed, merged);
+    slot.entities.swap(merged);
+    slot.sequence = sequence;
+    latestSequence = sequence;
+    return true;
+}
+
+void ReplicationClient::sendAck() {
+    std::vector<uint8_t> ack;
+    PacketWriter writer(ack);
+    writer.u8(static_cast<uint8_t>(PacketType::Ack));
+    writer.u32(latestSequence);
+    writer.f32(focus.x);
+    writer.f32(focus.y);
+    writer.f32(focus.z);
+    transport->send(server, ack.data(), ack.size());
+}
+
+void ReplicationClient::applySnapshot(Scene* scene, const ReceivedSnapshot& snapshot) {
+    // Objects of a previous scene are gone
+    if (scene != appliedScene) {
+        objects.clear();
+        appliedScene = scene;
+    }
+
+    // Copies the game created itself (or that were deactivated earlier)
+    std::unordered_map<uint32_t, GameObject*> existing;
+    bool scanned = false;
+
+    for (const NetEntityState& state : snapshot.entities) {
+        auto found = objects.find(state.netId);
+        GameObject* obj = found != objects.end() ? found->second : nullptr;
+
+        if (!obj) {
+            if (!scanned) {
+                for (Component* component : scene->components) {
+                    Replicated* replicated = dynamic_cast<Replicated*>(component);
+                    if (replicated && replicated->owner && replicated->netId != 0) {
+                        existing.emplace(replicated->netId, replicated->owner);
+                    }
+                }
+                scanned = true;
+            }
+            auto it = existing.find(state.netId);
+            if (it != existing.end()) {
+                obj = it->second;
+            } else if (spawnCallback) {
+                obj = spawnCallback(scene, state.netId, state.type);
+                if (obj) {
+                    if (Replicated* replicated = obj->getComponent<Replicated>()) {
+                        replicated->netId = state.netId;
+                        replicated->type = state.type;
+                    }
+                }
+            }
+            if (!obj) continue;
+            objects[state.netId] = obj;
+        }
+
+        obj->active = true;
+        obj->position = dequantize(state.position, kPositionScale);
+        obj->rotation = glm::vec3(dequantizeAngle(state.rotation[0]), dequantizeAngle(state.rotation[1]),
+                                  dequantizeAngle(state.rotation[2]));
+        obj->scale = dequantize(state.scale, kScaleScale);
+
+        if (Rigidbody* rb = obj->getComponent<Rigidbody>()) {
+            rb->velocity = dequantize(state.velocity, kVelocityScale);
+        }
+        if (state.clip != 0) {
+            if (Animator* animator = obj->getComponent<Animator>()) {
+                const std::string& clip = clipNames[state.clip];
+                if (animator->getCurrentClip() != clip) animator->play(clip);
+                if (animator->getCurrentFrame() != state.frame) animator->seekFrame(state.frame);
+            }
+        }
+    }
+
+    // Objects that left this client's view
+    for (auto it = objects.begin(); it != objects.end();) {
+        if (findEntity(snapshot.entities, it->first)) {
+            ++it;
+            continue;
+        }
+        if (despawnCallback) {
+            despawnCallback(scene, it->second);
+        } else {
+            it->second->active = false;
+        }
+        it = objects.erase(it);
+    }
+}
+
+uint16_t ReplicationClient::clipIndex(const std::string& name) {
+    if (name.empty()) return 0;
+    auto it = clipIndices.find(name);
+    if (it != clipIndices.end()) return it->second;
+    if (clipNames.size() >= UINT16_MAX) return 0;
+    uint16_t index = static_cast<uint16_t>(clipNames.size());
+    clipNames.push_back(name);
+    clipIndices.emplace(name, index);
+    return index;
+}
+
+} // namespace froggi
@@ -0,0 +1,206 @@
+#pragma once
+
+#include "pond_interface.h"
+#include "net_transport.h"
+#include <array>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace froggi {
+
+///////////////////////////////////////////////////////////////////////////////
+// Replicated - Marks a GameObject for network replication
+//
+// The server sends the object's transform, its Rigidbody velocity and its
+// Animator clip and frame to every client it is relevant to. Clients find
+// their copy by netId, or create one through ReplicationClient's spawn
+// callback using the game-defined type.
+
+class Replicated : public Component {
+public:
+    uint32_t netId = 0;             // assigned by the server when 0
+    uint16_t type = 0;              // game-defined, tells clients what to spawn
+    bool alwaysRelevant = false;    // ignore the distance filter (e.g. game state objects)
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Quantized entity state (what a snapshot holds per object)
+
+struct NetEntityState {
+    uint32_t netId = 0;
+    uint16_t type = 0;
+    uint16_t clip = 0;              // index into the sender's clip name table (0 = none)
+    uint16_t frame = 0;
+    uint16_t rotation[3] = {};      // full turn in 65536 steps
+    int32_t position[3] = {};       // 1/512 units
+    int32_t scale[3] = {};          // 1/1024 units
+    int32_t velocity[3] = {};       // 1/256 units per second
+};
+
+struct ReplicationStats {
+    uint32_t clients = 0;
+    uint32_t snapshotsSent = 0;     // in the last send round
+    uint64_t bytesSent = 0;         // in the last send round
+    float bytesPerClient = 0.0f;    // per snapshot
+    float cpuUsPerClient = 0.0f;    // server time spent per client per snapshot
+    double time = 0.0;              // when the last send round ran
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ReplicationServer - Authoritative snapshot sender
+//
+// Every net.sendRate-th of a second each client gets a snapshot of the
+// replicated objects within net.relevanceRadius of its focus point, encoded
+// as a delta against the last snapshot it acknowledged: unchanged objects
+// cost nothing and changed fields are sent as small varint differences.
+// When the changes don't fit one packet the nearest objects go first; the
+// rest keep their acknowledged state and catch up in later snapshots. Lost
+// snapshots are never resent - the next one is simply relative to an
+// older acknowledgement.
+//
+// Clients connect by sending a hello packet and report their focus point
+// with each acknowledgement; servers can override it with setClientFocus.
+
+class ReplicationServer {
+public:
+    using ClientId = uint32_t;
+
+    explicit ReplicationServer(Transport* transport) : transport(transport) {}
+
+    /**
+     * Receive acks and hellos; send snapshots when due (call once per frame)
+     */
+    void update(Scene* scene, double time);
+
+    void setClientFocus(ClientId client, const glm::vec3& position);
+    void disconnect(ClientId client);
+
+    std::vector<ClientId> getClients() const;
+    const ReplicationStats& getStats() const { return stats; }
+
+private:
+    static constexpr size_t kHistory = 32;
+
+    struct SentSnapshot {
+        uint32_t sequence = 0;
+        std::vector<NetEntityState> entities;   // sorted by netId
+    };
+
+    struct Client {
+        ClientId id = 0;
+        NetAddress address;
+        glm::vec3 focus = glm::vec3(0.0f);
+        bool focusOverride = false;
+        uint32_t nextSequence = 1;
+        uint32_t ackedSequence = 0;
+        double lastHeard = 0.0;
+        std::array<SentSnapshot, kHistory> history;
+    };
+
+    struct WorldEntity {
+        NetEntityState state;
+        glm::vec3 position;
+        bool alwaysRelevant;
+    };
+
+    void receivePackets(double time);
+    void gatherWorld(Scene* scene);
+    void sendSnapshot(Client& client);
+    uint16_t clipIndex(const std::string& name);
+
+    Transport* transport;
+    std::vector<Client> clients;
+    ClientId nextClientId = 1;
+    uint32_t nextNetId = 1;
+    double nextSendTime = 0.0;
+
+    std::vector<WorldEntity> world;                         // sorted by netId
+    std::vector<std::string> clipNames{ std::string() };    // index 0 = no clip
+    std::unordered_map<std::string, uint16_t> clipIndices;
+
+    // Scratch reused across clients
+    std::vector<std::pair<float, uint32_t>> candidates;
+    std::vector<uint8_t> relevant;
+    std::vector<NetEntityState> kept;
+    std::vector<NetEntityState> written;
+    std::vector<uint8_t> record;
+    std::vector<uint8_t> packet;
+    std::vector<uint8_t> received;
+
+    ReplicationStats stats;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ReplicationClient - Applies server snapshots to a local scene
+
+class ReplicationClient {
+public:
+    using SpawnCallback = std::function<GameObject*(Scene* scene, uint32_t netId, uint16_t type)>;
+    using DespawnCallback = std::function<void(Scene* scene, GameObject* object)>;
+
+    explicit ReplicationClient(Transport* transport) : transport(transport) {}
+
+    void connect(const NetAddress& server);
+
+    /**
+     * Called for objects the client has no copy of; return nullptr to ignore
+     * the object. The returned object needs a Replicated component.
+     */
+    void setSpawnCallback(SpawnCallback callback) { spawnCallback = std::move(callback); }
+
+    /**
+     * Called when an object leaves the client's view (default: deactivate)
+     */
+    void setDespawnCallback(DespawnCallback callback) { despawnCallback = std::move(callback); }
+
+    /**
+     * Where this client is looking; sent with every acknowledgement
+     */
+    void setFocus(const glm::vec3& position) { focus = position; }
+
+    /**
+     * Receive snapshots, acknowledge the newest and apply it to the scene
+     */
+    void update(Scene* scene, double time);
+
+    uint32_t getLatestSequence() const { return latestSequence; }
+    uint64_t getBytesReceived() const { return bytesReceived; }
+    size_t getEntityCount() const;
+
+private:
+    static constexpr size_t kHistory = 32;
+
+    struct ReceivedSnapshot {
+        uint32_t sequence = 0;
+        std::vector<NetEntityState> entities;   // sorted by netId
+    };
+
+    bool decodeSnapshot(const std::vector<uint8_t>& data);
+    void applySnapshot(Scene* scene, const ReceivedSnapshot& snapshot);
+    void sendAck();
+    uint16_t clipIndex(const std::string& name);
+
+    Transport* transport;
+    NetAddress server;
+    bool connected = false;
+    double nextHelloTime = 0.0;
+    glm::vec3 focus = glm::vec3(0.0f);
+
+    std::array<ReceivedSnapshot, kHistory> history;
+    uint32_t latestSequence = 0;
+    uint32_t appliedSequence = 0;
+    uint64_t bytesReceived = 0;
+
+    std::vector<std::string> clipNames{ std::string() };
+    std::unordered_map<std::string, uint16_t> clipIndices;
+    std::unordered_map<uint32_t, GameObject*> objects;
+    Scene* appliedScene = nullptr;
+
+    SpawnCallback spawnCallback;
+    DespawnCallback despawnCallback;
+    std::vector<uint8_t> received;
+};
+
+} // namespace froggi
@@ -1,10 +1,14 @@
 #include "resource_manager.h"
+#include "mesh_optimizer.h"
+#include "metrics.h"
+#include "log.h"
 
 #include "stb_image.h"
 #include "tiny_obj_loader.h"
 
 #include <fstream>
 #include <cstring>
+#include <unordered_map>
 
 using namespace wgpu;
 
@@ -20,7 +24,7 @@ float resource_manager::CamRotation[16] = {
 float resource_manager::CamRotationState = resource_manager::CamRotation[0];
 
 
-ShaderModule resource_manager::loadShaderModule(const path& path, Device device) {
+ShaderModule resource_manager::loadShaderModule(const path& path, Device device, const std::string& prelude) {
 	std::ifstream file(path);
 	if (!file.is_open()) {
 		return nullptr;
@@ -30,6 +34,7 @@ ShaderModule resource_manager::loadShaderModule(const path& path, Device device)
 	std::string shaderSource(size, ' ');
 	file.seekg(0);
 	file.read(shaderSource.data(), size);
+	shaderSource.insert(0, prelude);
 
 	ShaderModuleWGSLDescriptor shaderCodeDesc;
 	shaderCodeDesc.chain.next = nullptr;
@@ -45,7 +50,30 @@ ShaderModule resource_manager::loadShaderModule(const path& path, Device device)
 	return device.createShaderModule(shaderDesc);
 }
 
-bool resource_manager::loadGeometryFromObj(const path& path, std::vector<VertexAttributes>& vertexData) {
+// Face corners with identical attributes become one vertex
+struct VertexHash {
+	size_t operator()(const resource_manager::VertexAttributes& vertex) const {
+		uint32_t words[sizeof(resource_manager::VertexAttributes) / sizeof(uint32_t)];
+		memcpy(words, &vertex, sizeof(words));
+		uint64_t hash = 14695981039346656037ull;
+		for (uint32_t word : words) {
+			hash = (hash ^ word) * 1099511628211ull;
+		}
+		return static_cast<size_t>(hash ^ (hash >> 32));
+	}
+};
+
+struct VertexEqual {
+	bool operator()(const resource_manager::VertexAttributes& a, const resource_manager::VertexAttributes& b) const {
+		return memcmp(&a, &b, sizeof(a)) == 0;
+	}
+};
+
+static_assert(sizeof(resource_manager::VertexAttributes) == 11 * sizeof(float),
+              "VertexAttributes is hashed and compared bytewise; it must not have padding");
+
+bool resource_manager::loadGeometryFromObj(const path& path, std::vector<VertexAttributes>& vertexData,
+                                           std::vector<uint32_t>& indexData) {
 	tinyobj::attrib_t attrib;
 	std::vector<tinyobj::shape_t> shapes;
 	std::vector<tinyobj::material_t> materials;
@@ -58,74 +86,116 @@ bool resource_manager::loadGeometryFromObj(const path& path, std::vector<VertexA
 
 	// Check errors
 	if (!warn.empty()) {
-		std::cout << warn << std::endl;
+		FROGGI_LOG_WARN(Assets, "%s", warn.c_str());
 	}
 
 	if (!err.empty()) {
-		std::cerr << err << std::endl;
+		FROGGI_LOG_ERROR(Assets, "%s", err.c_str());
 	}
 
 	if (!ret) {
 		return false;
 	}
 
-// Filling in vertexData:
-	vertexData.clear();
+	size_t cornerCount = 0;
 	for (const auto& shape : shapes) {
-		size_t offset = vertexData.size();
-		vertexData.resize(offset + shape.mesh.indices.size());
+		cornerCount += shape.mesh.indices.size();
+	}
+
+// Filling in vertexData and indexData, one vertex per distinct corner:
+	vertexData.clear();
+	indexData.clear();
+	indexData.reserve(cornerCount);
+	std::unordered_map<VertexAttributes, uint32_t, VertexHash, VertexEqual> vertexIndices;
+	vertexIndices.reserve(cornerCount / 2);
 
+	for (const auto& shape : shapes) {
 		for (size_t i = 0; i < shape.mesh.indices.size(); ++i) {
 			const tinyobj::index_t& idx = shape.mesh.indices[i];
+			VertexAttributes vertex;
 
 			// Position (required)
 			if (idx.vertex_index >= 0 && (3 * static_cast<size_t>(idx.vertex_index) + 2) < attrib.vertices.size()) {
-				vertexData[offset + i].position = {
+				vertex.position = {
 					attrib.vertices[3 * idx.vertex_index + 0],
 					-attrib.vertices[3 * idx.vertex_index + 2],
 					attrib.vertices[3 * idx.vertex_index + 1]
 				};
 			} else {
-				vertexData[offset + i].position = {0.0f, 0.0f, 0.0f};
+				vertex.position = {0.0f, 0.0f, 0.0f};
 			}
 
 			// Normal (optional - default to up)
 			if (idx.normal_index >= 0 && (3 * static_cast<size_t>(idx.normal_index) + 2) < attrib.normals.size()) {
-				vertexData[offset + i].normal = {
+				vertex.normal = {
 					attrib.normals[3 * idx.normal_index + 0],
 					-attrib.normals[3 * idx.normal_index + 2],
 					attrib.normals[3 * idx.normal_index + 1]
 				};
 			} else {
-				vertexData[offset + i].normal = {0.0f, 0.0f, 1.0f};
+				vertex.normal = {0.0f, 0.0f, 1.0f};
 			}
 
 			// Color (optional - default to white)
 			if (!attrib.colors.empty() && (3 * static_cast<size_t>(idx.vertex_index) + 2) < attrib.colors.size()) {
-				vertexData[offset + i].color = {
+				vertex.color = {
 					attrib.colors[3 * idx.vertex_index + 0],
 					attrib.colors[3 * idx.vertex_index + 1],
 					attrib.colors[3 * idx.vertex_index + 2]
 				};
 			} else {
-				vertexData[offset + i].color = {1.0f, 1.0f, 1.0f};
+				vertex.color = {1.0f, 1.0f, 1.0f};
 			}
 
 			// UV (optional - default to 0,0)
 			if (idx.texcoord_index >= 0 && (2 * static_cast<size_t>(idx.texcoord_index) + 1) < attrib.texcoords.size()) {
-				vertexData[offset + i].uv = {
+				vertex.uv = {
 					attrib.texcoords[2 * idx.texcoord_index + 0],
 					1 - attrib.texcoords[2 * idx.texcoord_index + 1]
 				};
 			} else {
-				vertexData[offset + i].uv = {0.0f, 0.0f};
+				vertex.uv = {0.0f, 0.0f};
+			}
+
+			auto inserted = vertexIndices.emplace(vertex, static_cast<uint32_t>(vertexData.size()));
+			if (inserted.second) {
+				vertexData.push_back(vertex);
 			}
+			indexData.push_back(inserted.first->second);
+		}
+	}
+
+// Reordering: triangles for the post-transform cache, then vertices in first-use order
+	bool logStats = froggi::Log::isEnabled(froggi::LogLevel::Debug, froggi::LogCategory::Assets);
+	float acmrBefore = logStats ? froggi::analyzeVertexCache(indexData, vertexData.size()) : 0.0f;
+
+	froggi::optimizeVertexCache(indexData, vertexData.size());
+
+	std::vector<uint32_t> remap;
+	size_t usedVertices = froggi::buildVertexFetchRemap(remap, indexData, vertexData.size());
+	std::vector<VertexAttributes> reordered(usedVertices);
+	for (size_t v = 0; v < vertexData.size(); ++v) {
+		if (remap[v] != froggi::kUnusedVertex) {
+			reordered[remap[v]] = vertexData[v];
 		}
 	}
+	vertexData.swap(reordered);
+	for (uint32_t& index : indexData) {
+		index = remap[index];
+	}
+
+	if (logStats) {
+		FROGGI_LOG_DEBUG(Assets, "%s: %zu corners -> %zu vertices, ACMR %.2f -> %.2f",
+		                 path.filename().string().c_str(), cornerCount, vertexData.size(), acmrBefore,
+		                 froggi::analyzeVertexCache(indexData, vertexData.size()));
+	}
 
 	return true;
 }
 
+static froggi::MetricCounter metric_uploadBytes("render.upload_bytes");
+static froggi::MetricGauge metric_textures("assets.textures");
+
 // Auxiliary function for loadTexture
 static void writeMipMaps(
 	Device device,
@@ -182,6 +252,7 @@ static void writeMipMaps(
 		source.bytesPerRow = 4 * mipLevelSize.width;
 		source.rowsPerImage = mipLevelSize.height;
 		queue.writeTexture(destination, pixels.data(), pixels.size(), source, mipLevelSize);
+		metric_uploadBytes.add(pixels.size());
 
 		previousLevelPixels = std::move(pixels);
 		previousMipLevelSize = mipLevelSize;
@@ -221,6 +292,7 @@ Texture resource_manager::loadTexture(const path& path, Device device, TextureVi
 
 	stbi_image_free(pixelData);
 	// (Do not use data after this)
+	metric_textures.add(1.0);
 
 	if (pTextureView) {
 		TextureViewDescriptor textureViewDesc;
@@ -4,6 +4,7 @@
 #include <glm/glm.hpp>
 
 #include <vector>
+#include <string>
 #include <filesystem>
 
 class resource_manager {
@@ -24,11 +25,15 @@ public:
 		vec3 color;
 		vec2 uv;
 	};
-	// Load a shader from a WGSL file into a new shader module
-	static wgpu::ShaderModule loadShaderModule(const path& path, wgpu::Device device);
-
-	// Load an 3D mesh from a standard .obj file into a vertex data buffer
-	static bool loadGeometryFromObj(const path& path, std::vector<VertexAttributes>& vertexData);
+	// Load a shader from a WGSL file into a new shader module; prelude is
+	// inserted before the file's source (e.g. per vertex layout declarations)
+	static wgpu::ShaderModule loadShaderModule(const path& path, wgpu::Device device,
+	                                           const std::string& prelude = "");
+
+	// Load an 3D mesh from a standard .obj file into deduplicated vertices and a
+	// triangle list index buffer, both reordered for the GPU's vertex caches
+	static bool loadGeometryFromObj(const path& path, std::vector<VertexAttributes>& vertexData,
+	                                std::vector<uint32_t>& indexData);
 
 	// Load an image from a standard image file into a new texture object
 	// NB: The texture must be destroyed after use
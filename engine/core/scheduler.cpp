@@ -0,0 +1,241 @@
+#include "scheduler.h"
+#include "metrics.h"
+#include <algorithm>
+#include <cmath>
+
+namespace froggi {
+
+static MetricCounter metric_timersFired("scheduler.timers_fired");
+
+namespace {
+
+// Tick a clock at time stands on (the last one it reached)
+uint64_t clockTick(double time) {
+    return time > 0.0 ? static_cast<uint64_t>(std::floor(time / Scheduler::kTickSeconds + 1e-6)) : 0;
+}
+
+// First tick at or after a deadline
+uint64_t deadlineTick(double time) {
+    return time > 0.0 ? static_cast<uint64_t>(std::ceil(time / Scheduler::kTickSeconds - 1e-6)) : 0;
+}
+
+uint64_t durationTicks(double seconds) {
+    if (!(seconds > 0.0)) return 1;
+    double ticks = std::ceil(seconds / Scheduler::kTickSeconds - 1e-6);
+    return std::max<uint64_t>(1, static_cast<uint64_t>(ticks));
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// Scheduler Implementation
+
+Scheduler::Scheduler() {
+    slots.fill(kNone);
+}
+
+void Scheduler::reset(double time) {
+    nodes.clear();
+    freeList = kNone;
+    slots.fill(kNone);
+    due.clear();
+    pendingCount = 0;
+    currentTick = clockTick(time);
+}
+
+void Scheduler::advance(double time) {
+    uint64_t target = clockTick(time);
+    if (target <= currentTick) return;
+
+    while (currentTick < target) {
+        if (pendingCount == 0) {
+            currentTick = target;
+            break;
+        }
+
+        // Slots are processed for tick t while the wheel still stands at
+        // t - 1, so timers cascading down for t land in the slot fired below
+        uint64_t tick = currentTick + 1;
+        int top = 0;
+        while (top < kLevels - 1 && (tick & ((uint64_t(1) << (kSlotBits * (top + 1))) - 1)) == 0) {
+            top++;
+        }
+        for (int level = top; level >= 1; --level) {
+            cascade(level);
+        }
+
+        currentTick = tick;
+        fireSlot(static_cast<uint32_t>(tick & (kSlots - 1)));
+    }
+}
+
+TimerId Scheduler::scheduleAfter(double delay, Callback callback, const void* owner) {
+    return schedule(currentTick + durationTicks(delay), 0, std::move(callback), owner);
+}
+
+TimerId Scheduler::scheduleAt(double time, Callback callback, const void* owner) {
+    return schedule(deadlineTick(time), 0, std::move(callback), owner);
+}
+
+TimerId Scheduler::scheduleEvery(double interval, Callback callback, const void* owner) {
+    uint64_t ticks = durationTicks(interval);
+    return schedule(currentTick + ticks, ticks, std::move(callback), owner);
+}
+
+bool Scheduler::cancel(TimerId id) {
+    const TimerNode* node = find(id);
+    if (!node) return false;
+
+    uint32_t index = static_cast<uint32_t>(id & 0xFFFFFFFFu);
+    if (node->state == NodeState::Queued) unlink(index);
+    freeNode(index);
+    return true;
+}
+
+void Scheduler::cancelOwner(const void* owner) {
+    if (!owner) return;
+    for (uint32_t index = 0; index < nodes.size(); ++index) {
+        TimerNode& node = nodes[index];
+        if (node.state == NodeState::Free || node.owner != owner) continue;
+        if (node.state == NodeState::Queued) unlink(index);
+        freeNode(index);
+    }
+}
+
+bool Scheduler::isPending(TimerId id) const {
+    return find(id) != nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Wheel internals
+
+TimerId Scheduler::schedule(uint64_t when, uint64_t interval, Callback callback, const void* owner) {
+    if (!callback) return kInvalidTimer;
+
+    uint32_t index = allocateNode();
+    TimerNode& node = nodes[index];
+    node.callback = std::move(callback);
+    node.owner = owner;
+    node.when = when;
+    node.interval = interval;
+    insert(index);
+    pendingCount++;
+    return (static_cast<TimerId>(node.generation) << 32) | index;
+}
+
+uint32_t Scheduler::allocateNode() {
+    if (freeList != kNone) {
+        uint32_t index = freeList;
+        freeList = nodes[index].next;
+        return index;
+    }
+    nodes.emplace_back();
+    return static_cast<uint32_t>(nodes.size() - 1);
+}
+
+void Scheduler::freeNode(uint32_t index) {
+    TimerNode& node = nodes[index];
+    node.callback = nullptr;
+    node.owner = nullptr;
+    node.state = NodeState::Free;
+    node.prev = kNone;
+    node.next = freeList;
+    if (++node.generation == 0) node.generation = 1;
+    freeList = index;
+    pendingCount--;
+}
+
+void Scheduler::insert(uint32_t index) {
+    TimerNode& node = nodes[index];
+
+    // Relative to the next tick to fire; due or overdue timers go into its slot
+    uint64_t base = currentTick + 1;
+    uint64_t target = std::max(node.when, base);
+    uint64_t delta = target - base;
+
+    int level = 0;
+    while (level < kLevels - 1 && delta >= (uint64_t(1) << (kSlotBits * (level + 1)))) {
+        level++;
+    }
+
+    // Beyond the outermost wheel: park in its farthest slot and re-sort on cascade
+    uint64_t range = uint64_t(1) << (kSlotBits * kLevels);
+    if (delta >= range) target = base + range - 1;
+
+    uint32_t slot = level * kSlots + static_cast<uint32_t>((target >> (kSlotBits * level)) & (kSlots - 1));
+    node.slot = static_cast<uint16_t>(slot);
+    node.state = NodeState::Queued;
+    node.prev = kNone;
+    node.next = slots[slot];
+    if (node.next != kNone) nodes[node.next].prev = index;
+    slots[slot] = index;
+}
+
+void Scheduler::unlink(uint32_t index) {
+    TimerNode& node = nodes[index];
+    if (node.prev != kNone) {
+        nodes[node.prev].next = node.next;
+    } else {
+        slots[node.slot] = node.next;
+    }
+    if (node.next != kNone) nodes[node.next].prev = node.prev;
+    node.prev = node.next = kNone;
+}
+
+void Scheduler::cascade(int level) {
+    uint32_t slot = level * kSlots +
+        static_cast<uint32_t>(((currentTick + 1) >> (kSlotBits * level)) & (kSlots - 1));
+    uint32_t index = slots[slot];
+    slots[slot] = kNone;
+    while (index != kNone) {
+        uint32_t next = nodes[index].next;
+        insert(index);
+        index = next;
+    }
+}
+
+void Scheduler::fireSlot(uint32_t slot) {
+    // Detach first: callbacks may schedule or cancel timers
+    due.clear();
+    for (uint32_t index = slots[slot]; index != kNone; index = nodes[index].next) {
+        nodes[index].state = NodeState::Firing;
+        due.push_back({ index, nodes[index].generation });
+    }
+    slots[slot] = kNone;
+
+    for (size_t i = 0; i < due.size(); ++i) {
+        uint32_t index = due[i].index;
+        uint32_t generation = due[i].generation;
+        TimerNode& node = nodes[index];
+        if (node.generation != generation || node.state != NodeState::Firing) continue;
+
+        Callback callback = std::move(node.callback);
+        if (node.interval > 0) {
+            node.when += node.interval;
+            insert(index);
+        } else {
+            freeNode(index);
+        }
+
+        metric_timersFired.add();
+        callback();
+
+        // Hand a repeating timer its callback back unless it was cancelled
+        // (the node may have been reused, and nodes may have moved)
+        TimerNode& after = nodes[index];
+        if (after.generation == generation && after.state == NodeState::Queued) {
+            after.callback = std::move(callback);
+        }
+    }
+}
+
+const Scheduler::TimerNode* Scheduler::find(TimerId id) const {
+    uint32_t index = static_cast<uint32_t>(id & 0xFFFFFFFFu);
+    uint32_t generation = static_cast<uint32_t>(id >> 32);
+    if (index >= nodes.size()) return nullptr;
+    const TimerNode& node = nodes[index];
+    if (node.state == NodeState::Free || node.generation != generation) return nullptr;
+    return &node;
+}
+
+} // namespace froggi
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace froggi {
+
+using TimerId = uint64_t;
+
+///////////////////////////////////////////////////////////////////////////////
+// Scheduler - Hierarchical timing wheel for delayed and repeating callbacks
+//
+// Time is quantized to 1 ms ticks. Four wheels of 256 slots cover 2^32 ticks
+// (~49 days); a timer sits in the wheel matching how far away it is and
+// cascades down as its time approaches. Scheduling and cancelling are O(1),
+// and advance() only touches the slots it passes, so the per-frame cost
+// follows the number of timers that fire rather than the number pending.
+// Each Engine owns one; callbacks run on the engine's thread at the start of
+// its frame.
+
+class Scheduler {
+public:
+    using Callback = std::function<void()>;
+
+    static constexpr TimerId kInvalidTimer = 0;
+    static constexpr double kTickSeconds = 0.001;
+
+    Scheduler();
+
+    /**
+     * Drop all timers and restart the clock at the given time
+     */
+    void reset(double now);
+
+    /**
+     * Run every timer due at or before now (never goes backwards)
+     */
+    void advance(double now);
+
+    /**
+     * @param owner Tag for cancelOwner(), e.g. the scene the timer belongs to
+     */
+    TimerId scheduleAfter(double delay, Callback callback, const void* owner = nullptr);
+    TimerId scheduleAt(double time, Callback callback, const void* owner = nullptr);
+
+    /**
+     * Repeat every interval (first call after one interval) until cancelled
+     */
+    TimerId scheduleEvery(double interval, Callback callback, const void* owner = nullptr);
+
+    /**
+     * @return false if the timer already fired (one-shot) or was cancelled
+     */
+    bool cancel(TimerId id);
+    void cancelOwner(const void* owner);
+
+    bool isPending(TimerId id) const;
+    size_t getPendingCount() const { return pendingCount; }
+    double now() const { return static_cast<double>(currentTick) * kTickSeconds; }
+
+private:
+    static constexpr int kLevels = 4;
+    static constexpr int kSlotBits = 8;
+    static constexpr uint32_t kSlots = 1u << kSlotBits;
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    enum class NodeState : uint8_t { Free, Queued, Firing };
+
+    struct TimerNode {
+        Callback callback;
+        const void* owner = nullptr;
+        uint64_t when = 0;          // tick
+        uint64_t interval = 0;      // ticks, 0 = one-shot
+        uint32_t generation = 1;
+        uint32_t prev = kNone;
+        uint32_t next = kNone;      // also links the free list
+        uint16_t slot = 0;          // level * kSlots + slot index
+        NodeState state = NodeState::Free;
+    };
+
+    struct Due {
+        uint32_t index;
+        uint32_t generation;
+    };
+
+    TimerId schedule(uint64_t when, uint64_t interval, Callback callback, const void* owner);
+    uint32_t allocateNode();
+    void freeNode(uint32_t index);
+    void insert(uint32_t index);
+    void unlink(uint32_t index);
+    void cascade(int level);
+    void fireSlot(uint32_t slot);
+    const TimerNode* find(TimerId id) const;
+
+    std::vector<TimerNode> nodes;
+    uint32_t freeList = kNone;
+    std::array<uint32_t, kLevels * kSlots> slots;
+    std::vector<Due> due;
+    uint64_t currentTick = 0;
+    size_t pendingCount = 0;
+};
+
+} // namespace froggi
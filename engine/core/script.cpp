@@ -0,0 +1,321 @@
+#ifdef FROGGI_COROUTINES
+
+#include "script.h"
+#include "pond_interface.h"
+#include "renderer.h"
+#include "resource_manager.h"
+#include "log.h"
+#include <algorithm>
+#include <exception>
+#include <new>
+
+namespace froggi {
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+// Frame pool storage
+
+constexpr size_t kSizeClasses = ScriptFramePool::kMaxPooledSize / ScriptFramePool::kGranularity;
+
+struct FreeFrame {
+    FreeFrame* next;
+};
+
+struct FramePoolLists {
+    FreeFrame* heads[kSizeClasses] = {};
+
+    ~FramePoolLists();
+};
+
+thread_local FramePoolLists t_framePool;
+thread_local bool t_framePoolAlive = true;
+
+FramePoolLists::~FramePoolLists() {
+    for (FreeFrame*& head : heads) {
+        while (head) {
+            FreeFrame* next = head->next;
+            ::operator delete(head);
+            head = next;
+        }
+    }
+    // Frames freed after this point (static teardown) go straight to the heap
+    t_framePoolAlive = false;
+}
+
+size_t sizeClass(size_t size) {
+    return (size + ScriptFramePool::kGranularity - 1) / ScriptFramePool::kGranularity - 1;
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// ScriptFramePool Implementation
+
+void* ScriptFramePool::allocate(size_t size) {
+    if (size > kMaxPooledSize || !t_framePoolAlive) return ::operator new(size);
+
+    size_t index = sizeClass(size);
+    FreeFrame*& head = t_framePool.heads[index];
+    if (head) {
+        FreeFrame* frame = head;
+        head = frame->next;
+        return frame;
+    }
+    return ::operator new((index + 1) * kGranularity);
+}
+
+void ScriptFramePool::deallocate(void* frame, size_t size) {
+    if (size > kMaxPooledSize || !t_framePoolAlive) {
+        ::operator delete(frame);
+        return;
+    }
+
+    FreeFrame*& head = t_framePool.heads[sizeClass(size)];
+    FreeFrame* node = static_cast<FreeFrame*>(frame);
+    node->next = head;
+    head = node;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Script Implementation
+
+void Script::promise_type::unhandled_exception() {
+    try {
+        throw;
+    } catch (const std::exception& e) {
+        FROGGI_LOG_ERROR(Game, "Script threw: %s", e.what());
+    } catch (...) {
+        FROGGI_LOG_ERROR(Game, "Script threw an unknown exception");
+    }
+}
+
+Script& Script::operator=(Script&& other) noexcept {
+    if (this != &other) {
+        Script dropped(handle);
+        handle = other.handle;
+        other.handle = nullptr;
+    }
+    return *this;
+}
+
+Script::~Script() {
+    if (!handle) return;
+
+    promise_type& promise = handle.promise();
+    if (promise.waiting != WaitKind::None && promise.scheduler) {
+        promise.scheduler->cancel(handle);
+    }
+    handle.destroy();
+}
+
+void Script::start() {
+    // Copy first: the script may start others that move this object
+    Handle h = handle;
+    if (h && !h.done()) h.resume();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Awaitables
+
+void ScriptWait::await_suspend(Script::Handle handle) {
+    Engine::getInstance().getScripts().waitTimer(handle, seconds, owner);
+}
+
+void ScriptNextFrame::await_suspend(Script::Handle handle) {
+    Engine::getInstance().getScripts().waitFrame(handle);
+}
+
+void ScriptNextFixedStep::await_suspend(Script::Handle handle) {
+    Engine::getInstance().getScripts().waitFixedStep(handle);
+}
+
+void ScriptLoad::await_suspend(Script::Handle h) {
+    handle = h;
+    Engine::getInstance().getScripts().waitLoad(h, name, path);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// ScriptScheduler Implementation
+
+struct ScriptScheduler::LoadJob {
+    std::string name;
+    std::string path;
+    std::vector<resource_manager::VertexAttributes> vertices;
+    std::vector<uint32_t> indices;
+    bool parsed = false;
+    Script::Handle waiter = nullptr;    // engine thread only; null once cancelled
+};
+
+ScriptScheduler::~ScriptScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(loadMutex);
+        loaderStop = true;
+    }
+    loadCondition.notify_all();
+    if (loaderThread.joinable()) loaderThread.join();
+}
+
+void ScriptScheduler::resumeFrame() {
+    // ═══════════════════════════════════════════════════════════════════════
+    // FINISHED LOADS (mesh creation must happen on the engine thread)
+    // ═══════════════════════════════════════════════════════════════════════
+    std::vector<std::shared_ptr<LoadJob>> finished;
+    {
+        std::lock_guard<std::mutex> lock(loadMutex);
+        finished.swap(finishedLoads);
+    }
+
+    for (const std::shared_ptr<LoadJob>& job : finished) {
+        activeLoads.erase(std::remove(activeLoads.begin(), activeLoads.end(), job), activeLoads.end());
+        if (!job->waiter) continue;
+
+        bool created = false;
+        Renderer* renderer = Engine::getInstance().getRenderer();
+        if (job->parsed && renderer) {
+            created = renderer->createMesh(job->name, job->vertices, job->indices);
+        }
+
+        Script::Handle waiter = job->waiter;
+        waiter.promise().waiting = Script::WaitKind::None;
+        waiter.promise().loadResult = created;
+        waiter.resume();
+    }
+
+    // ═══════════════════════════════════════════════════════════════════════
+    // NEXT-FRAME WAITERS
+    // ═══════════════════════════════════════════════════════════════════════
+    resumeList(frameWaiters, resumeScratch);
+}
+
+void ScriptScheduler::resumeFixedStep() {
+    resumeList(fixedWaiters, resumeScratch);
+}
+
+void ScriptScheduler::resumeList(std::vector<Script::Handle>& list, std::vector<Script::Handle>& scratch) {
+    if (list.empty()) return;
+
+    // Swap out first: resumed scripts that wait again land in the next round.
+    // cancel() nulls entries here if a script is destroyed mid-resume
+    scratch.clear();
+    scratch.swap(list);
+    for (size_t i = 0; i < scratch.size(); ++i) {
+        Script::Handle handle = scratch[i];
+        if (!handle) continue;
+        handle.promise().waiting = Script::WaitKind::None;
+        handle.resume();
+    }
+    scratch.clear();
+}
+
+void ScriptScheduler::waitTimer(Script::Handle handle, float seconds, const void* owner) {
+    Script::promise_type& promise = handle.promise();
+    promise.scheduler = this;
+    promise.waiting = Script::WaitKind::Timer;
+    promise.timer = timers.scheduleAfter(seconds, [handle]() {
+        handle.promise().waiting = Script::WaitKind::None;
+        handle.promise().timer = Scheduler::kInvalidTimer;
+        handle.resume();
+    }, owner);
+}
+
+void ScriptScheduler::waitFrame(Script::Handle handle) {
+    handle.promise().scheduler = this;
+    handle.promise().waiting = Script::WaitKind::Frame;
+    frameWaiters.push_back(handle);
+}
+
+void ScriptScheduler::waitFixedStep(Script::Handle handle) {
+    handle.promise().scheduler = this;
+    handle.promise().waiting = Script::WaitKind::FixedStep;
+    fixedWaiters.push_back(handle);
+}
+
+void ScriptScheduler::waitLoad(Script::Handle handle, const std::string& name, const std::string& path) {
+    Script::promise_type& promise = handle.promise();
+    promise.scheduler = this;
+    promise.loadResult = false;
+
+    // Nothing to upload to without a renderer: resume next frame with false
+    if (!Engine::getInstance().getRenderer()) {
+        waitFrame(handle);
+        return;
+    }
+
+    promise.waiting = Script::WaitKind::Load;
+    auto job = std::make_shared<LoadJob>();
+    job->name = name;
+    job->path = path;
+    job->waiter = handle;
+    activeLoads.push_back(job);
+
+    {
+        std::lock_guard<std::mutex> lock(loadMutex);
+        pendingLoads.push_back(job);
+        if (!loaderThread.joinable()) {
+            loaderThread = std::thread(&ScriptScheduler::loaderMain, this);
+        }
+    }
+    loadCondition.notify_one();
+}
+
+void ScriptScheduler::cancel(Script::Handle handle) {
+    Script::promise_type& promise = handle.promise();
+    switch (promise.waiting) {
+        case Script::WaitKind::Timer:
+            timers.cancel(promise.timer);
+            promise.timer = Scheduler::kInvalidTimer;
+            break;
+        case Script::WaitKind::Frame:
+            frameWaiters.erase(std::remove(frameWaiters.begin(), frameWaiters.end(), handle), frameWaiters.end());
+            std::replace(resumeScratch.begin(), resumeScratch.end(), handle, Script::Handle());
+            break;
+        case Script::WaitKind::FixedStep:
+            fixedWaiters.erase(std::remove(fixedWaiters.begin(), fixedWaiters.end(), handle), fixedWaiters.end());
+            std::replace(resumeScratch.begin(), resumeScratch.end(), handle, Script::Handle());
+            break;
+        case Script::WaitKind::Load:
+            // The parse still finishes; its result is dropped in resumeFrame
+            for (const std::shared_ptr<LoadJob>& job : activeLoads) {
+                if (job->waiter == handle) job->waiter = nullptr;
+            }
+            break;
+        case Script::WaitKind::None:
+            break;
+    }
+    promise.waiting = Script::WaitKind::None;
+}
+
+size_t ScriptScheduler::getWaitingCount() const {
+    size_t count = frameWaiters.size() + fixedWaiters.size();
+    for (const std::shared_ptr<LoadJob>& job : activeLoads) {
+        if (job->waiter) count++;
+    }
+    return count;
+}
+
+void ScriptScheduler::loaderMain() {
+    while (true) {
+        std::shared_ptr<LoadJob> job;
+        {
+            std::unique_lock<std::mutex> lock(loadMutex);
+            loadCondition.wait(lock, [this]() { return loaderStop || !pendingLoads.empty(); });
+            if (loaderStop) return;
+            job = std::move(pendingLoads.front());
+            pendingLoads.pop_front();
+        }
+
+        job->parsed = resource_manager::loadGeometryFromObj(job->path, job->vertices, job->indices) &&
+                      !job->indices.empty();
+        if (!job->parsed) {
+            FROGGI_LOG_WARN(Assets, "Script load of '%s' failed: %s", job->name.c_str(), job->path.c_str());
+        }
+
+        std::lock_guard<std::mutex> lock(loadMutex);
+        finishedLoads.push_back(std::move(job));
+    }
+}
+
+} // namespace froggi
+
+#endif // FROGGI_COROUTINES
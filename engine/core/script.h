@@ -0,0 +1,194 @@
+#pragma once
+
+// Coroutine scripts need C++20; build with -DFROGGI_COROUTINES=ON
+#ifdef FROGGI_COROUTINES
+
+#include "scheduler.h"
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace froggi {
+
+class ScriptScheduler;
+
+///////////////////////////////////////////////////////////////////////////////
+// ScriptFramePool - Size-class free lists for coroutine frames
+//
+// Frames are rounded up to 64-byte classes and recycled per thread, so
+// starting a script in steady state doesn't touch the heap. Frames larger
+// than kMaxPooledSize go to operator new.
+
+class ScriptFramePool {
+public:
+    static constexpr size_t kGranularity = 64;
+    static constexpr size_t kMaxPooledSize = 2048;
+
+    static void* allocate(size_t size);
+    static void deallocate(void* frame, size_t size);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Script - Coroutine owned by a Component
+//
+//     froggi::Script Door::openSequence() {
+//         co_await wait(0.5f);
+//         if (co_await loadAsync("door_open", "assets/models/door_open.obj")) {
+//             owner->getComponent<froggi::MeshComponent>()->setMesh("door_open");
+//         }
+//         co_await nextFixedStep();
+//     }
+//
+//     startScript(openSequence());
+//
+// A suspended script is parked in the engine's timer wheel or in a waiter
+// list and costs nothing until it is resumed. Scripts run on the engine's
+// thread; destroying a Script (or its component) cancels whatever it waits
+// for.
+
+class Script {
+public:
+    enum class WaitKind : uint8_t { None, Timer, Frame, FixedStep, Load };
+
+    struct promise_type {
+        ScriptScheduler* scheduler = nullptr;
+        WaitKind waiting = WaitKind::None;
+        TimerId timer = Scheduler::kInvalidTimer;
+        bool loadResult = false;
+
+        Script get_return_object() {
+            return Script(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception();
+
+        static void* operator new(size_t size) { return ScriptFramePool::allocate(size); }
+        static void operator delete(void* frame, size_t size) { ScriptFramePool::deallocate(frame, size); }
+    };
+
+    using Handle = std::coroutine_handle<promise_type>;
+
+    Script() = default;
+    explicit Script(Handle h) : handle(h) {}
+    Script(Script&& other) noexcept : handle(other.handle) { other.handle = nullptr; }
+    Script& operator=(Script&& other) noexcept;
+    Script(const Script&) = delete;
+    Script& operator=(const Script&) = delete;
+    ~Script();
+
+    bool valid() const { return static_cast<bool>(handle); }
+    bool done() const { return !handle || handle.done(); }
+
+    /**
+     * Run until the first co_await (Component::startScript does this)
+     */
+    void start();
+
+private:
+    Handle handle = nullptr;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Awaitables (returned by the Component script helpers)
+
+struct ScriptWait {
+    float seconds;
+    const void* owner;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(Script::Handle handle);
+    void await_resume() const noexcept {}
+};
+
+struct ScriptNextFrame {
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(Script::Handle handle);
+    void await_resume() const noexcept {}
+};
+
+struct ScriptNextFixedStep {
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(Script::Handle handle);
+    void await_resume() const noexcept {}
+};
+
+/**
+ * Parses the OBJ on the loader thread, then creates the mesh on the engine
+ * thread; resumes with false on failure or without a renderer (headless)
+ */
+struct ScriptLoad {
+    std::string name;
+    std::string path;
+    Script::Handle handle = nullptr;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(Script::Handle h);
+    bool await_resume() const noexcept { return handle.promise().loadResult; }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ScriptScheduler - Resumes waiting scripts (one per Engine)
+
+class ScriptScheduler {
+public:
+    explicit ScriptScheduler(Scheduler& timers) : timers(timers) {}
+    ~ScriptScheduler();
+
+    ScriptScheduler(const ScriptScheduler&) = delete;
+    ScriptScheduler& operator=(const ScriptScheduler&) = delete;
+
+    /**
+     * Resume scripts waiting for the next frame and finished loads
+     * (called by Engine at the start of each frame, after timers)
+     */
+    void resumeFrame();
+
+    /**
+     * Resume scripts waiting for the next fixed step (called by Engine at
+     * the start of each fixed step)
+     */
+    void resumeFixedStep();
+
+    // Used by the awaitables and by Script's destructor
+    void waitTimer(Script::Handle handle, float seconds, const void* owner);
+    void waitFrame(Script::Handle handle);
+    void waitFixedStep(Script::Handle handle);
+    void waitLoad(Script::Handle handle, const std::string& name, const std::string& path);
+    void cancel(Script::Handle handle);
+
+    // Frame, fixed-step and load waiters (timer waits live in the Scheduler)
+    size_t getWaitingCount() const;
+
+private:
+    struct LoadJob;
+
+    void loaderMain();
+    void resumeList(std::vector<Script::Handle>& list, std::vector<Script::Handle>& scratch);
+
+    Scheduler& timers;
+    std::vector<Script::Handle> frameWaiters;
+    std::vector<Script::Handle> fixedWaiters;
+    std::vector<Script::Handle> resumeScratch;
+
+    // Loader thread (started on the first load)
+    std::thread loaderThread;
+    mutable std::mutex loadMutex;
+    std::condition_variable loadCondition;
+    std::deque<std::shared_ptr<LoadJob>> pendingLoads;
+    std::vector<std::shared_ptr<LoadJob>> finishedLoads;
+    std::vector<std::shared_ptr<LoadJob>> activeLoads;      // engine thread only
+    bool loaderStop = false;
+};
+
+} // namespace froggi
+
+#endif // FROGGI_COROUTINES
@@ -0,0 +1,137 @@
+#include "task_queue.h"
+#include "cvar.h"
+#include "metrics.h"
+#include <algorithm>
+
+namespace froggi {
+
+static AutoCVarInt cv_taskAgeFrames("tasks.ageFrames",
+    "Frames a queued task waits before moving up one priority (0 = never)", 30, 0, 10000);
+
+static MetricCounter metric_tasksCompleted("tasks.completed");
+static MetricCounter metric_taskSlices("tasks.slices");
+
+///////////////////////////////////////////////////////////////////////////////
+// TaskQueue Implementation
+
+TaskId TaskQueue::submit(Task task, TaskPriority priority, const void* owner) {
+    if (!task) return kInvalidTask;
+
+    size_t level = std::min(static_cast<size_t>(priority), kLevels - 1);
+    TaskId id = nextId++;
+    queues[level].push_back({ id, std::move(task), owner, frame });
+    return id;
+}
+
+bool TaskQueue::cancel(TaskId id) {
+    if (id == kInvalidTask) return false;
+    if (id == runningId) {
+        runningCancelled = true;
+        return true;
+    }
+    for (auto& queue : queues) {
+        auto it = std::find_if(queue.begin(), queue.end(), [id](const Entry& e) { return e.id == id; });
+        if (it != queue.end()) {
+            queue.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskQueue::cancelOwner(const void* owner) {
+    if (!owner) return;
+    for (auto& queue : queues) {
+        queue.erase(std::remove_if(queue.begin(), queue.end(),
+                                   [owner](const Entry& e) { return e.owner == owner; }),
+                    queue.end());
+    }
+    // A running task of this owner finishes its slice but is not resumed
+    if (runningId != kInvalidTask && runningOwner == owner) runningCancelled = true;
+}
+
+void TaskQueue::clear() {
+    for (auto& queue : queues) queue.clear();
+    runningCancelled = runningId != kInvalidTask;
+}
+
+void TaskQueue::process(float budgetMs) {
+    using Clock = std::chrono::steady_clock;
+
+    frame++;
+    promoteAged(static_cast<uint32_t>(cv_taskAgeFrames.get()));
+
+    TaskQueueStats stats;
+    Clock::time_point start = Clock::now();
+    deadline = start + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<float, std::milli>(std::max(0.0f, budgetMs)));
+    processing = true;
+
+    while (true) {
+        auto queue = std::find_if(std::begin(queues), std::end(queues),
+                                  [](const std::deque<Entry>& q) { return !q.empty(); });
+        if (queue == std::end(queues)) break;
+
+        // Always make some progress, even when the budget is tiny
+        if (stats.slicesRun > 0 && Clock::now() >= deadline) break;
+
+        Entry entry = std::move(queue->front());
+        queue->pop_front();
+
+        runningId = entry.id;
+        runningOwner = entry.owner;
+        runningCancelled = false;
+        TaskResult result = entry.task();
+        runningId = kInvalidTask;
+        stats.slicesRun++;
+
+        if (result == TaskResult::Done) {
+            stats.completed++;
+        } else if (!runningCancelled) {
+            // Round-robin: back of its priority
+            entry.queuedFrame = frame;
+            queue->push_back(std::move(entry));
+        }
+    }
+
+    processing = false;
+    stats.usedMs = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+    stats.backlog = static_cast<uint32_t>(getBacklog());
+    for (const auto& queue : queues) {
+        if (!queue.empty()) {
+            stats.oldestWaitFrames = std::max(stats.oldestWaitFrames,
+                                              static_cast<uint32_t>(frame - queue.front().queuedFrame));
+        }
+    }
+    lastStats = stats;
+
+    metric_taskSlices.add(stats.slicesRun);
+    metric_tasksCompleted.add(stats.completed);
+}
+
+bool TaskQueue::shouldYield() const {
+    return processing && std::chrono::steady_clock::now() >= deadline;
+}
+
+size_t TaskQueue::getBacklog() const {
+    size_t count = 0;
+    for (const auto& queue : queues) count += queue.size();
+    return count;
+}
+
+void TaskQueue::promoteAged(uint32_t ageFrames) {
+    if (ageFrames == 0) return;
+
+    // Queues are ordered by queuedFrame, so only the fronts need checking
+    for (size_t level = 1; level < kLevels; ++level) {
+        std::deque<Entry>& queue = queues[level];
+        while (!queue.empty() && frame - queue.front().queuedFrame > ageFrames) {
+            Entry entry = std::move(queue.front());
+            queue.pop_front();
+            entry.queuedFrame = frame;
+            queues[level - 1].push_back(std::move(entry));
+        }
+    }
+}
+
+} // namespace froggi
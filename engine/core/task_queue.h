@@ -0,0 +1,102 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+
+namespace froggi {
+
+using TaskId = uint64_t;
+
+enum class TaskPriority : uint8_t {
+    High = 0,
+    Normal,
+    Low,
+    Count
+};
+
+/**
+ * Returned by a task slice: Done removes the task, Yield resumes it in a
+ * later slice (next frame if the budget is used up)
+ */
+enum class TaskResult : uint8_t {
+    Done,
+    Yield
+};
+
+struct TaskQueueStats {
+    uint32_t slicesRun = 0;     // task invocations in the last process()
+    uint32_t completed = 0;     // tasks that returned Done
+    uint32_t backlog = 0;       // tasks still queued afterwards
+    float usedMs = 0.0f;
+    uint32_t oldestWaitFrames = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// TaskQueue - Frame-budgeted, resumable work
+//
+// Work that may take several frames (path requests, AI re-planning, LOD
+// selection, asset post-processing) is split into tasks that do a bounded
+// amount per call and return Yield until they finish. Each frame the engine
+// calls process() with a millisecond budget; slices run highest priority
+// first, round-robin within a priority, until the budget is used. Tasks
+// check shouldYield() to stop early inside a slice. At least one slice runs
+// per frame so a tight budget still makes progress, and tasks waiting
+// longer than tasks.ageFrames move up a priority so Low work is never
+// starved by a steady stream of High requests.
+//
+// Each Engine owns one; tasks run on the engine's thread.
+
+class TaskQueue {
+public:
+    using Task = std::function<TaskResult()>;
+
+    static constexpr TaskId kInvalidTask = 0;
+
+    /**
+     * @param owner Tag for cancelOwner(), e.g. the scene the task belongs to
+     */
+    TaskId submit(Task task, TaskPriority priority = TaskPriority::Normal, const void* owner = nullptr);
+    bool cancel(TaskId id);
+    void cancelOwner(const void* owner);
+    void clear();
+
+    /**
+     * Run slices until budgetMs has elapsed (called by Engine once per frame)
+     */
+    void process(float budgetMs);
+
+    /**
+     * For use inside a task: true once the current budget is spent
+     */
+    bool shouldYield() const;
+
+    size_t getBacklog() const;
+    const TaskQueueStats& getLastStats() const { return lastStats; }
+
+private:
+    struct Entry {
+        TaskId id;
+        Task task;
+        const void* owner;
+        uint64_t queuedFrame;
+    };
+
+    static constexpr size_t kLevels = static_cast<size_t>(TaskPriority::Count);
+
+    void promoteAged(uint32_t ageFrames);
+
+    std::deque<Entry> queues[kLevels];
+    TaskId nextId = 1;
+    TaskId runningId = kInvalidTask;
+    const void* runningOwner = nullptr;
+    bool runningCancelled = false;
+    uint64_t frame = 0;
+    std::chrono::steady_clock::time_point deadline;
+    bool processing = false;
+    TaskQueueStats lastStats;
+};
+
+} // namespace froggi
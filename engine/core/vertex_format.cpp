@@ -0,0 +1,241 @@
+#include "vertex_format.h"
+#include <glm/gtc/packing.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace froggi {
+
+using VertexAttributes = resource_manager::VertexAttributes;
+
+namespace {
+
+constexpr uint32_t kAbsent = UINT32_MAX;
+
+// Byte offsets of the attributes that are stored separately; quantized
+// layouts without a normal offset pack it into the 4th position component
+struct LayoutInfo {
+    const char* name;
+    uint32_t stride;
+    bool quantized;
+    uint32_t normalOffset;
+    uint32_t colorOffset;
+    uint32_t uvOffset;
+};
+
+const LayoutInfo kLayouts[kVertexLayoutCount] = {
+    { "float", sizeof(VertexAttributes), false, offsetof(VertexAttributes, normal),
+      offsetof(VertexAttributes, color), offsetof(VertexAttributes, uv) },
+    { "compact", 12, true, kAbsent, kAbsent, 8 },
+    { "compactColor", 16, true, kAbsent, 12, 8 },
+    { "precise", 16, true, 8, kAbsent, 12 },
+    { "preciseColor", 20, true, 8, 16, 12 },
+};
+
+const LayoutInfo& info(VertexLayout layout) {
+    return kLayouts[static_cast<size_t>(layout)];
+}
+
+uint16_t quantizeUnorm16(float value) {
+    return static_cast<uint16_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+}
+
+int16_t quantizeSnorm16(float value) {
+    return static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+// 8-bit octahedral components as 0..254 with 127 = 0, so axis-aligned
+// normals survive exactly
+uint16_t packOct8(const glm::vec2& encoded) {
+    auto component = [](float value) {
+        return static_cast<uint16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 127.0f) + 127);
+    };
+    return static_cast<uint16_t>(component(encoded.x) | (component(encoded.y) << 8));
+}
+
+// Shared by every layout's shader source; must mirror octDecode() and
+// packOct8() above
+const char* kDecodeFunctions = R"(
+struct MeshVertex {
+    position: vec3f,
+    normal: vec3f,
+    color: vec3f,
+    uv: vec2f,
+};
+
+fn octDecode(e: vec2f) -> vec3f {
+    var n = vec3f(e, 1.0 - abs(e.x) - abs(e.y));
+    let t = max(-n.z, 0.0);
+    n.x += select(t, -t, n.x >= 0.0);
+    n.y += select(t, -t, n.y >= 0.0);
+    return normalize(n);
+}
+
+fn unpackOct8(w: f32) -> vec2f {
+    let bits = u32(round(w * 65535.0));
+    return (vec2f(f32(bits & 0xffu), f32(bits >> 8u)) - 127.0) / 127.0;
+}
+)";
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// Layouts
+
+uint32_t vertexStride(VertexLayout layout) {
+    return info(layout).stride;
+}
+
+const char* vertexLayoutName(VertexLayout layout) {
+    return info(layout).name;
+}
+
+VertexLayout chooseVertexLayout(const std::vector<VertexAttributes>& vertices, VertexLayout base) {
+    if (base != VertexLayout::Compact && base != VertexLayout::Precise) return VertexLayout::Float;
+
+    bool colored = std::any_of(vertices.begin(), vertices.end(), [](const VertexAttributes& vertex) {
+        return glm::any(glm::lessThan(vertex.color, glm::vec3(1.0f)));
+    });
+    if (!colored) return base;
+    return base == VertexLayout::Compact ? VertexLayout::CompactColor : VertexLayout::PreciseColor;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Encoding
+
+glm::vec2 octEncode(const glm::vec3& normal) {
+    float sum = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+    if (sum == 0.0f) return glm::vec2(0.0f);
+
+    glm::vec2 p = glm::vec2(normal) / sum;
+    if (normal.z < 0.0f) {
+        // Lower hemisphere folds over the diagonals
+        p = glm::vec2((1.0f - std::abs(p.y)) * (p.x >= 0.0f ? 1.0f : -1.0f),
+                      (1.0f - std::abs(p.x)) * (p.y >= 0.0f ? 1.0f : -1.0f));
+    }
+    return p;
+}
+
+glm::vec3 octDecode(const glm::vec2& encoded) {
+    glm::vec3 n(encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y));
+    float t = std::max(-n.z, 0.0f);
+    n.x += n.x >= 0.0f ? -t : t;
+    n.y += n.y >= 0.0f ? -t : t;
+    return glm::normalize(n);
+}
+
+glm::mat4 packVertices(VertexLayout layout, const std::vector<VertexAttributes>& vertices,
+                       std::vector<uint8_t>& packed) {
+    const LayoutInfo& format = info(layout);
+    packed.resize(vertices.size() * format.stride);
+    if (!format.quantized) {
+        if (!vertices.empty()) std::memcpy(packed.data(), vertices.data(), packed.size());
+        return glm::mat4(1.0f);
+    }
+
+    // One step size for all axes: the dequantization is then a uniform
+    // scale, which leaves normals transformed by the model matrix intact
+    glm::vec3 boundsMin(0.0f);
+    glm::vec3 boundsMax(0.0f);
+    if (!vertices.empty()) {
+        boundsMin = boundsMax = vertices[0].position;
+        for (const VertexAttributes& vertex : vertices) {
+            boundsMin = glm::min(boundsMin, vertex.position);
+            boundsMax = glm::max(boundsMax, vertex.position);
+        }
+    }
+    glm::vec3 size = boundsMax - boundsMin;
+    float extent = std::max(size.x, std::max(size.y, size.z));
+    if (extent <= 0.0f) extent = 1.0f;
+
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        const VertexAttributes& vertex = vertices[i];
+        uint8_t* out = packed.data() + i * format.stride;
+
+        glm::vec3 local = (vertex.position - boundsMin) / extent;
+        glm::vec2 oct = octEncode(vertex.normal);
+        uint16_t position[4] = { quantizeUnorm16(local.x), quantizeUnorm16(local.y), quantizeUnorm16(local.z), 0 };
+        if (format.normalOffset == kAbsent) {
+            position[3] = packOct8(oct);
+        } else {
+            int16_t normal[2] = { quantizeSnorm16(oct.x), quantizeSnorm16(oct.y) };
+            std::memcpy(out + format.normalOffset, normal, sizeof(normal));
+        }
+        std::memcpy(out, position, sizeof(position));
+
+        uint32_t uv = glm::packHalf2x16(vertex.uv);
+        std::memcpy(out + format.uvOffset, &uv, sizeof(uv));
+
+        if (format.colorOffset != kAbsent) {
+            glm::vec4 color(glm::clamp(vertex.color, 0.0f, 1.0f), 1.0f);
+            uint32_t rgba = glm::packUnorm4x8(color);
+            std::memcpy(out + format.colorOffset, &rgba, sizeof(rgba));
+        }
+    }
+
+    glm::mat4 dequantize(extent);
+    dequantize[3] = glm::vec4(boundsMin, 1.0f);
+    return dequantize;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// GPU Description
+
+wgpu::VertexBufferLayout describeVertexLayout(VertexLayout layout, std::vector<wgpu::VertexAttribute>& attributes) {
+    const LayoutInfo& format = info(layout);
+    attributes.clear();
+
+    auto add = [&attributes](uint32_t location, wgpu::VertexFormat vertexFormat, uint32_t offset) {
+        wgpu::VertexAttribute attribute;
+        attribute.shaderLocation = location;
+        attribute.format = vertexFormat;
+        attribute.offset = offset;
+        attributes.push_back(attribute);
+    };
+
+    add(0, format.quantized ? wgpu::VertexFormat::Unorm16x4 : wgpu::VertexFormat::Float32x3, 0);
+    if (format.normalOffset != kAbsent) {
+        add(1, format.quantized ? wgpu::VertexFormat::Snorm16x2 : wgpu::VertexFormat::Float32x3, format.normalOffset);
+    }
+    if (format.colorOffset != kAbsent) {
+        add(2, format.quantized ? wgpu::VertexFormat::Unorm8x4 : wgpu::VertexFormat::Float32x3, format.colorOffset);
+    }
+    add(3, format.quantized ? wgpu::VertexFormat::Float16x2 : wgpu::VertexFormat::Float32x2, format.uvOffset);
+
+    wgpu::VertexBufferLayout bufferLayout;
+    bufferLayout.attributeCount = static_cast<uint32_t>(attributes.size());
+    bufferLayout.attributes = attributes.data();
+    bufferLayout.arrayStride = format.stride;
+    bufferLayout.stepMode = wgpu::VertexStepMode::Vertex;
+    return bufferLayout;
+}
+
+std::string vertexLayoutWgsl(VertexLayout layout) {
+    const LayoutInfo& format = info(layout);
+    bool packedNormal = format.normalOffset == kAbsent;
+    bool hasColor = format.colorOffset != kAbsent;
+
+    std::string source = "struct VertexInput {\n";
+    source += format.quantized ? "    @location(0) position: vec4f,\n" : "    @location(0) position: vec3f,\n";
+    if (!packedNormal) source += format.quantized ? "    @location(1) normal: vec2f,\n" : "    @location(1) normal: vec3f,\n";
+    if (hasColor) source += format.quantized ? "    @location(2) color: vec4f,\n" : "    @location(2) color: vec3f,\n";
+    source += "    @location(3) uv: vec2f,\n};\n";
+    source += kDecodeFunctions;
+
+    source += "\nfn decodeVertex(in: VertexInput) -> MeshVertex {\n";
+    source += "    var v: MeshVertex;\n";
+    source += "    v.position = in.position.xyz;\n";
+    if (!format.quantized) {
+        source += "    v.normal = in.normal;\n";
+    } else if (packedNormal) {
+        source += "    v.normal = octDecode(unpackOct8(in.position.w));\n";
+    } else {
+        source += "    v.normal = octDecode(in.normal);\n";
+    }
+    source += hasColor ? "    v.color = in.color.rgb;\n" : "    v.color = vec3f(1.0);\n";
+    source += "    v.uv = in.uv;\n";
+    source += "    return v;\n}\n\n";
+    return source;
+}
+
+} // namespace froggi
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "resource_manager.h"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace froggi {
+
+///////////////////////////////////////////////////////////////////////////////
+// Vertex Formats - GPU encodings of resource_manager::VertexAttributes
+//
+// Loaders produce full float vertices, which the CPU keeps using (bounds,
+// occluder triangles); the renderer packs them into one of these layouts
+// when uploading a mesh. The compact layouts store:
+//
+//   position  unorm16 x3 inside the cube around the mesh bounds; the
+//             renderer folds the dequantization into the model matrix
+//   normal    octahedral, 2 x 8 bits (in the spare 4th position component)
+//             or snorm16 x2
+//   uv        float16 x2
+//   color     unorm8 x4, only for meshes whose vertex colors aren't all white
+//
+//   Float           44 bytes
+//   Compact         12 bytes    CompactColor  16 bytes
+//   Precise         16 bytes    PreciseColor  20 bytes
+//
+// Every layout has its own shader variant: vertexLayoutWgsl() declares the
+// matching VertexInput and a decodeVertex() the shaders call.
+
+enum class VertexLayout : uint8_t {
+    Float = 0,
+    Compact,
+    CompactColor,
+    Precise,
+    PreciseColor,
+    Count
+};
+
+constexpr size_t kVertexLayoutCount = static_cast<size_t>(VertexLayout::Count);
+
+/**
+ * Bytes per vertex
+ */
+uint32_t vertexStride(VertexLayout layout);
+const char* vertexLayoutName(VertexLayout layout);
+
+/**
+ * Layout for a mesh: base is Float, Compact or Precise, and the color
+ * variant of it is picked when some vertex isn't white
+ */
+VertexLayout chooseVertexLayout(const std::vector<resource_manager::VertexAttributes>& vertices, VertexLayout base);
+
+/**
+ * Encode vertices for the GPU
+ * @param packed Receives vertices.size() * vertexStride(layout) bytes
+ * @return Matrix taking decoded positions back to mesh space (identity for Float)
+ */
+glm::mat4 packVertices(VertexLayout layout, const std::vector<resource_manager::VertexAttributes>& vertices,
+                       std::vector<uint8_t>& packed);
+
+/**
+ * Octahedral mapping of a unit vector onto [-1, 1]^2 and back
+ */
+glm::vec2 octEncode(const glm::vec3& normal);
+glm::vec3 octDecode(const glm::vec2& encoded);
+
+/**
+ * Vertex buffer layout for a pipeline
+ * @param attributes Storage for the attributes the returned layout points to
+ */
+wgpu::VertexBufferLayout describeVertexLayout(VertexLayout layout, std::vector<wgpu::VertexAttribute>& attributes);
+
+/**
+ * WGSL declaring VertexInput, Vertex and decodeVertex(), prepended to the
+ * mesh shaders
+ */
+std::string vertexLayoutWgsl(VertexLayout layout);
+
+} // namespace froggi
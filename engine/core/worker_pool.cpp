@@ -0,0 +1,77 @@
+#include "worker_pool.h"
+#include <algorithm>
+
+namespace froggi {
+
+WorkerPool::WorkerPool(uint32_t threadCount) {
+    threads.reserve(threadCount);
+    for (uint32_t i = 0; i < threadCount; ++i) {
+        threads.emplace_back(&WorkerPool::workerLoop, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& thread : threads) thread.join();
+}
+
+void WorkerPool::run(uint32_t count, const std::function<void(uint32_t)>& fn) {
+    if (count == 0) return;
+    if (count == 1 || threads.empty()) {
+        for (uint32_t i = 0; i < count; ++i) fn(i);
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        // A worker that woke late for the previous batch may still hold it
+        idle.wait(lock, [this] { return busy == 0; });
+        job = &fn;
+        jobCount = count;
+        nextJob.store(0, std::memory_order_relaxed);
+        generation++;
+    }
+    wake.notify_all();
+
+    for (uint32_t i; (i = nextJob.fetch_add(1, std::memory_order_relaxed)) < count;) {
+        fn(i);
+    }
+
+    // Every job is claimed; wait for the ones still running elsewhere
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return busy == 0; });
+    job = nullptr;
+}
+
+uint32_t WorkerPool::hardwareThreads() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void WorkerPool::workerLoop() {
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [&] { return stopping || generation != seen; });
+        if (stopping) return;
+        seen = generation;
+        if (!job) continue;
+
+        const std::function<void(uint32_t)>& fn = *job;
+        uint32_t count = jobCount;
+        busy++;
+        lock.unlock();
+
+        for (uint32_t i; (i = nextJob.fetch_add(1, std::memory_order_relaxed)) < count;) {
+            fn(i);
+        }
+
+        lock.lock();
+        if (--busy == 0) idle.notify_all();
+    }
+}
+
+} // namespace froggi
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace froggi {
+
+///////////////////////////////////////////////////////////////////////////////
+// WorkerPool - Persistent threads for data-parallel frame work
+//
+// The threads are started once and sleep until run() hands them a batch of
+// jobs, so splitting per-frame work (culling, occlusion rasterization)
+// costs a wake-up instead of a thread spawn and join. The calling thread
+// takes jobs too and run() returns once all of them are done. One run() at
+// a time; a pool without threads runs every job on the caller.
+
+class WorkerPool {
+public:
+    /**
+     * @param threads Background threads (the caller is one more worker)
+     */
+    explicit WorkerPool(uint32_t threads);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /**
+     * Threads that work on a run(), the caller included
+     */
+    uint32_t getWorkerCount() const { return static_cast<uint32_t>(threads.size()) + 1; }
+
+    /**
+     * Call job(0) .. job(count - 1) across the pool and wait for all of them
+     */
+    void run(uint32_t count, const std::function<void(uint32_t)>& job);
+
+    /**
+     * Hardware threads, at least 1
+     */
+    static uint32_t hardwareThreads();
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+
+    // Current batch; only replaced while no worker is busy with it
+    const std::function<void(uint32_t)>* job = nullptr;
+    uint32_t jobCount = 0;
+    std::atomic<uint32_t> nextJob{ 0 };
+    uint64_t generation = 0;
+    uint32_t busy = 0;
+    bool stopping = false;
+};
+
+} // namespace froggi
@@ -8,8 +8,16 @@ struct VertexOutput {
     @location(0) uv: vec2f,
 };
 
+struct OutlineParams {
+    width: f32,             // sample radius in silhouette pixels (r.outlineWidth)
+    samples: i32,           // neighbours tested per pixel (r.outlineSamples)
+    depthThreshold: f32,    // r.outlineDepthThreshold
+    _padding: f32,
+};
+
 @group(0) @binding(0) var silhouetteTexture: texture_2d<f32>;
 @group(0) @binding(1) var silhouetteSampler: sampler;
+@group(0) @binding(2) var<uniform> params: OutlineParams;
 
 @vertex
 fn vs_main(@builtin(vertex_index) vertexIndex: u32) -> VertexOutput {
@@ -38,22 +46,24 @@ fn vs_main(@builtin(vertex_index) vertexIndex: u32) -> VertexOutput {
 }
 @fragment
 fn fs_main(in: VertexOutput) -> @location(0) vec4f {
-    let texSize = vec2f(1280.0, 720.0);
+    // Follows the render target size (r.width / r.height)
+    let texSize = vec2f(textureDimensions(silhouetteTexture));
     let pixelSize = 1.0 / texSize;
     
-    let center = textureSample(silhouetteTexture, silhouetteSampler, in.uv);
+    let center = textureSampleLevel(silhouetteTexture, silhouetteSampler, in.uv, 0.0);
     let centerHasObject = center.g;
     let centerDepth = center.b;
     
-    let outlineWidth = 0.7;
-    let depthThreshold = 0.003;
+    let outlineWidth = params.width;
+    let depthThreshold = params.depthThreshold;
     var isEdge = false;
-    let samples = 8;
+    let samples = params.samples;
     
+    // textureSampleLevel: the loop exits early on non-uniform data
     for (var i = 0; i < samples; i = i + 1) {
         let angle = f32(i) * 6.28318 / f32(samples);
         let offset = vec2f(cos(angle), sin(angle)) * pixelSize * outlineWidth;
-        let neighbor = textureSample(silhouetteTexture, silhouetteSampler, in.uv + offset);
+        let neighbor = textureSampleLevel(silhouetteTexture, silhouetteSampler, in.uv + offset, 0.0);
         let neighborHasObject = neighbor.g;
         let neighborDepth = neighbor.b;
         
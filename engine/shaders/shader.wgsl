@@ -1,48 +1,54 @@
-struct VertexInput {
-    @location(0) position: vec3f,
-    @location(1) normal: vec3f,
-    @location(2) color: vec3f,
-    @location(3) uv: vec2f,
-};
+// VertexInput and decodeVertex() are prepended for the mesh's vertex layout
+// (vertexLayoutWgsl() in core/vertex_format.cpp)
 
 struct VertexOutput {
     @builtin(position) position: vec4f,
     @location(0) color: vec3f,
     @location(1) normal: vec3f,
     @location(2) uv: vec2f,
+    @location(3) @interpolate(flat) alpha: f32,
 };
 
-struct MyUniforms {
+struct FrameUniforms {
     projectionMatrix: mat4x4f,
     viewMatrix: mat4x4f,
+    viewProjectionMatrix: mat4x4f,
+    time: f32,
+};
+
+struct InstanceData {
     modelMatrix: mat4x4f,
     color: vec4f,
-    time: f32,
+    objectId: f32,
 };
 
-@group(0) @binding(0) var<uniform> uMyUniforms: MyUniforms;
+@group(0) @binding(0) var<uniform> uFrame: FrameUniforms;
 @group(0) @binding(1) var gradientTexture: texture_2d<f32>;
 @group(0) @binding(2) var textureSampler: sampler;
+@group(0) @binding(3) var<storage, read> instances: array<InstanceData>;
 
 @vertex
-fn vs_main(in: VertexInput) -> VertexOutput {
+fn vs_main(in: VertexInput, @builtin(instance_index) instanceIndex: u32) -> VertexOutput {
     var out: VertexOutput;
+    let instanceData = instances[instanceIndex];
+    let meshVertex = decodeVertex(in);
     
     // Apply model transform to vertex
-    var worldPos: vec3f = (uMyUniforms.modelMatrix * vec4f(in.position, 1.0)).xyz;
+    var worldPos: vec3f = (instanceData.modelMatrix * vec4f(meshVertex.position, 1.0)).xyz;
     
     // Transform normal to world space
-    var worldNormal: vec3f = normalize((uMyUniforms.modelMatrix * vec4f(in.normal, 0.0)).xyz);
+    var worldNormal: vec3f = normalize((instanceData.modelMatrix * vec4f(meshVertex.normal, 0.0)).xyz);
     
     // Transform to clip space
-    out.position = uMyUniforms.projectionMatrix * uMyUniforms.viewMatrix * vec4f(worldPos, 1.0);
+    out.position = uFrame.viewProjectionMatrix * vec4f(worldPos, 1.0);
     
     // Output normal
     out.normal = worldNormal;
     
     // Pass-through
-    out.color = in.color;
-    out.uv = in.uv;
+    out.color = meshVertex.color;
+    out.uv = meshVertex.uv;
+    out.alpha = instanceData.color.a;
     
     return out;
 }
@@ -55,8 +61,8 @@ fn fs_main(in: VertexOutput) -> @location(0) vec4f {
     // Gamma correction (if desired)
     let corrected_rgb: vec3f = pow(texColor.rgb, vec3f(2.0));
     
-    // Combine texture alpha with uniform alpha for fading control
-    let final_alpha: f32 = texColor.a * uMyUniforms.color.a;
+    // Combine texture alpha with instance alpha for fading control
+    let final_alpha: f32 = texColor.a * in.alpha;
     
     // Return final color
     return vec4f(corrected_rgb, final_alpha);
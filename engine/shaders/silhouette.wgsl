@@ -4,41 +4,47 @@
 
 const WORLD_PIXEL_SIZE: f32 = 0.0001;
 
-struct VertexInput {
-    @location(0) position: vec3f,
-    @location(1) normal: vec3f,
-    @location(2) color: vec3f,
-    @location(3) uv: vec2f,
-};
+// VertexInput and decodeVertex() are prepended for the mesh's vertex layout
+// (vertexLayoutWgsl() in core/vertex_format.cpp)
 
 struct VertexOutput {
     @builtin(position) position: vec4f,
+    @location(0) @interpolate(flat) objectId: f32,
 };
 
-struct MyUniforms {
+struct FrameUniforms {
     projectionMatrix: mat4x4f,
     viewMatrix: mat4x4f,
+    viewProjectionMatrix: mat4x4f,
+    time: f32,
+};
+
+struct InstanceData {
     modelMatrix: mat4x4f,
     color: vec4f,
-    time: f32,
+    objectId: f32,
 };
 
-@group(0) @binding(0) var<uniform> uMyUniforms: MyUniforms;
+@group(0) @binding(0) var<uniform> uFrame: FrameUniforms;
 @group(0) @binding(1) var gradientTexture: texture_2d<f32>;
 @group(0) @binding(2) var textureSampler: sampler;
+@group(0) @binding(3) var<storage, read> instances: array<InstanceData>;
 
 @vertex
-fn vs_main(in: VertexInput) -> VertexOutput {
+fn vs_main(in: VertexInput, @builtin(instance_index) instanceIndex: u32) -> VertexOutput {
     var out: VertexOutput;
+    let instanceData = instances[instanceIndex];
+    let meshVertex = decodeVertex(in);
     
     // Same snapping logic as main shader for consistency
-    var modelTranslation: vec3f = uMyUniforms.modelMatrix[3].xyz;
+    var modelTranslation: vec3f = instanceData.modelMatrix[3].xyz;
     modelTranslation = round(modelTranslation / WORLD_PIXEL_SIZE) * WORLD_PIXEL_SIZE;
     
-    var worldPos: vec3f = (uMyUniforms.modelMatrix * vec4f(in.position, 1.0)).xyz;
+    var worldPos: vec3f = (instanceData.modelMatrix * vec4f(meshVertex.position, 1.0)).xyz;
     worldPos = round(worldPos / WORLD_PIXEL_SIZE) * WORLD_PIXEL_SIZE;
     
-    out.position = uMyUniforms.projectionMatrix * uMyUniforms.viewMatrix * vec4f(worldPos, 1.0);
+    out.position = uFrame.viewProjectionMatrix * vec4f(worldPos, 1.0);
+    out.objectId = instanceData.objectId;
     
     return out;
 }
@@ -46,9 +52,9 @@ fn vs_main(in: VertexInput) -> VertexOutput {
 @fragment
 fn fs_main(in: VertexOutput) -> @location(0) vec4f {
     // Pack data into RGBA channels:
-    // R: Object ID (from uniform color.r)
+    // R: Object ID (from the instance)
     // G: 1.0 (indicates "has object")
     // B: Depth (builtin fragment depth)
     // A: 1.0 (opaque)
-    return vec4f(uMyUniforms.color.r, 1.0, in.position.z, 1.0);
+    return vec4f(in.objectId, 1.0, in.position.z, 1.0);
 }
@@ -38,11 +38,8 @@ void SampleGame::onUpdate(float deltaTime) {
 void SampleGame::onShutdown() {
     std::cout << "\nShutting down sample..." << std::endl;
     
-    if (currentScene) {
-        currentScene->onUnload();
-        delete currentScene;
-        currentScene = nullptr;
-    }
+    // Unloads the scene and its collision system
+    loadScene(nullptr);
     
     std::cout << "Sample shutdown complete." << std::endl;
 }
@@ -13,7 +13,7 @@ void CubeWorldScene::onLoad() {
     
     // Visual mesh
     froggi::MeshComponent* cubeMesh = addComponent<froggi::MeshComponent>(cube);
-    cubeMesh->meshName = "cube";
+    cubeMesh->setMesh("cube");
     cubeMesh->color = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
     
     // Cube controller